@@ -183,6 +183,8 @@ class LogrConan(ConanFile):
 
         self.cpp_info.components["logr_base"].includedirs = ["include"]
         self.cpp_info.components["logr_base"].requires = ["fmt::fmt"]
+        if self.settings.os in ["Linux", "FreeBSD"]:
+            self.cpp_info.components["logr_base"].system_libs = ["pthread"]
 
         if self.options.spdlog_backend:
             self.cpp_info.components["logr_spdlog"].includedirs = []
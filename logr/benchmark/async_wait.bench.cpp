@@ -0,0 +1,155 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include <logr/async_backend.hpp>
+
+namespace /* anonymous */
+{
+
+//
+// counting_logger_t
+//
+
+/**
+ * @brief A backend that counts received messages.
+ */
+class counting_logger_t
+    : public logr::basic_logger_t< logr::basic_logger_traits_t< 256 > >
+{
+public:
+    using base_type_t =
+        logr::basic_logger_t< logr::basic_logger_traits_t< 256 > >;
+
+    explicit counting_logger_t(
+        logr::log_message_level level = logr::log_message_level::trace )
+        : base_type_t{ level }
+    {
+    }
+
+    std::uint64_t received() const noexcept
+    {
+        return m_received.load( std::memory_order_acquire );
+    }
+
+private:
+    void count() noexcept { m_received.fetch_add( 1, std::memory_order_release ); }
+
+    void log_message_trace( string_view_t ) override { count(); }
+    void log_message_trace( logr::src_location_t, string_view_t ) override
+    {
+        count();
+    }
+    void log_message_debug( string_view_t ) override { count(); }
+    void log_message_debug( logr::src_location_t, string_view_t ) override
+    {
+        count();
+    }
+    void log_message_info( string_view_t ) override { count(); }
+    void log_message_info( logr::src_location_t, string_view_t ) override
+    {
+        count();
+    }
+    void log_message_warn( string_view_t ) override { count(); }
+    void log_message_warn( logr::src_location_t, string_view_t ) override
+    {
+        count();
+    }
+    void log_message_error( string_view_t ) override { count(); }
+    void log_message_error( logr::src_location_t, string_view_t ) override
+    {
+        count();
+    }
+    void log_message_critical( string_view_t ) override { count(); }
+    void log_message_critical( logr::src_location_t, string_view_t ) override
+    {
+        count();
+    }
+    void log_flush() override {}
+
+    std::atomic< std::uint64_t > m_received{ 0 };
+};
+
+template < typename Wait_Strategy >
+struct wait_traits_t : public logr::async_logger_traits_t
+{
+    using wait_strategy_t = Wait_Strategy;
+};
+
+template < typename Wait_Strategy >
+using async_logger_t =
+    logr::async_logger_t< counting_logger_t, wait_traits_t< Wait_Strategy > >;
+
+//
+// bench_wakeup_latency()
+//
+
+/**
+ * @brief Measure the time from logging a message to an idle consumer
+ *        until the backend receives it.
+ *
+ * Reports process CPU time per wall time ("cpu_load")
+ * to show what an idle consumer burns.
+ */
+template < typename Wait_Strategy >
+void bench_wakeup_latency( benchmark::State & state )
+{
+    async_logger_t< Wait_Strategy > logger{ logr::log_message_level::trace,
+                                            1024 };
+
+    const auto idle_time = std::chrono::microseconds{ state.range( 0 ) };
+
+    const auto wall_started = std::chrono::steady_clock::now();
+    const auto cpu_started  = std::clock();
+
+    std::uint64_t expected = 0;
+    for( auto _ : state )
+    {
+        // Let the consumer become idle.
+        std::this_thread::sleep_for( idle_time );
+
+        const auto started = std::chrono::steady_clock::now();
+        logger.info( "wake up" );
+        ++expected;
+        while( logger.backend().received() != expected )
+        {
+            std::this_thread::yield();
+        }
+        const auto finished = std::chrono::steady_clock::now();
+
+        state.SetIterationTime(
+            std::chrono::duration< double >( finished - started ).count() );
+    }
+
+    const std::chrono::duration< double > wall_time =
+        std::chrono::steady_clock::now() - wall_started;
+    const double cpu_time =
+        static_cast< double >( std::clock() - cpu_started ) / CLOCKS_PER_SEC;
+
+    state.counters[ "cpu_load" ] = cpu_time / wall_time.count();
+}
+
+}  // anonymous namespace
+
+BENCHMARK_TEMPLATE( bench_wakeup_latency, logr::busy_spin_wait_strategy_t )
+    ->UseManualTime()
+    ->Arg( 100 )
+    ->Arg( 1000 );
+BENCHMARK_TEMPLATE( bench_wakeup_latency, logr::yielding_wait_strategy_t<> )
+    ->UseManualTime()
+    ->Arg( 100 )
+    ->Arg( 1000 );
+BENCHMARK_TEMPLATE( bench_wakeup_latency, logr::blocking_wait_strategy_t<> )
+    ->UseManualTime()
+    ->Arg( 100 )
+    ->Arg( 1000 );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,204 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+#include <cstdio>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <logr/file_backend.hpp>
+#include <logr/sharded_file_backend.hpp>
+
+#if defined( LOGR_WITH_SPDLOG_BACKEND )
+#    include <spdlog/logger.h>
+#    include <spdlog/sinks/basic_file_sink.h>
+#endif
+
+namespace /* anonymous */
+{
+
+std::string bench_file( const char * name )
+{
+    auto path = std::string{ "/tmp/" } + name;
+    std::remove( path.c_str() );
+    std::remove( ( path + ".idx" ).c_str() );
+    return path;
+}
+
+//
+// bench_logr_file()
+//
+
+/**
+ * @brief Log a message to a file with logr file backend.
+ *
+ * A logger is shared by benchmark threads.
+ */
+void bench_logr_file( benchmark::State & state )
+{
+    static logr::file_logger_t<> logger{ bench_file( "logr_bench_file.log" ),
+                                         logr::log_message_level::trace };
+
+    int x = 0;
+    for( auto _ : state )
+    {
+        logger.info( LOGR_SRC_LOCATION, [ & ]( auto out ) {
+            format_to( out, "Message #{} with some text: {}", x++, 3.14 );
+        } );
+    }
+
+    logger.flush();
+}
+
+//
+// bench_logr_file_indexed()
+//
+
+/**
+ * @brief Log a message to a file with logr file backend keeping an index.
+ *
+ * Should cost the same as `bench_logr_file`.
+ */
+void bench_logr_file_indexed( benchmark::State & state )
+{
+    using logger_t = logr::file_logger_t<>;
+    static logger_t logger{ bench_file( "logr_bench_indexed.log" ),
+                            logr::log_message_level::trace,
+                            logger_t::default_batch_size,
+                            logger_t::default_max_delay,
+                            logr::log_message_level::nolog,
+                            64 * 1024 };
+
+    int x = 0;
+    for( auto _ : state )
+    {
+        logger.info( LOGR_SRC_LOCATION, [ & ]( auto out ) {
+            format_to( out, "Message #{} with some text: {}", x++, 3.14 );
+        } );
+    }
+
+    logger.flush();
+}
+
+//
+// bench_logr_sharded_file()
+//
+
+/**
+ * @brief Log a message with logr sharded file backend (a file per thread).
+ *
+ * Threads share nothing, so it should scale with threads.
+ */
+void bench_logr_sharded_file( benchmark::State & state )
+{
+    static logr::sharded_file_logger_t<> logger{ "/tmp/logr_bench_sharded",
+                                                 logr::log_message_level::trace };
+
+    int x = 0;
+    for( auto _ : state )
+    {
+        logger.info( LOGR_SRC_LOCATION, [ & ]( auto out ) {
+            format_to( out, "Message #{} with some text: {}", x++, 3.14 );
+        } );
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+}
+
+//
+// bench_logr_file_durable()
+//
+
+/**
+ * @brief Log a durable message to a file with logr file backend.
+ *
+ * Each message waits for a group commit, so items per second
+ * are durable messages per second. Shows how a sync is shared
+ * by concurrent writers (messages per sync).
+ */
+void bench_logr_file_durable( benchmark::State & state )
+{
+    static logr::file_logger_t<> logger{ bench_file( "logr_bench_durable.log" ),
+                                         logr::log_message_level::trace,
+                                         logr::file_logger_t<>::default_batch_size,
+                                         logr::file_logger_t<>::default_max_delay,
+                                         logr::log_message_level::error };
+
+    const auto & commit = logger.group_commit();
+    const auto commits  = commit.commits_count();
+    const auto syncs    = commit.syncs_count();
+
+    int x = 0;
+    for( auto _ : state )
+    {
+        logger.error( LOGR_SRC_LOCATION, [ & ]( auto out ) {
+            format_to( out, "Message #{} with some text: {}", x++, 3.14 );
+        } );
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+    if( 0 == state.thread_index() )
+    {
+        // Approximate: other threads might still be running.
+        const auto syncs_done = commit.syncs_count() - syncs;
+        state.counters[ "msgs_per_sync" ] =
+            0 == syncs_done ? 0.0
+                            : static_cast< double >( commit.commits_count()
+                                                     - commits )
+                                  / static_cast< double >( syncs_done );
+    }
+}
+
+#if defined( LOGR_WITH_SPDLOG_BACKEND )
+
+//
+// bench_spdlog_basic_file_sink()
+//
+
+/**
+ * @brief Log a message to a file with spdlog basic file sink.
+ *
+ * The same format as logr file backend has: level and location.
+ */
+void bench_spdlog_basic_file_sink( benchmark::State & state )
+{
+    static spdlog::logger logger = [] {
+        spdlog::logger l{ "bench",
+                          std::make_shared< spdlog::sinks::basic_file_sink_mt >(
+                              bench_file( "logr_bench_spdlog.log" ) ) };
+        l.set_pattern( "%l: %v @ %s(%#)" );
+        l.set_level( spdlog::level::trace );
+        return l;
+    }();
+
+    int x = 0;
+    for( auto _ : state )
+    {
+        logger.log( spdlog::source_loc{ __FILE__, __LINE__, "" },
+                    spdlog::level::info,
+                    "Message #{} with some text: {}",
+                    x++,
+                    3.14 );
+    }
+
+    logger.flush();
+}
+
+#endif  // defined( LOGR_WITH_SPDLOG_BACKEND )
+
+}  // anonymous namespace
+
+BENCHMARK( bench_logr_file )->Threads( 1 )->Threads( 4 );
+BENCHMARK( bench_logr_file_indexed )->Threads( 1 )->Threads( 4 );
+BENCHMARK( bench_logr_sharded_file )->ThreadRange( 1, 8 )->UseRealTime();
+BENCHMARK( bench_logr_file_durable )
+    ->ThreadRange( 1, 16 )
+    ->UseRealTime();
+
+#if defined( LOGR_WITH_SPDLOG_BACKEND )
+BENCHMARK( bench_spdlog_basic_file_sink )->Threads( 1 )->Threads( 4 );
+#endif
+
+BENCHMARK_MAIN();
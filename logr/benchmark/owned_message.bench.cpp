@@ -0,0 +1,91 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include <logr/noop_backend.hpp>
+
+namespace /* anonymous */
+{
+
+// A backend overriding string view routines only,
+// so owned messages would cost it an extra virtual call.
+using logger_t = logr::basic_noop_logger_t< 1024 >;
+
+using base_logger_t = logr::basic_logger_t< logr::basic_logger_traits_t< 1024 > >;
+
+/**
+ * @brief Hide the type of a logger, so that calls are not devirtualized.
+ */
+base_logger_t * opaque( logger_t & logger )
+{
+    base_logger_t * res = &logger;
+    benchmark::DoNotOptimize( res );
+    return res;
+}
+
+//
+// bench_string_view()
+//
+
+/**
+ * @brief A baseline: a single virtual call per message.
+ */
+void bench_string_view( benchmark::State & state )
+{
+    logger_t concrete{ logr::log_message_level::trace };
+    auto * logger = opaque( concrete );
+    const std::string text( static_cast< std::size_t >( state.range( 0 ) ), 'x' );
+
+    for( auto _ : state )
+    {
+        logger->info( std::string_view{ text } );
+    }
+}
+
+//
+// bench_write_to()
+//
+
+void bench_write_to( benchmark::State & state )
+{
+    logger_t concrete{ logr::log_message_level::trace };
+    auto * logger = opaque( concrete );
+    const std::string text( static_cast< std::size_t >( state.range( 0 ) ), 'x' );
+
+    for( auto _ : state )
+    {
+        logger->info( [ & ]( auto out ) { format_to( out, "{}", text ); } );
+    }
+}
+
+//
+// bench_by_return()
+//
+
+void bench_by_return( benchmark::State & state )
+{
+    logger_t concrete{ logr::log_message_level::trace };
+    auto * logger = opaque( concrete );
+    const std::string text( static_cast< std::size_t >( state.range( 0 ) ), 'x' );
+
+    for( auto _ : state )
+    {
+        logger->info( [ & ] { return text; } );
+    }
+}
+
+}  // anonymous namespace
+
+// Short messages fit the inline buffer (or a short string),
+// long ones are on the heap.
+BENCHMARK( bench_string_view )->Arg( 12 )->Arg( 4096 );
+BENCHMARK( bench_write_to )->Arg( 12 )->Arg( 4096 );
+BENCHMARK( bench_by_return )->Arg( 12 )->Arg( 4096 );
+
+BENCHMARK_MAIN();
@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+# Logger frontend library for C++.
+#
+# Copyright (c) 2020 - present,  Nicolai Grodzitski
+# See LICENSE file in the root of the project.
+
+"""Generate a header of typed logging functions from a message catalog.
+
+A catalog is a JSON file:
+
+    {
+        "namespace": "app::log",
+        "includes": [ "<cstdint>", "\\"order.hpp\\"" ],
+        "messages": [
+            {
+                "name": "order_filled",
+                "id": 1001,
+                "level": "info",
+                "format": "Order {} filled at {:.2f}",
+                "params": [
+                    { "name": "order_id", "type": "std::uint64_t" },
+                    { "name": "price", "type": "double" }
+                ]
+            }
+        ]
+    }
+
+For each message the header defines a descriptor `<name>_msg_t`
+and `log_<name>( logger, [src_location,] params... )` functions.
+If all the params can be captured the message reaches the backend
+as a deferred message carrying its id (see logr::catalog_message_t).
+"id" is optional: by default it is a hash of the name,
+so it is stable as long as the name is.
+
+Usage: logr_catalog_gen.py CATALOG OUTPUT
+"""
+
+import json
+import re
+import sys
+
+LEVELS = ("trace", "debug", "info", "warn", "error", "critical")
+IDENTIFIER = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+NAMESPACE = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*(::[A-Za-z_][A-Za-z0-9_]*)*$")
+
+
+class CatalogError(Exception):
+    pass
+
+
+def fnv1a_32(text):
+    h = 0x811C9DC5
+    for b in text.encode("utf-8"):
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def cpp_string(text):
+    res = []
+    for c in text.encode("utf-8"):
+        if c == ord("\\"):
+            res.append("\\\\")
+        elif c == ord('"'):
+            res.append('\\"')
+        elif c == ord("\n"):
+            res.append("\\n")
+        elif c == ord("\t"):
+            res.append("\\t")
+        elif c < 0x20 or c >= 0x7F:
+            # Octal escapes take at most 3 digits, unlike hex ones.
+            res.append("\\%03o" % c)
+        else:
+            res.append(chr(c))
+    return '"' + "".join(res) + '"'
+
+
+def check_identifier(value, what):
+    if not isinstance(value, str) or not IDENTIFIER.match(value):
+        raise CatalogError("bad %s: %r" % (what, value))
+
+
+def load_messages(catalog):
+    messages = catalog.get("messages")
+    if not isinstance(messages, list) or not messages:
+        raise CatalogError("catalog has no messages")
+
+    names = set()
+    ids = {}
+    for msg in messages:
+        check_identifier(msg.get("name"), "message name")
+        name = msg["name"]
+        if name in names:
+            raise CatalogError("duplicate message name: %s" % name)
+        names.add(name)
+
+        if msg.get("level") not in LEVELS:
+            raise CatalogError("bad level of %s: %r" % (name, msg.get("level")))
+
+        if not isinstance(msg.get("format"), str):
+            raise CatalogError("no format of %s" % name)
+
+        msg_id = msg.get("id", fnv1a_32(name))
+        if not isinstance(msg_id, int) or not 0 <= msg_id <= 0xFFFFFFFF:
+            raise CatalogError("bad id of %s: %r" % (name, msg_id))
+        if msg_id in ids:
+            raise CatalogError(
+                "id %d of %s is already used by %s" % (msg_id, name, ids[msg_id])
+            )
+        ids[msg_id] = name
+        msg["id"] = msg_id
+
+        params = msg.setdefault("params", [])
+        param_names = set()
+        for p in params:
+            check_identifier(p.get("name"), "parameter name of %s" % name)
+            if p["name"] in param_names or p["name"] in ("logger", "src_location"):
+                raise CatalogError("bad parameter name of %s: %s" % (name, p["name"]))
+            param_names.add(p["name"])
+            if not isinstance(p.get("type"), str) or not p["type"].strip():
+                raise CatalogError("bad type of %s.%s" % (name, p["name"]))
+
+    return messages
+
+
+def generate(catalog, catalog_name):
+    namespace = catalog.get("namespace", "")
+    if namespace and not NAMESPACE.match(namespace):
+        raise CatalogError("bad namespace: %r" % namespace)
+
+    messages = load_messages(catalog)
+
+    out = []
+    w = out.append
+
+    w("// Generated by logr_catalog_gen.py from %s, do not edit." % catalog_name)
+    w("")
+    w("#pragma once")
+    w("")
+    w("#include <array>")
+    w("#include <cstdint>")
+    w("#include <string_view>")
+    w("")
+    w("#include <fmt/compile.h>")
+    w("")
+    w("#include <logr/logr.hpp>")
+    w("#include <logr/message_catalog.hpp>")
+    includes = catalog.get("includes", [])
+    if includes:
+        w("")
+        for inc in includes:
+            w("#include %s" % inc)
+    w("")
+    if namespace:
+        w("namespace %s" % namespace)
+        w("{")
+        w("")
+
+    for msg in messages:
+        name = msg["name"]
+        level = "::logr::log_message_level::%s" % msg["level"]
+        params = msg["params"]
+
+        w("//")
+        w("// %s" % name)
+        w("//")
+        w("")
+        w("struct %s_msg_t" % name)
+        w("{")
+        w("    static constexpr std::uint32_t id = %dU;" % msg["id"])
+        w("    static constexpr std::string_view name{ %s };" % cpp_string(name))
+        w("    static constexpr ::logr::log_message_level level = %s;" % level)
+        w("    static constexpr std::string_view format{ %s };" % cpp_string(msg["format"]))
+        w(
+            "    static constexpr std::array< ::logr::catalog_param_t, %d > params{ {"
+            % len(params)
+        )
+        for p in params:
+            w("        { %s, %s }," % (cpp_string(p["name"]), cpp_string(p["type"])))
+        w("    } };")
+        w("")
+        w("    template < typename... Args >")
+        w(
+            "    static void format_to( ::fmt::detail::buffer< char > & out, "
+            "const Args &... args )"
+        )
+        w("    {")
+        w(
+            "        ::fmt::format_to( ::fmt::appender( out ), FMT_COMPILE( %s ), args... );"
+            % cpp_string(msg["format"])
+        )
+        w("    }")
+        w("};")
+        w("")
+
+        args = "".join(", const %s & %s" % (p["type"], p["name"]) for p in params)
+        values = ", ".join(p["name"] for p in params)
+
+        for src_location in (False, True):
+            w("template < typename Logger >")
+            if src_location:
+                w(
+                    "void log_%s( Logger & logger, ::logr::src_location_t src_location%s )"
+                    % (name, args)
+                )
+            else:
+                w("void log_%s( Logger & logger%s )" % (name, args))
+            w("{")
+            # Carries the id to the backend when params can be captured.
+            w(
+                "    logger.template message< %s_msg_t::level >( %s"
+                "::logr::make_catalog_message< %s_msg_t >( %s ) );"
+                % (name, "src_location, " if src_location else "", name, values)
+            )
+            w("}")
+            w("")
+
+    w("//! All messages of the catalog.")
+    w("inline constexpr ::logr::catalog_entry_t catalog_entries[] = {")
+    for msg in messages:
+        t = "%s_msg_t" % msg["name"]
+        w(
+            "    { %s::id, %s::name, %s::level, %s::format, %s::params.data(), %s::params.size() },"
+            % (t, t, t, t, t, t)
+        )
+    w("};")
+    w("")
+
+    if namespace:
+        w("} /* namespace %s */" % namespace)
+
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write("Usage: %s CATALOG OUTPUT\n" % argv[0])
+        return 2
+
+    try:
+        with open(argv[1], encoding="utf-8") as f:
+            catalog = json.load(f)
+        text = generate(catalog, argv[1].replace("\\", "/").split("/")[-1])
+    except (OSError, ValueError, CatalogError) as ex:
+        sys.stderr.write("%s: %s\n" % (argv[1], ex))
+        return 1
+
+    # Keep the file untouched if nothing changed to avoid rebuilds.
+    try:
+        with open(argv[2], encoding="utf-8") as f:
+            if f.read() == text:
+                return 0
+    except OSError:
+        pass
+
+    with open(argv[2], "w", encoding="utf-8") as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,53 @@
+# Generate a header of typed logging functions from a message catalog.
+#
+# logr_add_message_catalog(<target>
+#                          CATALOG <catalog.json>
+#                          HEADER <header-name.hpp>)
+#
+# The header is generated into the current binary dir
+# (which is added to include directories of the target)
+# and is regenerated when the catalog changes.
+# See logr_catalog_gen.py for the catalog format.
+#
+# Requires Python 3, LOGR_CATALOG_PYTHON tells if it is found.
+
+find_package(Python3 COMPONENTS Interpreter)
+
+set(LOGR_CATALOG_GEN_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/logr_catalog_gen.py"
+    CACHE INTERNAL "logr message catalog generator")
+
+# Imported targets are visible only in the current directory,
+# so the interpreter path is cached for other directories.
+if (Python3_Interpreter_FOUND)
+    set(LOGR_CATALOG_PYTHON "${Python3_EXECUTABLE}"
+        CACHE INTERNAL "Python 3 interpreter for logr message catalogs")
+else ()
+    set(LOGR_CATALOG_PYTHON "" CACHE INTERNAL
+        "Python 3 interpreter for logr message catalogs")
+endif ()
+
+function(logr_add_message_catalog target)
+    cmake_parse_arguments(ARG "" "CATALOG;HEADER" "" ${ARGN})
+
+    if (NOT ARG_CATALOG OR NOT ARG_HEADER)
+        message(FATAL_ERROR "logr_add_message_catalog: CATALOG and HEADER are required")
+    endif ()
+
+    if (NOT LOGR_CATALOG_PYTHON)
+        message(FATAL_ERROR "logr_add_message_catalog: Python 3 is required")
+    endif ()
+
+    get_filename_component(catalog "${ARG_CATALOG}" ABSOLUTE)
+    set(header "${CMAKE_CURRENT_BINARY_DIR}/${ARG_HEADER}")
+
+    add_custom_command(
+        OUTPUT "${header}"
+        COMMAND "${LOGR_CATALOG_PYTHON}" "${LOGR_CATALOG_GEN_SCRIPT}" "${catalog}" "${header}"
+        DEPENDS "${catalog}" "${LOGR_CATALOG_GEN_SCRIPT}"
+        COMMENT "Generating logr message catalog ${ARG_HEADER}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${header}")
+    target_include_directories(${target} PRIVATE "${CMAKE_CURRENT_BINARY_DIR}")
+endfunction()
@@ -0,0 +1,2566 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined( __linux__ )
+#    include <pthread.h>
+#    include <sched.h>
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#endif
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ )
+#    include <immintrin.h>
+#endif
+
+#include <fmt/format.h>
+
+#include <logr/logr.hpp>
+#include <logr/crash_drain.hpp>
+
+namespace logr
+{
+
+namespace details
+{
+
+//! Cache line size assumed for separating hot atomics.
+inline constexpr std::size_t cache_line_size = 64;
+
+/**
+ * @brief Get the smallest power of 2 not less than n (and not less than 2).
+ */
+inline std::size_t round_up_to_pow2( std::size_t n ) noexcept
+{
+    std::size_t res = 2;
+    while( res < n )
+    {
+        res <<= 1;
+    }
+    return res;
+}
+
+/**
+ * @brief Hint the CPU that the thread is spinning.
+ */
+inline void cpu_relax() noexcept
+{
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ )
+    _mm_pause();
+#elif defined( __aarch64__ )
+    asm volatile( "yield" ::: "memory" );
+#endif
+}
+
+//
+// async_message_record_t
+//
+
+/**
+ * @brief A single message carried from producers to the consumer thread.
+ *
+ * A record carries either a ready message text or a captured
+ * deferred message which is passed to the backend by the consumer.
+ *
+ * @tparam Message_Container  A container to store message text
+ *                            (the same container logger uses for building
+ *                            messages).
+ * @tparam Deferred_View      A type of deferred message view.
+ * @tparam Deferred_Capacity  Max size of captured deferred message.
+ */
+template < typename Message_Container,
+           typename Deferred_View,
+           std::size_t Deferred_Capacity >
+struct async_message_record_t
+{
+    static_assert( Deferred_Capacity > 0, "Deferred capacity must be positive" );
+
+    //! Max size of captured deferred message.
+    static constexpr std::size_t deferred_capacity = Deferred_Capacity;
+
+    //! Check if a deferred message can be stored in a record.
+    static bool can_store( const Deferred_View & message ) noexcept
+    {
+        return message.size() <= deferred_capacity
+               && message.alignment() <= alignof( std::max_align_t );
+    }
+
+    //! Message level, nolog marks a record that must be skipped.
+    log_message_level level{ log_message_level::nolog };
+
+    //! Is the source location set for the record.
+    bool has_src_location{ false };
+
+    //! Source location of the message (if any).
+    src_location_t src_location{};
+
+    //! Message text.
+    Message_Container message;
+
+    //! Is the message a literal (see `static_text`).
+    bool is_static{ false };
+
+    //! A literal message text (not copied).
+    typename Message_Container::string_view_t static_text{};
+
+    //! A function to render deferred message, null if the record is a text.
+    typename Deferred_View::format_fn_t deferred_format_fn{ nullptr };
+
+    //! A function to visit deferred message.
+    typename Deferred_View::visit_fn_t deferred_visit_fn{ nullptr };
+
+    //! The size of captured deferred message.
+    std::size_t deferred_size{ 0 };
+
+    //! A copy of captured deferred message.
+    alignas( std::max_align_t ) unsigned char deferred_message[ Deferred_Capacity ];
+};
+
+//
+// mpsc_bounded_queue_t
+//
+
+/**
+ * @brief A bounded lock-free queue of preallocated records.
+ *
+ * An implementation of Dmitry Vyukov's bounded queue.
+ * Records are never copied by the queue itself: a producer
+ * fills a record in place and a consumer handles it in place,
+ * so once the queue is created it doesn't allocate.
+ *
+ * The algorithm is MPMC, but it is used with a single consumer.
+ *
+ * @tparam Record  A type of a record stored in a slot.
+ */
+template < typename Record >
+class mpsc_bounded_queue_t
+{
+public:
+    /**
+     * @brief Create a queue.
+     *
+     * @param capacity  Min number of records the queue must hold
+     *                  (rounded up to the power of 2).
+     */
+    explicit mpsc_bounded_queue_t( std::size_t capacity )
+        : m_mask{ round_up_to_pow2( capacity ) - 1 }
+        , m_slots{ std::make_unique< slot_t[] >( m_mask + 1 ) }
+    {
+        for( std::size_t i = 0; i <= m_mask; ++i )
+        {
+            m_slots[ i ].sequence.store( i, std::memory_order_relaxed );
+        }
+    }
+
+    mpsc_bounded_queue_t( const mpsc_bounded_queue_t & ) = delete;
+    mpsc_bounded_queue_t & operator=( const mpsc_bounded_queue_t & ) = delete;
+
+    //! Producer can free a slot by popping the oldest record itself.
+    static constexpr bool producer_can_evict = true;
+
+    /**
+     * @brief Get the number of records the queue can hold.
+     */
+    std::size_t capacity() const noexcept { return m_mask + 1; }
+
+    /**
+     * @brief Try to put a record in the queue.
+     *
+     * @param fill  A callback to fill a record: `void(Record&) noexcept`.
+     *
+     * @return True if the record was stored and false if queue is full.
+     */
+    template < typename Fill >
+    bool try_push( Fill && fill ) noexcept
+    {
+        static_assert( std::is_nothrow_invocable_v< Fill, Record & >,
+                       "Fill callback must be noexcept" );
+
+        auto pos = m_enqueue_pos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            slot_t & slot  = m_slots[ pos & m_mask ];
+            const auto seq = slot.sequence.load( std::memory_order_acquire );
+            const auto diff =
+                static_cast< std::intptr_t >( seq ) -
+                static_cast< std::intptr_t >( pos );
+
+            if( 0 == diff )
+            {
+                if( m_enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed ) )
+                {
+                    fill( slot.record );
+                    slot.sequence.store( pos + 1, std::memory_order_release );
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+            {
+                // The slot wasn't released by consumer yet: queue is full.
+                return false;
+            }
+            else
+            {
+                pos = m_enqueue_pos.load( std::memory_order_relaxed );
+            }
+        }
+    }
+
+    /**
+     * @brief Try to take the oldest record from the queue.
+     *
+     * @param consume  A callback to handle a record: `void(Record&) noexcept`.
+     *
+     * @return True if a record was handled and false if queue is empty.
+     */
+    template < typename Consume >
+    bool try_pop( Consume && consume ) noexcept
+    {
+        static_assert( std::is_nothrow_invocable_v< Consume, Record & >,
+                       "Consume callback must be noexcept" );
+
+        auto pos = m_dequeue_pos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            slot_t & slot  = m_slots[ pos & m_mask ];
+            const auto seq = slot.sequence.load( std::memory_order_acquire );
+            const auto diff =
+                static_cast< std::intptr_t >( seq ) -
+                static_cast< std::intptr_t >( pos + 1 );
+
+            if( 0 == diff )
+            {
+                if( m_dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed ) )
+                {
+                    consume( slot.record );
+                    slot.sequence.store( pos + m_mask + 1,
+                                         std::memory_order_release );
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeue_pos.load( std::memory_order_relaxed );
+            }
+        }
+    }
+
+    /**
+     * @brief Consume up to a given number of records.
+     *
+     * @param max_records  Max number of records to consume.
+     * @param consume      A callback to handle a record:
+     *                     `void(Record&) noexcept`.
+     *
+     * @return The number of consumed records.
+     */
+    template < typename Consume >
+    std::size_t drain( std::size_t max_records, Consume && consume ) noexcept
+    {
+        std::size_t n = 0;
+        while( n < max_records && try_pop( consume ) )
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Check if there is a record ready to be consumed.
+     */
+    bool has_ready_record() const noexcept
+    {
+        const auto pos = m_dequeue_pos.load( std::memory_order_relaxed );
+        const auto seq =
+            m_slots[ pos & m_mask ].sequence.load( std::memory_order_acquire );
+        return seq == pos + 1;
+    }
+
+    //! A position of a record in the queue.
+    using position_t = std::size_t;
+
+    /**
+     * @brief Get the position after the last record claimed by producers.
+     *
+     * A record before it might be claimed but not published yet.
+     */
+    position_t enqueue_position() noexcept
+    {
+        return m_enqueue_pos.load( std::memory_order_acquire );
+    }
+
+    /**
+     * @brief Check if all the records before a given position are consumed.
+     */
+    bool consumed( position_t pos ) const noexcept
+    {
+        return 0 <= static_cast< std::intptr_t >(
+                   m_dequeue_pos.load( std::memory_order_acquire ) - pos );
+    }
+
+    void fork_prepare() noexcept {}
+
+    void fork_parent() noexcept {}
+
+    /**
+     * @brief Forget all records in the child process.
+     *
+     * Records queued by other threads of the parent belong to the parent,
+     * and a slot claimed by them would never be released.
+     */
+    void fork_child() noexcept
+    {
+        for( std::size_t i = 0; i <= m_mask; ++i )
+        {
+            m_slots[ i ].sequence.store( i, std::memory_order_relaxed );
+        }
+        m_enqueue_pos.store( 0, std::memory_order_relaxed );
+        m_dequeue_pos.store( 0, std::memory_order_relaxed );
+    }
+
+private:
+    struct alignas( cache_line_size ) slot_t
+    {
+        std::atomic< std::size_t > sequence;
+        Record record;
+    };
+
+    const std::size_t m_mask;
+    const std::unique_ptr< slot_t[] > m_slots;
+
+    alignas( cache_line_size ) std::atomic< std::size_t > m_enqueue_pos{ 0 };
+    alignas( cache_line_size ) std::atomic< std::size_t > m_dequeue_pos{ 0 };
+};
+
+//
+// spsc_ring_t
+//
+
+/**
+ * @brief A wait-free single producer single consumer ring of records.
+ *
+ * Each record is stamped with a capture timestamp
+ * so that several rings can be merged into a single timeline.
+ *
+ * @tparam Record  A type of a record stored in a slot.
+ */
+template < typename Record >
+class spsc_ring_t
+{
+public:
+    explicit spsc_ring_t( std::size_t capacity )
+        : m_mask{ round_up_to_pow2( capacity ) - 1 }
+        , m_slots{ std::make_unique< slot_t[] >( m_mask + 1 ) }
+    {
+    }
+
+    spsc_ring_t( const spsc_ring_t & ) = delete;
+    spsc_ring_t & operator=( const spsc_ring_t & ) = delete;
+
+    /**
+     * @brief Try to put a record in the ring (producer side).
+     */
+    template < typename Fill >
+    bool try_push( std::int64_t timestamp, Fill && fill ) noexcept
+    {
+        const auto tail = m_tail.load( std::memory_order_relaxed );
+        if( tail - m_cached_head > m_mask )
+        {
+            m_cached_head = m_head.load( std::memory_order_acquire );
+            if( tail - m_cached_head > m_mask )
+            {
+                return false;
+            }
+        }
+
+        slot_t & slot   = m_slots[ tail & m_mask ];
+        slot.timestamp  = timestamp;
+        fill( slot.record );
+        m_tail.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     * @brief Get the timestamp of the oldest record (consumer side).
+     *
+     * @return Pointer to the timestamp, or null if the ring is empty.
+     */
+    const std::int64_t * front_timestamp() noexcept
+    {
+        const auto head = m_head.load( std::memory_order_relaxed );
+        if( head == m_cached_tail )
+        {
+            m_cached_tail = m_tail.load( std::memory_order_acquire );
+            if( head == m_cached_tail )
+            {
+                return nullptr;
+            }
+        }
+        return &m_slots[ head & m_mask ].timestamp;
+    }
+
+    /**
+     * @brief Consume the oldest record (consumer side).
+     *
+     * @pre front_timestamp() returned non null.
+     */
+    template < typename Consume >
+    void pop_front( Consume && consume ) noexcept
+    {
+        const auto head = m_head.load( std::memory_order_relaxed );
+        consume( m_slots[ head & m_mask ].record );
+        m_head.store( head + 1, std::memory_order_release );
+    }
+
+    /**
+     * @brief Visit records from the oldest to the newest without
+     *        consuming them (async-signal-safe).
+     *
+     * Meant for a dying process: the consumer might still be popping
+     * records, so a record being consumed can be seen half-moved.
+     */
+    template < typename Visit >
+    void crash_visit( Visit && visit ) noexcept
+    {
+        auto head       = m_head.load( std::memory_order_acquire );
+        const auto tail = m_tail.load( std::memory_order_acquire );
+        for( ; head != tail; ++head )
+        {
+            visit( m_slots[ head & m_mask ].record );
+        }
+    }
+
+    /**
+     * @brief Check if the ring has records (can be used by any thread).
+     */
+    bool empty() const noexcept
+    {
+        return m_head.load( std::memory_order_acquire )
+               == m_tail.load( std::memory_order_acquire );
+    }
+
+    //! Position after the last pushed record (can be used by any thread).
+    std::size_t tail() const noexcept
+    {
+        return m_tail.load( std::memory_order_acquire );
+    }
+
+    /**
+     * @brief Check if all the records before a given position are consumed
+     *        (can be used by any thread).
+     */
+    bool consumed( std::size_t pos ) const noexcept
+    {
+        return pos <= m_head.load( std::memory_order_acquire );
+    }
+
+    //! Is there still a thread that might produce to this ring.
+    std::atomic< bool > producer_alive{ true };
+
+    //! Is there still a queue that consumes from this ring.
+    std::atomic< bool > consumer_alive{ true };
+
+private:
+    struct slot_t
+    {
+        std::int64_t timestamp{};
+        Record record;
+    };
+
+    const std::size_t m_mask;
+    const std::unique_ptr< slot_t[] > m_slots;
+
+    alignas( cache_line_size ) std::atomic< std::size_t > m_head{ 0 };
+    std::size_t m_cached_tail{ 0 };
+
+    alignas( cache_line_size ) std::atomic< std::size_t > m_tail{ 0 };
+    std::size_t m_cached_head{ 0 };
+};
+
+//
+// per_thread_spsc_queue_t
+//
+
+/**
+ * @brief A queue made of per-thread SPSC rings.
+ *
+ * Each producer thread lazily registers its own ring
+ * when it first pushes a record, so producers never share
+ * a cache line. The consumer drains all the rings with
+ * a k-way merge on the capture timestamp, so the output
+ * stays globally ordered.
+ *
+ * Merging is done for records captured before the drain began,
+ * a record captured earlier but published by its producer later
+ * than the drain started might come slightly out of order.
+ *
+ * @tparam Record  A type of a record stored in a slot.
+ */
+template < typename Record >
+class per_thread_spsc_queue_t
+{
+public:
+    using ring_t = spsc_ring_t< Record >;
+
+    /**
+     * @brief Create a queue.
+     *
+     * @param capacity  Min number of records each thread's ring must hold.
+     */
+    explicit per_thread_spsc_queue_t( std::size_t capacity )
+        : m_ring_capacity{ capacity }
+    {
+    }
+
+    ~per_thread_spsc_queue_t()
+    {
+        std::lock_guard lock{ m_rings_mutex };
+        for( auto & r : m_rings )
+        {
+            r->consumer_alive.store( false, std::memory_order_release );
+        }
+    }
+
+    per_thread_spsc_queue_t( const per_thread_spsc_queue_t & ) = delete;
+    per_thread_spsc_queue_t & operator=( const per_thread_spsc_queue_t & ) =
+        delete;
+
+    //! Only the consumer can pop from a ring.
+    static constexpr bool producer_can_evict = false;
+
+    /**
+     * @brief Try to put a record in the calling thread's ring.
+     *
+     * @param fill  A callback to fill a record: `void(Record&) noexcept`.
+     *
+     * @return True if the record was stored and false if the ring is full.
+     */
+    template < typename Fill >
+    bool try_push( Fill && fill )
+    {
+        static_assert( std::is_nothrow_invocable_v< Fill, Record & >,
+                       "Fill callback must be noexcept" );
+
+        return this_thread_ring().try_push( now(), fill );
+    }
+
+    /**
+     * @brief Consume up to a given number of records from all rings
+     *        in the order of capture.
+     *
+     * Must be called by a single consumer.
+     */
+    template < typename Consume >
+    std::size_t drain( std::size_t max_records, Consume && consume )
+    {
+        static_assert( std::is_nothrow_invocable_v< Consume, Record & >,
+                       "Consume callback must be noexcept" );
+
+        refresh_rings();
+
+        const auto cutoff = now();
+        const auto later  = []( const heap_item_t & a, const heap_item_t & b ) {
+            return a.first > b.first;
+        };
+
+        m_heap.clear();
+        for( std::size_t i = 0; i < m_consumer_rings.size(); ++i )
+        {
+            const auto * ts = m_consumer_rings[ i ]->front_timestamp();
+            if( nullptr != ts && *ts <= cutoff )
+            {
+                m_heap.emplace_back( *ts, i );
+            }
+        }
+        std::make_heap( begin( m_heap ), end( m_heap ), later );
+
+        std::size_t n = 0;
+        while( n < max_records && !m_heap.empty() )
+        {
+            std::pop_heap( begin( m_heap ), end( m_heap ), later );
+            const auto i = m_heap.back().second;
+            m_heap.pop_back();
+
+            auto & ring = *m_consumer_rings[ i ];
+            ring.pop_front( consume );
+            ++n;
+
+            const auto * ts = ring.front_timestamp();
+            if( nullptr != ts && *ts <= cutoff )
+            {
+                m_heap.emplace_back( *ts, i );
+                std::push_heap( begin( m_heap ), end( m_heap ), later );
+            }
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief Check if there is a record ready to be consumed.
+     *
+     * Must be called by the consumer. It is checked by an idle consumer
+     * each time it is woken up, so it doesn't lock the rings list:
+     * it checks the consumer's copy of the list, and a ring
+     * registered since the copy was made is picked up by `drain()`.
+     */
+    bool has_ready_record() const noexcept
+    {
+        if( m_rings_version.load( std::memory_order_acquire )
+            != m_consumer_rings_version )
+        {
+            // A new ring, most likely with a record.
+            return true;
+        }
+
+        return std::any_of( begin( m_consumer_rings ),
+                            end( m_consumer_rings ),
+                            []( const auto & r ) { return !r->empty(); } );
+    }
+
+    //! A position of each ring.
+    using position_t =
+        std::vector< std::pair< std::shared_ptr< ring_t >, std::size_t > >;
+
+    /**
+     * @brief Get the position after the last record of each ring.
+     *
+     * Must be called by the consumer.
+     */
+    position_t enqueue_position()
+    {
+        refresh_rings();
+
+        position_t pos;
+        pos.reserve( m_consumer_rings.size() );
+        for( const auto & r : m_consumer_rings )
+        {
+            pos.emplace_back( r, r->tail() );
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Check if all the records before a given position are consumed.
+     */
+    bool consumed( const position_t & pos ) const noexcept
+    {
+        return std::all_of( begin( pos ), end( pos ), []( const auto & p ) {
+            return p.first->consumed( p.second );
+        } );
+    }
+
+    /**
+     * @brief Visit records of all rings without consuming them
+     *        (async-signal-safe).
+     *
+     * Rings are visited one after another, so records are ordered
+     * within a ring only. If the rings list is locked (the crashed
+     * thread might be holding the lock) the consumer's copy is used.
+     */
+    template < typename Visit >
+    void crash_visit( Visit && visit ) noexcept
+    {
+        if( m_rings_mutex.try_lock() )
+        {
+            for( const auto & r : m_rings )
+            {
+                r->crash_visit( visit );
+            }
+            m_rings_mutex.unlock();
+        }
+        else
+        {
+            for( const auto & r : m_consumer_rings )
+            {
+                r->crash_visit( visit );
+            }
+        }
+    }
+
+    void fork_prepare() noexcept { m_rings_mutex.lock(); }
+
+    void fork_parent() noexcept { m_rings_mutex.unlock(); }
+
+    /**
+     * @brief Forget all rings in the child process.
+     *
+     * Rings belong to the threads of the parent,
+     * the calling thread gets a new ring with its next message.
+     */
+    void fork_child() noexcept
+    {
+        for( auto & r : m_rings )
+        {
+            r->consumer_alive.store( false, std::memory_order_relaxed );
+        }
+        m_rings.clear();
+        m_consumer_rings.clear();
+        m_consumer_rings_version =
+            m_rings_version.fetch_add( 1, std::memory_order_relaxed ) + 1;
+        m_rings_mutex.unlock();
+    }
+
+private:
+    using heap_item_t = std::pair< std::int64_t, std::size_t >;
+
+    static std::int64_t now() noexcept
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    /**
+     * @brief A reference to a ring kept by the producer thread.
+     */
+    struct thread_ring_ref_t
+    {
+        thread_ring_ref_t( const void * q, std::shared_ptr< ring_t > r ) noexcept
+            : queue{ q }
+            , ring{ std::move( r ) }
+        {
+        }
+
+        thread_ring_ref_t( thread_ring_ref_t && ) noexcept = default;
+        thread_ring_ref_t & operator=( thread_ring_ref_t && ) noexcept = default;
+
+        ~thread_ring_ref_t()
+        {
+            if( ring )
+            {
+                ring->producer_alive.store( false, std::memory_order_release );
+            }
+        }
+
+        const void * queue;
+        std::shared_ptr< ring_t > ring;
+    };
+
+    ring_t & this_thread_ring()
+    {
+        static thread_local std::vector< thread_ring_ref_t > thread_rings;
+
+        for( auto & ref : thread_rings )
+        {
+            if( this == ref.queue
+                && ref.ring->consumer_alive.load( std::memory_order_relaxed ) )
+            {
+                return *ref.ring;
+            }
+        }
+
+        // Forget rings of destroyed queues, as the address
+        // might be reused by this queue.
+        thread_rings.erase(
+            std::remove_if( begin( thread_rings ),
+                            end( thread_rings ),
+                            []( const auto & ref ) {
+                                return !ref.ring->consumer_alive.load(
+                                    std::memory_order_relaxed );
+                            } ),
+            end( thread_rings ) );
+
+        auto ring = std::make_shared< ring_t >( m_ring_capacity );
+        {
+            std::lock_guard lock{ m_rings_mutex };
+            m_rings.push_back( ring );
+            m_rings_version.fetch_add( 1, std::memory_order_release );
+        }
+
+        thread_rings.emplace_back( this, std::move( ring ) );
+        return *thread_rings.back().ring;
+    }
+
+    /**
+     * @brief Update consumer's copy of rings list.
+     *
+     * Rings of finished threads are removed once they are empty.
+     */
+    void refresh_rings()
+    {
+        const auto version = m_rings_version.load( std::memory_order_acquire );
+        if( version != m_consumer_rings_version )
+        {
+            std::lock_guard lock{ m_rings_mutex };
+            m_consumer_rings         = m_rings;
+            m_consumer_rings_version = version;
+        }
+
+        for( const auto & r : m_consumer_rings )
+        {
+            if( !r->producer_alive.load( std::memory_order_acquire ) && r->empty() )
+            {
+                std::lock_guard lock{ m_rings_mutex };
+                m_rings.erase( std::remove_if( begin( m_rings ),
+                                               end( m_rings ),
+                                               []( const auto & x ) {
+                                                   return !x->producer_alive.load(
+                                                              std::memory_order_acquire )
+                                                          && x->empty();
+                                               } ),
+                               end( m_rings ) );
+                m_consumer_rings         = m_rings;
+                m_consumer_rings_version = m_rings_version.fetch_add(
+                                               1, std::memory_order_acq_rel )
+                                           + 1;
+                break;
+            }
+        }
+    }
+
+    const std::size_t m_ring_capacity;
+
+    mutable std::mutex m_rings_mutex;
+    std::vector< std::shared_ptr< ring_t > > m_rings;
+    std::atomic< std::uint64_t > m_rings_version{ 0 };
+
+    // Consumer's data.
+    std::vector< std::shared_ptr< ring_t > > m_consumer_rings;
+    std::uint64_t m_consumer_rings_version{ 0 };
+    std::vector< heap_item_t > m_heap;
+};
+
+}  // namespace details
+
+//
+// async_overflow_policy
+//
+
+/**
+ * @brief What a producer does when async logger queue is full.
+ */
+enum class async_overflow_policy
+{
+    //! Wait for the consumer to free a slot.
+    block,
+    //! Drop the message being logged.
+    drop_newest,
+    //! Drop the oldest queued message (of any level) to free a slot.
+    overwrite_oldest
+};
+
+//
+// uniform_async_overflow_policy_t
+//
+
+/**
+ * @brief Apply the same overflow policy to all levels.
+ */
+template < async_overflow_policy Policy >
+struct uniform_async_overflow_policy_t
+{
+    static constexpr async_overflow_policy for_level(
+        log_message_level /* level */ ) noexcept
+    {
+        return Policy;
+    }
+};
+
+//
+// leveled_async_overflow_policy_t
+//
+
+/**
+ * @brief Block for important messages and apply a given policy
+ *        to others.
+ *
+ * @tparam Min_Blocking_Level  The lowest level for which producer blocks.
+ * @tparam Policy              A policy for the levels below.
+ */
+template < log_message_level Min_Blocking_Level,
+           async_overflow_policy Policy = async_overflow_policy::drop_newest >
+struct leveled_async_overflow_policy_t
+{
+    static constexpr async_overflow_policy for_level(
+        log_message_level level ) noexcept
+    {
+        return level < Min_Blocking_Level ? Policy : async_overflow_policy::block;
+    }
+};
+
+//
+// busy_spin_wait_strategy_t
+//
+
+/**
+ * @brief Consumer never sleeps and keeps checking the queue.
+ *
+ * The lowest wake up latency at the cost of a fully loaded CPU core,
+ * makes sense with the consumer pinned to a dedicated core
+ * (see `async_logger_t::set_consumer_affinity()`).
+ * Producers never make syscalls to wake the consumer.
+ */
+class busy_spin_wait_strategy_t
+{
+public:
+    template < typename Has_Work >
+    void wait( Has_Work && has_work ) noexcept( noexcept( has_work() ) )
+    {
+        while( !has_work() )
+        {
+            details::cpu_relax();
+        }
+    }
+
+    void notify() noexcept {}
+
+    void wake() noexcept {}
+
+    void fork_prepare() noexcept {}
+    void fork_parent() noexcept {}
+    void fork_child() noexcept {}
+};
+
+//
+// yielding_wait_strategy_t
+//
+
+/**
+ * @brief Consumer spins for a while and then yields its time slice
+ *        until there is a work.
+ *
+ * Latency is close to busy spin while other threads can run
+ * on the same core, but an idle consumer still burns CPU.
+ * Producers never make syscalls to wake the consumer.
+ *
+ * @tparam Spins  Number of checks before starting to yield.
+ */
+template < unsigned Spins = 100 >
+class yielding_wait_strategy_t
+{
+public:
+    template < typename Has_Work >
+    void wait( Has_Work && has_work )
+    {
+        for( unsigned i = 0; i < Spins; ++i )
+        {
+            if( has_work() )
+            {
+                return;
+            }
+            details::cpu_relax();
+        }
+
+        while( !has_work() )
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void notify() noexcept {}
+
+    void wake() noexcept {}
+
+    void fork_prepare() noexcept {}
+    void fork_parent() noexcept {}
+    void fork_child() noexcept {}
+};
+
+//
+// blocking_wait_strategy_t
+//
+
+/**
+ * @brief Consumer yields for a while and then blocks
+ *        on a condition variable (a futex on Linux).
+ *
+ * An idle consumer doesn't use CPU, but waking it up
+ * takes a syscall on producer side and a scheduler wake up latency.
+ * A producer makes a syscall only if the consumer is sleeping.
+ *
+ * @tparam Yields  Number of checks (with yielding) before blocking.
+ */
+template < unsigned Yields = 64 >
+class blocking_wait_strategy_t
+{
+public:
+    template < typename Has_Work >
+    void wait( Has_Work && has_work )
+    {
+        for( unsigned i = 0; i < Yields; ++i )
+        {
+            if( has_work() )
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        m_sleeping.store( true, std::memory_order_relaxed );
+        // Pairs with a fence in notify(): either a producer
+        // sees the consumer sleeping or the consumer sees the message.
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        {
+            std::unique_lock lock{ m_mutex };
+            m_cv.wait( lock, has_work );
+        }
+        m_sleeping.store( false, std::memory_order_relaxed );
+    }
+
+    /**
+     * @brief Wake the consumer if it sleeps (called after a message is queued).
+     */
+    void notify()
+    {
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( m_sleeping.load( std::memory_order_relaxed ) )
+        {
+            wake();
+        }
+    }
+
+    /**
+     * @brief Wake the consumer unconditionally.
+     */
+    void wake()
+    {
+        // Lock is acquired to make sure the consumer
+        // is either not yet checked the condition or already waits.
+        {
+            std::lock_guard lock{ m_mutex };
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * @brief Keep the mutex locked over `fork()`,
+     *        so the child doesn't get it locked by a gone thread.
+     */
+    void fork_prepare() noexcept { m_mutex.lock(); }
+    void fork_parent() noexcept { m_mutex.unlock(); }
+    void fork_child() noexcept { m_mutex.unlock(); }
+
+private:
+    alignas( details::cache_line_size ) std::atomic< bool > m_sleeping{ false };
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+//
+// async_logger_traits_t
+//
+
+/**
+ * @brief Default traits for async logger.
+ *
+ * Uses a single lock-free queue shared by all producers.
+ */
+struct async_logger_traits_t
+{
+    //! A queue for passing records to the consumer.
+    template < typename Record >
+    using queue_t = details::mpsc_bounded_queue_t< Record >;
+
+    /**
+     * @brief Max size of a deferred message stored in a queue slot.
+     *
+     * Deferred messages of a bigger size are formatted
+     * on the producer side.
+     */
+    static constexpr std::size_t deferred_capacity = 256;
+
+    /**
+     * @brief What to do when the queue is full
+     *        (see @c uniform_async_overflow_policy_t and
+     *        @c leveled_async_overflow_policy_t).
+     */
+    using overflow_policy_t =
+        uniform_async_overflow_policy_t< async_overflow_policy::block >;
+
+    /**
+     * @brief Run a dedicated consumer thread.
+     *
+     * If false, the queue is drained by explicit
+     * `async_logger_t::poll_drain()` calls.
+     */
+    static constexpr bool consumer_thread = true;
+
+    /**
+     * @brief How the consumer thread waits for messages
+     *        (see @c busy_spin_wait_strategy_t, @c yielding_wait_strategy_t
+     *        and @c blocking_wait_strategy_t).
+     *
+     * A strategy provides `wait(has_work)`, `notify()`, `wake()`
+     * and `fork_prepare()`, `fork_parent()`, `fork_child()`
+     * to keep its locks consistent over `fork()`.
+     */
+    using wait_strategy_t = blocking_wait_strategy_t<>;
+
+    /**
+     * @brief The lowest level of messages going through the priority lane.
+     *
+     * Messages of this level and above have a separate queue
+     * which the consumer drains first, so they don't wait
+     * behind a backlog of less important messages.
+     * Set to `log_message_level::nolog` to use a single queue.
+     */
+    static constexpr log_message_level priority_level = log_message_level::error;
+
+    //! Max number of messages in priority lane.
+    static constexpr std::size_t priority_queue_capacity = 512;
+};
+
+//
+// per_thread_async_logger_traits_t
+//
+
+/**
+ * @brief Traits for async logger using per-thread queues.
+ *
+ * Each producer thread gets its own SPSC ring,
+ * so producers don't contend on a shared cache line.
+ * The consumer merges rings by capture timestamp.
+ * Queue capacity is applied to each ring.
+ *
+ * A producer cannot evict records from its ring,
+ * so `async_overflow_policy::overwrite_oldest` acts as
+ * `async_overflow_policy::drop_newest`.
+ */
+struct per_thread_async_logger_traits_t : public async_logger_traits_t
+{
+    //! A queue for passing records to the consumer.
+    template < typename Record >
+    using queue_t = details::per_thread_spsc_queue_t< Record >;
+};
+
+//
+// polled_async_logger_traits_t
+//
+
+/**
+ * @brief Traits for async logger drained by the application.
+ *
+ * No consumer thread is started: an application (e.g. an event loop)
+ * calls `async_logger_t::poll_drain()` to pass queued messages
+ * to the backend. On Linux `async_logger_t::notify_fd()` gives
+ * an eventfd which becomes readable when there are messages to drain.
+ */
+struct polled_async_logger_traits_t : public async_logger_traits_t
+{
+    static constexpr bool consumer_thread = false;
+};
+
+//
+// async_logger_t
+//
+
+/**
+ * @brief An adapter running a given logger backend on a separate thread.
+ *
+ * Enabled messages are copied (with their level and source location)
+ * into a preallocated lock-free queue and a dedicated consumer thread
+ * passes them to the wrapped backend. So the caller doesn't pay
+ * for backend formatting, locking and I/O.
+ *
+ * The wrapped backend receives messages via its public
+ * `message<Level>()` routine, so backend log level acts as
+ * a second filter (normally it is set to `log_message_level::trace`).
+ * Backend must not be used directly while async logger is alive.
+ *
+ * `flush()` is a barrier: it returns when all the messages
+ * queued before it has been delivered to the backend and
+ * the backend has been flushed.
+ *
+ * Messages of `async_logger_traits_t::priority_level` and above
+ * go through a separate queue the consumer drains first.
+ * Messages keep their order within a lane (but not across the lanes).
+ *
+ * When queue is full a producer acts according to overflow policy
+ * which can be set per level (see `async_logger_traits_t::overflow_policy_t`).
+ * By default it waits until the consumer frees a slot.
+ * Dropped messages are counted per level and the consumer reports them
+ * to the backend with a "N messages dropped" message of the same level
+ * once it frees the queue.
+ *
+ * Deferred messages (see `deferred_format()`) are copied into the queue
+ * as captured arguments and are passed to the backend on the consumer thread
+ * (which formats them, unless it handles deferred messages on its own),
+ * so the caller doesn't pay for formatting either.
+ *
+ * The level check is still done inline by `basic_logger_type_t::message()`,
+ * so only enabled messages reach the queue.
+ *
+ * How an idle consumer waits for messages is defined by
+ * `async_logger_traits_t::wait_strategy_t`, and the consumer can be
+ * pinned to a set of CPUs with `set_consumer_affinity()`.
+ *
+ * With `polled_async_logger_traits_t` there is no consumer thread,
+ * and messages are delivered by `poll_drain()` calls
+ * (`flush()` drains the queue on the calling thread).
+ *
+ * The logger registers itself in `crash_drain_registry()`,
+ * so once `install_crash_drain()` is called queued messages
+ * are written out on a crash and the consumer thread
+ * is restarted after `fork()` (in the parent and in the child).
+ *
+ * @code{.cpp}
+ * logr::async_logger_t< logr::spdlog_logger_t<> > logger{
+ *     logr::log_message_level::info,
+ *     8192, // Queue capacity.
+ *     // Backend constructor args:
+ *     "async-console",
+ *     std::make_shared< spdlog::sinks::stdout_sink_st >(),
+ *     logr::log_message_level::trace };
+ * @endcode
+ *
+ * @tparam Backend       A logger derived from `basic_logger_t`
+ *                       used as the backend.
+ * @tparam Async_Traits  Queuing properties of the logger
+ *                       (see @c async_logger_traits_t).
+ */
+template < typename Backend, typename Async_Traits = async_logger_traits_t >
+class async_logger_t final
+    : public Backend::root_logger_type_t
+    , public crash_drainable_t
+{
+public:
+    using backend_t           = Backend;
+    using async_traits_t      = Async_Traits;
+    using base_type_t         = typename Backend::root_logger_type_t;
+    using message_container_t = typename base_type_t::message_container_t;
+    using string_view_t       = typename base_type_t::string_view_t;
+    using deferred_message_view_t =
+        typename base_type_t::deferred_message_view_t;
+    using static_message_t = typename base_type_t::static_message_t;
+
+    //! Default size of the queue.
+    static constexpr std::size_t default_queue_capacity = 8192;
+
+    /**
+     * @brief Create async logger and start its consumer thread.
+     *
+     * @param level           Log level of the logger.
+     * @param queue_capacity  Max number of queued messages
+     *                        (rounded up to the power of 2).
+     * @param backend_args    Arguments for constructing backend.
+     */
+    template < typename... Backend_Args >
+    async_logger_t( log_message_level level,
+                    std::size_t queue_capacity,
+                    Backend_Args &&... backend_args )
+        : base_type_t{ level }
+        , m_backend{ std::forward< Backend_Args >( backend_args )... }
+        , m_queue{ queue_capacity }
+        , m_priority_queue{ has_priority_lane
+                                ? async_traits_t::priority_queue_capacity
+                                : 1 }
+    {
+        if constexpr( async_traits_t::consumer_thread )
+        {
+            m_consumer = std::thread{ [ this ] { consumer_loop(); } };
+            m_consumer_running.store( true, std::memory_order_release );
+        }
+        else
+        {
+#if defined( __linux__ )
+            m_notify_fd = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+            if( -1 == m_notify_fd )
+            {
+                throw std::system_error{ errno,
+                                         std::system_category(),
+                                         "eventfd() failed" };
+            }
+#endif
+        }
+
+        try
+        {
+            crash_drain_registry().add( this );
+        }
+        catch( ... )
+        {
+            release_consumer();
+            throw;
+        }
+    }
+
+    ~async_logger_t() override
+    {
+        crash_drain_registry().remove( this );
+
+        if constexpr( !async_traits_t::consumer_thread )
+        {
+            try
+            {
+                log_flush();
+            }
+            catch( ... )
+            {
+            }
+        }
+        release_consumer();
+    }
+
+    async_logger_t( const async_logger_t & ) = delete;
+    async_logger_t & operator=( const async_logger_t & ) = delete;
+
+    /**
+     * @brief Access the wrapped backend.
+     */
+    backend_t & backend() noexcept { return m_backend; }
+
+    /**
+     * @brief Get the number of dropped messages of a given level.
+     */
+    std::uint64_t dropped_messages( log_message_level level ) const noexcept
+    {
+        return level < log_message_level::nolog
+                   ? m_dropped[ static_cast< std::size_t >( level ) ].load(
+                       std::memory_order_relaxed )
+                   : 0;
+    }
+
+    /**
+     * @brief Deliver queued messages to the backend.
+     *
+     * Available when the logger has no consumer thread
+     * (see @c polled_async_logger_traits_t).
+     * Calls from different threads are serialized.
+     *
+     * @param max_records  Max number of messages to deliver.
+     * @param max_time     Stop once this time is spent
+     *                     (checked after each batch of messages).
+     *
+     * @return The number of delivered messages.
+     */
+    std::size_t poll_drain(
+        std::size_t max_records,
+        std::chrono::steady_clock::duration max_time =
+            std::chrono::steady_clock::duration::max() )
+    {
+        static_assert( !async_traits_t::consumer_thread,
+                       "poll_drain() is for loggers without consumer thread" );
+
+        const auto started = std::chrono::steady_clock::now();
+
+        std::lock_guard lock{ m_poll_mutex };
+        clear_notification();
+
+        std::size_t n = 0;
+        while( n < max_records )
+        {
+            const auto handled =
+                drain( std::min( poll_batch_size, max_records - n ) );
+            n += handled;
+
+            if( 0 == handled
+                || std::chrono::steady_clock::now() - started >= max_time )
+            {
+                break;
+            }
+        }
+
+        report_dropped();
+
+        if( has_ready_record() )
+        {
+            // Make sure the rest is not forgotten.
+            signal_notification();
+        }
+
+        return n;
+    }
+
+    /**
+     * @brief Get a file descriptor an event loop can watch
+     *        for queued messages.
+     *
+     * It is an eventfd which becomes readable when messages are queued
+     * and is reset by `poll_drain()`.
+     * It is -1 if the logger has a consumer thread or
+     * the platform has no eventfd.
+     */
+    int notify_fd() const noexcept { return m_notify_fd; }
+
+    /**
+     * @brief Pin the consumer thread to a given set of CPUs.
+     *
+     * Keeps the consumer off the cores used by latency critical threads.
+     * The consumer restarted after `fork()` is pinned to the same CPUs.
+     *
+     * @param cpus  CPU numbers the consumer is allowed to run on.
+     *
+     * @return True if the affinity was set and false if it is not supported
+     *         (no consumer thread or not Linux) or has failed.
+     */
+    bool set_consumer_affinity( const std::vector< int > & cpus ) noexcept
+    {
+#if defined( __linux__ )
+        if( !m_consumer.joinable() || cpus.empty() )
+        {
+            return false;
+        }
+
+        cpu_set_t cpu_set;
+        CPU_ZERO( &cpu_set );
+        for( const auto cpu : cpus )
+        {
+            if( cpu < 0 || cpu >= CPU_SETSIZE )
+            {
+                return false;
+            }
+            CPU_SET( cpu, &cpu_set );
+        }
+
+        if( 0
+            != ::pthread_setaffinity_np(
+                m_consumer.native_handle(), sizeof( cpu_set ), &cpu_set ) )
+        {
+            return false;
+        }
+
+        m_consumer_cpus   = cpu_set;
+        m_consumer_pinned = true;
+        return true;
+#else
+        static_cast< void >( cpus );
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Write queued messages to a given file descriptor
+     *        (async-signal-safe).
+     *
+     * Messages are written as "[level] text" lines.
+     * Deferred messages cannot be formatted in a signal handler,
+     * so only a placeholder is written for them.
+     * Per-thread rings can be popped by the consumer only,
+     * so with `per_thread_async_logger_traits_t` they are scanned
+     * without consuming, ring by ring.
+     */
+    void crash_drain( int fd ) noexcept override
+    {
+        if constexpr( queue_t::producer_can_evict )
+        {
+            const auto write_record = [ fd ]( record_t & rec ) noexcept {
+                crash_write_record( fd, rec );
+            };
+
+            // At most one pass over each queue,
+            // as producers might still be running.
+            m_priority_queue.drain( m_priority_queue.capacity(), write_record );
+            m_queue.drain( m_queue.capacity(), write_record );
+        }
+        else
+        {
+            const auto write_record = [ fd ]( const record_t & rec ) noexcept {
+                crash_write_record( fd, rec );
+            };
+
+            m_priority_queue.crash_visit( write_record );
+            m_queue.crash_visit( write_record );
+        }
+    }
+
+    /**
+     * @brief Deliver queued messages and stop the consumer before `fork()`.
+     *
+     * Locks are held till `fork()` is over, so that the child
+     * gets them unlocked.
+     */
+    void fork_prepare() noexcept override
+    {
+        if constexpr( async_traits_t::consumer_thread )
+        {
+            stop_consumer();
+            m_poll_mutex.lock();
+        }
+        else
+        {
+            m_poll_mutex.lock();
+            drain_queued();
+            report_dropped();
+            try
+            {
+                m_backend.flush();
+            }
+            catch( ... )
+            {
+            }
+        }
+
+        m_flush_mutex.lock();
+        m_queue.fork_prepare();
+        m_priority_queue.fork_prepare();
+        m_wait_strategy.fork_prepare();
+    }
+
+    void fork_parent() noexcept override
+    {
+        m_wait_strategy.fork_parent();
+        m_priority_queue.fork_parent();
+        m_queue.fork_parent();
+        m_flush_mutex.unlock();
+
+        if constexpr( async_traits_t::consumer_thread )
+        {
+            start_consumer();
+        }
+        m_poll_mutex.unlock();
+    }
+
+    void fork_child() noexcept override
+    {
+        m_wait_strategy.fork_child();
+        m_priority_queue.fork_child();
+        m_queue.fork_child();
+
+        // Threads waiting for a flush are left in the parent,
+        // so their requests are done and the condition variable
+        // must not count them as waiters. It is not destroyed,
+        // as destroying waits for the waiters, which never come.
+        m_flush_completed.store( m_flush_requested.load( std::memory_order_relaxed ),
+                                 std::memory_order_relaxed );
+        new( &m_flush_cv ) std::condition_variable{};
+        m_flush_mutex.unlock();
+
+        if constexpr( async_traits_t::consumer_thread )
+        {
+            start_consumer();
+        }
+        else
+        {
+#if defined( __linux__ )
+            // Eventfd is shared with the parent.
+            ::close( m_notify_fd );
+            m_notify_fd = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+#endif
+            m_notification_pending.store( false, std::memory_order_relaxed );
+        }
+        m_poll_mutex.unlock();
+    }
+
+private:
+    using record_t =
+        details::async_message_record_t< message_container_t,
+                                         deferred_message_view_t,
+                                         async_traits_t::deferred_capacity >;
+
+    using queue_t = typename async_traits_t::template queue_t< record_t >;
+
+    //! Max number of records handled before checking flush requests.
+    static constexpr std::size_t drain_batch_size = 256;
+
+    //! Max number of records handled before checking poll time limit.
+    static constexpr std::size_t poll_batch_size = 32;
+
+    //! Is there a separate queue for important messages.
+    static constexpr bool has_priority_lane =
+        async_traits_t::priority_level < log_message_level::nolog;
+
+    //! Max number of normal records handled before checking priority lane.
+    static constexpr std::size_t priority_check_interval = 16;
+
+    /**
+     * @brief Get the queue for messages of a given level.
+     */
+    template < log_message_level Level >
+    queue_t & queue_for() noexcept
+    {
+        if constexpr( has_priority_lane && Level >= async_traits_t::priority_level )
+        {
+            return m_priority_queue;
+        }
+        else
+        {
+            return m_queue;
+        }
+    }
+
+    //! Number of levels messages can be logged with.
+    static constexpr std::size_t levels_count =
+        static_cast< std::size_t >( log_message_level::nolog );
+
+    // Messages queueing.
+
+    template < log_message_level Level >
+    void enqueue( const src_location_t * src_location, string_view_t message )
+    {
+        auto fill = [ & ]( record_t & rec ) noexcept {
+            set_header< Level >( rec, src_location );
+
+            auto & buf = rec.message.msg_buffer();
+            buf.clear();
+            try
+            {
+                buf.append( message.data(), message.data() + message.size() );
+            }
+            catch( ... )
+            {
+                // Cannot allocate for the message, skip it.
+                rec.level = log_message_level::nolog;
+            }
+        };
+
+        push< Level >( fill );
+    }
+
+    template < log_message_level Level >
+    void enqueue_static( const src_location_t * src_location,
+                         static_message_t message )
+    {
+        push< Level >( [ & ]( record_t & rec ) noexcept {
+            set_header< Level >( rec, src_location );
+            // Only a pointer to the text is stored.
+            rec.is_static   = true;
+            rec.static_text = message.view();
+        } );
+    }
+
+    template < log_message_level Level >
+    void enqueue_owned( const src_location_t * src_location,
+                        message_container_t && message )
+    {
+        push< Level >( [ & ]( record_t & rec ) noexcept {
+            set_header< Level >( rec, src_location );
+            // Takes over a heap allocated buffer (if any).
+            rec.message = std::move( message );
+        } );
+    }
+
+    template < log_message_level Level >
+    void enqueue_deferred( const src_location_t * src_location,
+                           deferred_message_view_t message )
+    {
+        if( !record_t::can_store( message ) )
+        {
+            // Too big to be copied: render it here.
+            message_container_t msg;
+            message.format_to( msg.msg_buffer() );
+            enqueue_owned< Level >( src_location, std::move( msg ) );
+            return;
+        }
+
+        push< Level >( [ & ]( record_t & rec ) noexcept {
+            set_header< Level >( rec, src_location );
+            rec.deferred_format_fn = message.format_fn();
+            rec.deferred_visit_fn  = message.visit_fn();
+            rec.deferred_size      = message.size();
+            std::memcpy( rec.deferred_message, message.data(), message.size() );
+        } );
+    }
+
+    template < log_message_level Level >
+    static void set_header( record_t & rec,
+                            const src_location_t * src_location ) noexcept
+    {
+        rec.level              = Level;
+        rec.deferred_format_fn = nullptr;
+        rec.is_static          = false;
+        rec.has_src_location   = nullptr != src_location;
+        if( rec.has_src_location )
+        {
+            rec.src_location = *src_location;
+        }
+    }
+
+    template < log_message_level Level, typename Fill >
+    void push( Fill && fill )
+    {
+        constexpr auto policy =
+            async_traits_t::overflow_policy_t::for_level( Level );
+
+        auto & queue = queue_for< Level >();
+
+        if constexpr( async_overflow_policy::block == policy )
+        {
+            while( !queue.try_push( fill ) )
+            {
+                // Queue is full: let the consumer catch up.
+                if constexpr( async_traits_t::consumer_thread )
+                {
+                    wake_consumer();
+                }
+                else
+                {
+                    help_drain();
+                }
+                std::this_thread::yield();
+            }
+        }
+        else if constexpr( async_overflow_policy::overwrite_oldest == policy
+                           && queue_t::producer_can_evict )
+        {
+            while( !queue.try_push( fill ) )
+            {
+                const bool evicted =
+                    queue.try_pop( [ this ]( record_t & rec ) noexcept {
+                        count_dropped( rec.level );
+                    } );
+
+                if( !evicted )
+                {
+                    // The consumer holds the slot.
+                    count_dropped( Level );
+                    break;
+                }
+            }
+        }
+        else
+        {
+            if( !queue.try_push( fill ) )
+            {
+                count_dropped( Level );
+            }
+        }
+
+        notify_consumer();
+    }
+
+    void count_dropped( log_message_level level ) noexcept
+    {
+        if( level < log_message_level::nolog )
+        {
+            m_dropped[ static_cast< std::size_t >( level ) ].fetch_add(
+                1, std::memory_order_relaxed );
+        }
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        enqueue< log_message_level::trace >( nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        enqueue< log_message_level::trace >( &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        enqueue< log_message_level::debug >( nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        enqueue< log_message_level::debug >( &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        enqueue< log_message_level::info >( nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        enqueue< log_message_level::info >( &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        enqueue< log_message_level::warn >( nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        enqueue< log_message_level::warn >( &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        enqueue< log_message_level::error >( nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        enqueue< log_message_level::error >( &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        enqueue< log_message_level::critical >( nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        enqueue< log_message_level::critical >( &src_location, message );
+    }
+
+    void log_static_message_trace( static_message_t message ) override
+    {
+        enqueue_static< log_message_level::trace >( nullptr, message );
+    }
+
+    void log_static_message_trace( src_location_t src_location,
+                                   static_message_t message ) override
+    {
+        enqueue_static< log_message_level::trace >( &src_location, message );
+    }
+
+    void log_static_message_debug( static_message_t message ) override
+    {
+        enqueue_static< log_message_level::debug >( nullptr, message );
+    }
+
+    void log_static_message_debug( src_location_t src_location,
+                                   static_message_t message ) override
+    {
+        enqueue_static< log_message_level::debug >( &src_location, message );
+    }
+
+    void log_static_message_info( static_message_t message ) override
+    {
+        enqueue_static< log_message_level::info >( nullptr, message );
+    }
+
+    void log_static_message_info( src_location_t src_location,
+                                  static_message_t message ) override
+    {
+        enqueue_static< log_message_level::info >( &src_location, message );
+    }
+
+    void log_static_message_warn( static_message_t message ) override
+    {
+        enqueue_static< log_message_level::warn >( nullptr, message );
+    }
+
+    void log_static_message_warn( src_location_t src_location,
+                                  static_message_t message ) override
+    {
+        enqueue_static< log_message_level::warn >( &src_location, message );
+    }
+
+    void log_static_message_error( static_message_t message ) override
+    {
+        enqueue_static< log_message_level::error >( nullptr, message );
+    }
+
+    void log_static_message_error( src_location_t src_location,
+                                   static_message_t message ) override
+    {
+        enqueue_static< log_message_level::error >( &src_location, message );
+    }
+
+    void log_static_message_critical( static_message_t message ) override
+    {
+        enqueue_static< log_message_level::critical >( nullptr, message );
+    }
+
+    void log_static_message_critical( src_location_t src_location,
+                                      static_message_t message ) override
+    {
+        enqueue_static< log_message_level::critical >( &src_location, message );
+    }
+
+    void log_owned_message_trace( message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::trace >( nullptr, std::move( message ) );
+    }
+
+    void log_owned_message_trace( src_location_t src_location,
+                                  message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::trace >( &src_location,
+                                                   std::move( message ) );
+    }
+
+    void log_owned_message_debug( message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::debug >( nullptr, std::move( message ) );
+    }
+
+    void log_owned_message_debug( src_location_t src_location,
+                                  message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::debug >( &src_location,
+                                                   std::move( message ) );
+    }
+
+    void log_owned_message_info( message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::info >( nullptr, std::move( message ) );
+    }
+
+    void log_owned_message_info( src_location_t src_location,
+                                 message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::info >( &src_location,
+                                                  std::move( message ) );
+    }
+
+    void log_owned_message_warn( message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::warn >( nullptr, std::move( message ) );
+    }
+
+    void log_owned_message_warn( src_location_t src_location,
+                                 message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::warn >( &src_location,
+                                                  std::move( message ) );
+    }
+
+    void log_owned_message_error( message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::error >( nullptr, std::move( message ) );
+    }
+
+    void log_owned_message_error( src_location_t src_location,
+                                  message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::error >( &src_location,
+                                                   std::move( message ) );
+    }
+
+    void log_owned_message_critical( message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::critical >( nullptr,
+                                                      std::move( message ) );
+    }
+
+    void log_owned_message_critical( src_location_t src_location,
+                                     message_container_t && message ) override
+    {
+        enqueue_owned< log_message_level::critical >( &src_location,
+                                                      std::move( message ) );
+    }
+
+    void log_deferred_message_trace( deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::trace >( nullptr, message );
+    }
+
+    void log_deferred_message_trace( src_location_t src_location,
+                                     deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::trace >( &src_location, message );
+    }
+
+    void log_deferred_message_debug( deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::debug >( nullptr, message );
+    }
+
+    void log_deferred_message_debug( src_location_t src_location,
+                                     deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::debug >( &src_location, message );
+    }
+
+    void log_deferred_message_info( deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::info >( nullptr, message );
+    }
+
+    void log_deferred_message_info( src_location_t src_location,
+                                    deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::info >( &src_location, message );
+    }
+
+    void log_deferred_message_warn( deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::warn >( nullptr, message );
+    }
+
+    void log_deferred_message_warn( src_location_t src_location,
+                                    deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::warn >( &src_location, message );
+    }
+
+    void log_deferred_message_error( deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::error >( nullptr, message );
+    }
+
+    void log_deferred_message_error( src_location_t src_location,
+                                     deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::error >( &src_location, message );
+    }
+
+    void log_deferred_message_critical( deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::critical >( nullptr, message );
+    }
+
+    void log_deferred_message_critical( src_location_t src_location,
+                                        deferred_message_view_t message ) override
+    {
+        enqueue_deferred< log_message_level::critical >( &src_location, message );
+    }
+
+    void log_flush() override
+    {
+        if constexpr( !async_traits_t::consumer_thread )
+        {
+            std::lock_guard lock{ m_poll_mutex };
+            clear_notification();
+            drain_queued();
+            report_dropped();
+            m_backend.flush();
+            return;
+        }
+
+        if( !m_consumer_running.load( std::memory_order_acquire ) )
+        {
+            // The consumer has failed to restart after `fork()`.
+            std::lock_guard lock{ m_poll_mutex };
+            if( !m_consumer_running.load( std::memory_order_relaxed ) )
+            {
+                drain_queued();
+                report_dropped();
+                m_backend.flush();
+                return;
+            }
+        }
+
+        const auto ticket =
+            m_flush_requested.fetch_add( 1, std::memory_order_acq_rel ) + 1;
+
+        wake_consumer();
+
+        std::unique_lock lock{ m_flush_mutex };
+        m_flush_cv.wait( lock, [ & ] {
+            return m_flush_completed.load( std::memory_order_acquire ) >= ticket;
+        } );
+    }
+
+    // Consumer thread routines.
+
+    /**
+     * @brief Restart the consumer thread.
+     *
+     * Must be called with `m_poll_mutex` locked.
+     * If a thread cannot be created, flushes requested so far
+     * are completed here and `log_flush()` drains queues itself.
+     */
+    void start_consumer() noexcept
+    {
+        m_stopped.store( false, std::memory_order_release );
+        try
+        {
+            m_consumer = std::thread{ [ this ] { consumer_loop(); } };
+        }
+        catch( ... )
+        {
+            try
+            {
+                drain_queued();
+            }
+            catch( ... )
+            {
+            }
+            complete_flush( m_flush_requested.load( std::memory_order_acquire ) );
+            return;
+        }
+        m_consumer_running.store( true, std::memory_order_release );
+
+#if defined( __linux__ )
+        if( m_consumer_pinned )
+        {
+            ::pthread_setaffinity_np( m_consumer.native_handle(),
+                                      sizeof( m_consumer_cpus ),
+                                      &m_consumer_cpus );
+        }
+#endif
+    }
+
+    /**
+     * @brief Stop the consumer thread or close the notification fd.
+     */
+    void release_consumer() noexcept
+    {
+        if constexpr( async_traits_t::consumer_thread )
+        {
+            stop_consumer();
+        }
+        else
+        {
+#if defined( __linux__ )
+            ::close( m_notify_fd );
+#endif
+        }
+    }
+
+    /**
+     * @brief Stop the consumer thread once it delivers queued messages.
+     */
+    void stop_consumer() noexcept
+    {
+        if( m_consumer.joinable() )
+        {
+            m_stopped.store( true, std::memory_order_release );
+            wake_consumer();
+            m_consumer.join();
+            m_consumer_running.store( false, std::memory_order_release );
+        }
+    }
+
+    // Consumer routines.
+
+    template < log_message_level Level, typename Message >
+    void deliver_level_x( const src_location_t * src_location, Message message )
+    {
+        if( nullptr != src_location )
+        {
+            m_backend.template message< Level >( *src_location, message );
+        }
+        else
+        {
+            m_backend.template message< Level >( message );
+        }
+    }
+
+    /**
+     * @brief Pass a message (a text or a deferred message view) to the backend.
+     */
+    template < typename Message >
+    void deliver( log_message_level level,
+                  const src_location_t * src_location,
+                  Message message ) noexcept
+    {
+        try
+        {
+            switch( level )
+            {
+                case log_message_level::trace:
+                    deliver_level_x< log_message_level::trace >( src_location,
+                                                                 message );
+                    break;
+
+                case log_message_level::debug:
+                    deliver_level_x< log_message_level::debug >( src_location,
+                                                                 message );
+                    break;
+
+                case log_message_level::info:
+                    deliver_level_x< log_message_level::info >( src_location,
+                                                                message );
+                    break;
+
+                case log_message_level::warn:
+                    deliver_level_x< log_message_level::warn >( src_location,
+                                                                message );
+                    break;
+
+                case log_message_level::error:
+                    deliver_level_x< log_message_level::error >( src_location,
+                                                                 message );
+                    break;
+
+                case log_message_level::critical:
+                    deliver_level_x< log_message_level::critical >(
+                        src_location, message );
+                    break;
+
+                case log_message_level::nolog:
+                    break;
+            }
+        }
+        catch( ... )
+        {
+            // There is no one to report the failure to.
+        }
+    }
+
+    void dispatch( record_t & rec ) noexcept
+    {
+        const auto * src_location =
+            rec.has_src_location ? &rec.src_location : nullptr;
+
+        if( nullptr != rec.deferred_format_fn )
+        {
+            // The backend decides how to render it
+            // (by default it is formatted to a text).
+            deliver( rec.level,
+                     src_location,
+                     deferred_message_view_t{ rec.deferred_message,
+                                              rec.deferred_size,
+                                              alignof( std::max_align_t ),
+                                              rec.deferred_format_fn,
+                                              rec.deferred_visit_fn } );
+            return;
+        }
+
+        deliver( rec.level,
+                 src_location,
+                 rec.is_static ? rec.static_text : rec.message.make_view() );
+    }
+
+    /**
+     * @brief Write a record to a file descriptor (async-signal-safe).
+     */
+    static void crash_write_record( int fd, const record_t & rec ) noexcept
+    {
+        details::crash_write( fd, details::crash_level_name( rec.level ) );
+
+        if constexpr( std::is_same_v< typename string_view_t::value_type, char > )
+        {
+            if( nullptr != rec.deferred_format_fn )
+            {
+                details::crash_write( fd, "<deferred message is not formatted>" );
+            }
+            else
+            {
+                details::crash_write( fd,
+                                      rec.is_static ? rec.static_text
+                                                    : rec.message.make_view() );
+            }
+        }
+        else
+        {
+            details::crash_write( fd, "<wide message is not written>" );
+        }
+
+        details::crash_write( fd, "\n" );
+    }
+
+    static void append_ascii( message_container_t & msg, std::string_view text )
+    {
+        auto & buf = msg.msg_buffer();
+        for( const char c : text )
+        {
+            buf.push_back( static_cast< typename string_view_t::value_type >( c ) );
+        }
+    }
+
+    /**
+     * @brief Let the backend know about messages dropped since
+     *        the last report.
+     */
+    void report_dropped()
+    {
+        for( std::size_t i = 0; i < levels_count; ++i )
+        {
+            const auto dropped = m_dropped[ i ].load( std::memory_order_relaxed );
+            if( dropped == m_reported_dropped[ i ] )
+            {
+                continue;
+            }
+
+            const auto n            = dropped - m_reported_dropped[ i ];
+            m_reported_dropped[ i ] = dropped;
+
+            try
+            {
+                message_container_t msg;
+                const ::fmt::format_int count{ n };
+                append_ascii( msg, std::string_view{ count.data(), count.size() } );
+                append_ascii( msg, " messages dropped" );
+
+                deliver( static_cast< log_message_level >( i ),
+                         nullptr,
+                         msg.make_view() );
+            }
+            catch( ... )
+            {
+            }
+        }
+    }
+
+    /**
+     * @brief Move a record out of its slot to the consumer's record.
+     */
+    void take( record_t & rec ) noexcept
+    {
+        m_current.level              = rec.level;
+        m_current.has_src_location   = rec.has_src_location;
+        m_current.src_location       = rec.src_location;
+        m_current.is_static          = rec.is_static;
+        m_current.static_text        = rec.static_text;
+        m_current.deferred_format_fn = rec.deferred_format_fn;
+
+        if( rec.is_static )
+        {
+            return;
+        }
+
+        if( nullptr != rec.deferred_format_fn )
+        {
+            m_current.deferred_visit_fn = rec.deferred_visit_fn;
+            m_current.deferred_size     = rec.deferred_size;
+            std::memcpy(
+                m_current.deferred_message, rec.deferred_message, rec.deferred_size );
+        }
+        else
+        {
+            m_current.message = std::move( rec.message );
+        }
+    }
+
+    std::size_t drain_lane( queue_t & queue, std::size_t max_records )
+    {
+        if constexpr( queue_t::producer_can_evict )
+        {
+            // A record is taken out of the slot before it goes to the backend,
+            // so the slot can be reused while the backend is busy.
+            std::size_t n = 0;
+            while( n < max_records
+                   && queue.try_pop(
+                       [ this ]( record_t & rec ) noexcept { take( rec ); } ) )
+            {
+                dispatch( m_current );
+                ++n;
+            }
+            return n;
+        }
+        else
+        {
+            return queue.drain( max_records, [ this ]( record_t & rec ) noexcept {
+                dispatch( rec );
+            } );
+        }
+    }
+
+    std::size_t drain( std::size_t max_records )
+    {
+        if constexpr( !has_priority_lane )
+        {
+            return drain_lane( m_queue, max_records );
+        }
+        else
+        {
+            // Priority lane goes first and it is checked again
+            // after each chunk of normal records.
+            std::size_t n = 0;
+            while( n < max_records )
+            {
+                n += drain_lane( m_priority_queue, max_records - n );
+
+                const auto normal = drain_lane(
+                    m_queue, std::min( priority_check_interval, max_records - n ) );
+                n += normal;
+
+                if( 0 == normal )
+                {
+                    break;
+                }
+            }
+            return n;
+        }
+    }
+
+    bool has_ready_record() const
+    {
+        if constexpr( has_priority_lane )
+        {
+            if( m_priority_queue.has_ready_record() )
+            {
+                return true;
+            }
+        }
+        return m_queue.has_ready_record();
+    }
+
+    void drain_all()
+    {
+        while( 0 != drain( drain_batch_size ) )
+        {
+        }
+    }
+
+    /**
+     * @brief Deliver all the records queued so far.
+     *
+     * A producer might have claimed a slot and not have published
+     * its record yet while the records after it are visible.
+     * So queues are drained till they reach the positions
+     * taken beforehand, waiting for such records.
+     */
+    void drain_queued()
+    {
+        const auto priority_pos = m_priority_queue.enqueue_position();
+        const auto pos          = m_queue.enqueue_position();
+
+        for( ;; )
+        {
+            drain_all();
+            if( m_queue.consumed( pos )
+                && m_priority_queue.consumed( priority_pos ) )
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void complete_flush( std::uint64_t ticket )
+    {
+        report_dropped();
+
+        try
+        {
+            m_backend.flush();
+        }
+        catch( ... )
+        {
+        }
+
+        {
+            std::lock_guard lock{ m_flush_mutex };
+            m_flush_completed.store( ticket, std::memory_order_release );
+        }
+        m_flush_cv.notify_all();
+    }
+
+    bool has_work() const
+    {
+        return has_ready_record()
+               || m_flush_requested.load( std::memory_order_acquire )
+                      != m_flush_completed.load( std::memory_order_relaxed )
+               || m_stopped.load( std::memory_order_acquire );
+    }
+
+    void consumer_loop()
+    {
+        for( ;; )
+        {
+            const auto handled = drain( drain_batch_size );
+            if( 0 != handled )
+            {
+                // Some slots were freed.
+                report_dropped();
+            }
+
+            const auto flush_ticket =
+                m_flush_requested.load( std::memory_order_acquire );
+            if( flush_ticket != m_flush_completed.load( std::memory_order_relaxed ) )
+            {
+                // Everything queued before the flush request
+                // is before the current enqueue positions.
+                drain_queued();
+                complete_flush( flush_ticket );
+            }
+
+            if( 0 != handled )
+            {
+                continue;
+            }
+
+            if( m_stopped.load( std::memory_order_acquire ) )
+            {
+                drain_queued();
+                complete_flush( m_flush_requested.load( std::memory_order_acquire ) );
+                return;
+            }
+
+            m_wait_strategy.wait( [ this ] { return has_work(); } );
+        }
+    }
+
+    // Consumer wake up routines.
+
+    void notify_consumer()
+    {
+        if constexpr( !async_traits_t::consumer_thread )
+        {
+            // Only the first message after a drain signals.
+            if( !m_notification_pending.exchange( true, std::memory_order_acq_rel ) )
+            {
+                signal_notification();
+            }
+            return;
+        }
+
+        m_wait_strategy.notify();
+    }
+
+    void wake_consumer() { m_wait_strategy.wake(); }
+
+    // Polling routines.
+
+    /**
+     * @brief Drain a batch on producer's thread when it waits
+     *        for a free slot and there is no consumer thread.
+     */
+    void help_drain()
+    {
+        std::unique_lock lock{ m_poll_mutex, std::try_to_lock };
+        if( lock.owns_lock() )
+        {
+            drain( poll_batch_size );
+            report_dropped();
+        }
+    }
+
+    void signal_notification() noexcept
+    {
+#if defined( __linux__ )
+        const std::uint64_t one = 1;
+        // Can fail only if the counter overflows which is not the case.
+        [[maybe_unused]] const auto rc = ::write( m_notify_fd, &one, sizeof( one ) );
+#endif
+    }
+
+    void clear_notification() noexcept
+    {
+#if defined( __linux__ )
+        std::uint64_t value;
+        [[maybe_unused]] const auto rc = ::read( m_notify_fd, &value, sizeof( value ) );
+#endif
+        // Messages queued before this point are drained by the caller,
+        // messages queued after it signal again.
+        m_notification_pending.exchange( false, std::memory_order_acq_rel );
+    }
+
+    backend_t m_backend;
+    queue_t m_queue;
+    queue_t m_priority_queue;
+
+    alignas( details::cache_line_size )
+        std::array< std::atomic< std::uint64_t >, levels_count > m_dropped{};
+    std::array< std::uint64_t, levels_count > m_reported_dropped{};
+
+    //! A record being delivered by the consumer.
+    record_t m_current;
+
+    typename async_traits_t::wait_strategy_t m_wait_strategy;
+    alignas( details::cache_line_size ) std::atomic< bool > m_stopped{ false };
+
+    std::atomic< std::uint64_t > m_flush_requested{ 0 };
+    std::atomic< std::uint64_t > m_flush_completed{ 0 };
+    std::mutex m_flush_mutex;
+    std::condition_variable m_flush_cv;
+
+    std::thread m_consumer;
+
+    //! Is the consumer thread running (it might fail to restart).
+    std::atomic< bool > m_consumer_running{ false };
+
+#if defined( __linux__ )
+    //! CPUs the consumer is pinned to (kept for a restarted consumer).
+    cpu_set_t m_consumer_cpus;
+    bool m_consumer_pinned{ false };
+#endif
+
+    // Polled mode data (the mutex also serializes draining
+    // by `log_flush()` when the consumer has failed to restart).
+    std::mutex m_poll_mutex;
+    std::atomic< bool > m_notification_pending{ false };
+    int m_notify_fd{ -1 };
+};
+
+} /* namespace logr */
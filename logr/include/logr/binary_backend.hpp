@@ -0,0 +1,964 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A backend writing messages in a compact binary form
+ * and a decoder rendering them back to text.
+ *
+ * File layout (all integers are LEB128 varints,
+ * signed ones are zigzag encoded):
+ * @code
+ * file      := "LOGRBIN" version(1 byte) record*
+ * record    := call_site | message
+ * call_site := 0x01 id level flags str(format) str(file) line
+ *              args_count arg_type(1 byte)* [catalog_id]
+ * message   := 0x02 id timestamp_delta arg*
+ * str       := size bytes
+ * @endcode
+ *
+ * A call site (format string, level and source location) is written once,
+ * messages refer to it by id and carry only a timestamp
+ * (nanoseconds since epoch, as a delta from the previous message)
+ * and argument values.
+ * A call site of a catalog message (see `catalog_message_t`)
+ * also has the message id of the catalog.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+namespace binary_log
+{
+
+//! File signature (followed by a version byte).
+inline constexpr std::string_view magic{ "LOGRBIN" };
+
+//! Current format version.
+inline constexpr std::uint8_t version = 2;
+
+//! The oldest format version decoder can read.
+inline constexpr std::uint8_t min_version = 1;
+
+//! Record tags.
+enum class record_type : std::uint8_t
+{
+    call_site = 1,
+    message   = 2
+};
+
+//! Call site flags.
+enum call_site_flags : std::uint8_t
+{
+    //! Format string is a literal text (no arguments, no formatting).
+    literal = 1,
+    //! Call site has a message catalog id (since version 2).
+    catalog = 2
+};
+
+//! Argument types.
+enum class arg_type : std::uint8_t
+{
+    //! Varint 0 or 1.
+    boolean = 1,
+    //! Varint.
+    character = 2,
+    //! Zigzag varint.
+    signed_int = 3,
+    //! Varint.
+    unsigned_int = 4,
+    //! 8 bytes of IEEE 754 double (little endian).
+    floating = 5,
+    //! Varint.
+    pointer = 6,
+    //! A string: varint size and bytes.
+    text = 7,
+    //! 4 bytes of IEEE 754 float (little endian).
+    single_floating = 8
+};
+
+inline void put_varint( std::string & out, std::uint64_t value )
+{
+    while( value >= 0x80 )
+    {
+        out.push_back( static_cast< char >( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.push_back( static_cast< char >( value ) );
+}
+
+inline std::uint64_t zigzag( std::int64_t value ) noexcept
+{
+    return ( static_cast< std::uint64_t >( value ) << 1 )
+           ^ static_cast< std::uint64_t >( value >> 63 );
+}
+
+inline std::int64_t unzigzag( std::uint64_t value ) noexcept
+{
+    return static_cast< std::int64_t >( value >> 1 )
+           ^ -static_cast< std::int64_t >( value & 1 );
+}
+
+inline void put_string( std::string & out, std::string_view str )
+{
+    put_varint( out, str.size() );
+    out.append( str.data(), str.size() );
+}
+
+inline void put_double( std::string & out, double value )
+{
+    std::uint64_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    for( int i = 0; i < 8; ++i )
+    {
+        out.push_back( static_cast< char >( bits >> ( 8 * i ) ) );
+    }
+}
+
+inline void put_float( std::string & out, float value )
+{
+    std::uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    for( int i = 0; i < 4; ++i )
+    {
+        out.push_back( static_cast< char >( bits >> ( 8 * i ) ) );
+    }
+}
+
+//
+// decoded_message_t
+//
+
+/**
+ * @brief A message read from a binary log.
+ */
+struct decoded_message_t
+{
+    log_message_level level{ log_message_level::nolog };
+
+    //! Capture time.
+    std::chrono::system_clock::time_point timestamp{};
+
+    //! Source file, empty if message has no source location.
+    std::string file;
+    int line{ 0 };
+
+    //! Rendered message text.
+    std::string text;
+
+    //! Message id if it is a catalog message.
+    std::optional< std::uint32_t > catalog_id;
+};
+
+//
+// decoder_t
+//
+
+/**
+ * @brief Read a binary log written by `binary_logger_t`.
+ *
+ * @code{.cpp}
+ * std::ifstream in{ "app.binlog", std::ios::binary };
+ * logr::binary_log::decoder_t decoder{ in };
+ * logr::binary_log::decoded_message_t msg;
+ * while( decoder.next( msg ) )
+ * {
+ *     std::cout << msg.text << '\n';
+ * }
+ * @endcode
+ *
+ * Throws `std::runtime_error` if data is malformed.
+ */
+class decoder_t
+{
+public:
+    //! Max size of a string, a larger one means data is malformed.
+    static constexpr std::uint64_t max_string_size = std::uint64_t{ 1 } << 30;
+
+    //! Max number of arguments of a call site.
+    static constexpr std::uint64_t max_args_count = 1024;
+
+    explicit decoder_t( std::istream & input )
+        : m_input{ input }
+    {
+        char header[ magic.size() + 1 ];
+        if( !m_input.read( header, sizeof( header ) )
+            || magic != std::string_view{ header, magic.size() } )
+        {
+            throw std::runtime_error{ "not a logr binary log" };
+        }
+
+        const auto file_version =
+            static_cast< std::uint8_t >( header[ magic.size() ] );
+        if( file_version < min_version || version < file_version )
+        {
+            throw std::runtime_error{ "unsupported logr binary log version" };
+        }
+    }
+
+    /**
+     * @brief Read the next message.
+     *
+     * @return False if the end of the log is reached.
+     */
+    bool next( decoded_message_t & msg )
+    {
+        for( ;; )
+        {
+            const auto tag = m_input.get();
+            if( std::istream::traits_type::eof() == tag )
+            {
+                return false;
+            }
+
+            switch( static_cast< record_type >( tag ) )
+            {
+                case record_type::call_site:
+                    read_call_site();
+                    break;
+
+                case record_type::message:
+                    read_message( msg );
+                    return true;
+
+                default:
+                    throw std::runtime_error{ "unknown record type" };
+            }
+        }
+    }
+
+private:
+    struct call_site_t
+    {
+        log_message_level level;
+        std::uint8_t flags;
+        std::string format;
+        std::string file;
+        int line;
+        std::vector< arg_type > args;
+        std::optional< std::uint32_t > catalog_id;
+    };
+
+    std::uint8_t get_byte()
+    {
+        const auto c = m_input.get();
+        if( std::istream::traits_type::eof() == c )
+        {
+            throw std::runtime_error{ "unexpected end of binary log" };
+        }
+        return static_cast< std::uint8_t >( c );
+    }
+
+    std::uint64_t get_varint()
+    {
+        std::uint64_t value = 0;
+        for( int shift = 0; shift < 64; shift += 7 )
+        {
+            const auto b = get_byte();
+            value |= static_cast< std::uint64_t >( b & 0x7F ) << shift;
+            if( 0 == ( b & 0x80 ) )
+            {
+                return value;
+            }
+        }
+        throw std::runtime_error{ "malformed varint" };
+    }
+
+    std::string get_string()
+    {
+        const auto size = get_varint();
+        if( size > max_string_size )
+        {
+            throw std::runtime_error{ "string is too long" };
+        }
+
+        // Read by chunks, so a malformed size doesn't make
+        // the string much bigger than the data left.
+        constexpr std::size_t chunk_size = 64 * 1024;
+
+        std::string str;
+        while( str.size() < size )
+        {
+            const auto offset = str.size();
+            const auto n      = std::min< std::size_t >(
+                chunk_size, static_cast< std::size_t >( size ) - offset );
+            str.resize( offset + n );
+            if( !m_input.read( str.data() + offset,
+                               static_cast< std::streamsize >( n ) ) )
+            {
+                throw std::runtime_error{ "unexpected end of binary log" };
+            }
+        }
+        return str;
+    }
+
+    double get_double()
+    {
+        std::uint64_t bits = 0;
+        for( int i = 0; i < 8; ++i )
+        {
+            bits |= static_cast< std::uint64_t >( get_byte() ) << ( 8 * i );
+        }
+        double value;
+        std::memcpy( &value, &bits, sizeof( value ) );
+        return value;
+    }
+
+    float get_float()
+    {
+        std::uint32_t bits = 0;
+        for( int i = 0; i < 4; ++i )
+        {
+            bits |= static_cast< std::uint32_t >( get_byte() ) << ( 8 * i );
+        }
+        float value;
+        std::memcpy( &value, &bits, sizeof( value ) );
+        return value;
+    }
+
+    void read_call_site()
+    {
+        const auto id = get_varint();
+
+        call_site_t site;
+        const auto level = get_byte();
+        if( level >= static_cast< std::uint8_t >( log_message_level::nolog ) )
+        {
+            throw std::runtime_error{ "bad message level" };
+        }
+        site.level  = static_cast< log_message_level >( level );
+        site.flags  = get_byte();
+        site.format = get_string();
+        site.file   = get_string();
+        site.line   = static_cast< int >( unzigzag( get_varint() ) );
+
+        const auto args_count = get_varint();
+        if( args_count > max_args_count )
+        {
+            throw std::runtime_error{ "too many arguments" };
+        }
+        site.args.reserve( static_cast< std::size_t >( args_count ) );
+        for( std::uint64_t i = 0; i < args_count; ++i )
+        {
+            site.args.push_back( static_cast< arg_type >( get_byte() ) );
+        }
+
+        if( 0 != ( site.flags & catalog ) )
+        {
+            site.catalog_id = static_cast< std::uint32_t >( get_varint() );
+        }
+
+        m_call_sites[ id ] = std::move( site );
+    }
+
+    void read_message( decoded_message_t & msg )
+    {
+        const auto it = m_call_sites.find( get_varint() );
+        if( m_call_sites.end() == it )
+        {
+            throw std::runtime_error{ "unknown call site" };
+        }
+        const auto & site = it->second;
+
+        m_timestamp += unzigzag( get_varint() );
+
+        msg.level     = site.level;
+        msg.timestamp = std::chrono::system_clock::time_point{
+            std::chrono::duration_cast< std::chrono::system_clock::duration >(
+                std::chrono::nanoseconds{ m_timestamp } )
+        };
+        msg.file       = site.file;
+        msg.line       = site.line;
+        msg.catalog_id = site.catalog_id;
+
+        if( 0 != ( site.flags & literal ) )
+        {
+            msg.text = site.format;
+            return;
+        }
+
+        ::fmt::dynamic_format_arg_store< ::fmt::format_context > args;
+        for( const auto type : site.args )
+        {
+            switch( type )
+            {
+                case arg_type::boolean:
+                    args.push_back( 0 != get_varint() );
+                    break;
+                case arg_type::character:
+                    args.push_back( static_cast< char >( get_varint() ) );
+                    break;
+                case arg_type::signed_int:
+                    args.push_back( unzigzag( get_varint() ) );
+                    break;
+                case arg_type::unsigned_int:
+                    args.push_back( get_varint() );
+                    break;
+                case arg_type::floating:
+                    args.push_back( get_double() );
+                    break;
+                case arg_type::single_floating:
+                    args.push_back( get_float() );
+                    break;
+                case arg_type::pointer:
+                    args.push_back( reinterpret_cast< const void * >(
+                        static_cast< std::uintptr_t >( get_varint() ) ) );
+                    break;
+                case arg_type::text:
+                    args.push_back( get_string() );
+                    break;
+                default:
+                    throw std::runtime_error{ "unknown argument type" };
+            }
+        }
+
+        msg.text = ::fmt::vformat( site.format, args );
+    }
+
+    std::istream & m_input;
+    std::unordered_map< std::uint64_t, call_site_t > m_call_sites;
+    std::int64_t m_timestamp{ 0 };
+};
+
+}  // namespace binary_log
+
+//
+// binary_logger_t
+//
+
+/**
+ * @brief A logger writing messages in a binary form
+ *        (see `binary_log::decoder_t` and `logr_binlog_decode` tool).
+ *
+ * Deferred messages (see `deferred_format()`) are not formatted:
+ * their call site is registered once and each message writes only
+ * the call site id, a timestamp and raw argument values.
+ * Arithmetic, char and pointer arguments are written as numbers,
+ * other argument types are rendered with "{}" and written as text,
+ * so format specs of such arguments must apply to strings.
+ * Static messages (`_static` literals) are written as a call site id
+ * and a timestamp, other text messages are written as a text argument.
+ * Catalog messages (see `catalog_message_t`) are deferred messages
+ * whose call site keeps the message id.
+ *
+ * Works behind `async_logger_t` as well,
+ * which passes deferred messages to the backend as is.
+ *
+ * @code{.cpp}
+ * std::ofstream out{ "app.binlog", std::ios::binary };
+ * logr::binary_logger_t<> logger{ out, logr::log_message_level::info };
+ *
+ * logger.info( LOGR_SRC_LOCATION,
+ *              logr::deferred_format( "Order {} filled at {}", id, price ) );
+ * @endcode
+ *
+ * @tparam Logger_Traits  Traits of the logger (must use char).
+ */
+template < typename Logger_Traits = basic_logger_traits_t< 1024 > >
+class binary_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+    using deferred_message_view_t =
+        typename base_type_t::deferred_message_view_t;
+    using static_message_t = typename base_type_t::static_message_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "Binary logger supports only char messages" );
+
+    /**
+     * @brief Create a logger and write a file header.
+     *
+     * @param output  A stream to write to (must be opened in binary mode).
+     * @param level   Log level of the logger.
+     */
+    explicit binary_logger_t( std::ostream & output,
+                              log_message_level level = log_message_level::info )
+        : base_type_t{ level }
+        , m_output{ output }
+    {
+        m_buf.append( binary_log::magic.data(), binary_log::magic.size() );
+        m_buf.push_back( static_cast< char >( binary_log::version ) );
+        write_buf();
+    }
+
+private:
+    /**
+     * @brief A call site key: format string (by address) with
+     *        a set of argument types, level and source location.
+     */
+    struct call_site_key_t
+    {
+        const char * format;
+        std::size_t format_size;
+        typename deferred_message_view_t::visit_fn_t visit_fn;
+        log_message_level level;
+        const char * file;
+        int line;
+
+        bool operator==( const call_site_key_t & other ) const noexcept
+        {
+            return format == other.format && format_size == other.format_size
+                   && visit_fn == other.visit_fn && level == other.level
+                   && file == other.file && line == other.line;
+        }
+    };
+
+    struct call_site_key_hash_t
+    {
+        std::size_t operator()( const call_site_key_t & key ) const noexcept
+        {
+            auto h = std::hash< const void * >{}( key.format );
+            h = h * 31 + std::hash< const void * >{}( key.file );
+            h = h * 31 + static_cast< std::size_t >( key.line );
+            return h * 31 + static_cast< std::size_t >( key.level );
+        }
+    };
+
+    /**
+     * @brief Writes argument values to a message record
+     *        and collects their types.
+     */
+    class encoder_t final : public basic_deferred_arg_visitor_t< char >
+    {
+    public:
+        encoder_t( std::string & values, std::string & types ) noexcept
+            : m_values{ values }
+            , m_types{ types }
+        {
+        }
+
+        void on_format( string_view_t format ) override { m_format = format; }
+
+        void on_bool( bool value ) override
+        {
+            add( binary_log::arg_type::boolean );
+            binary_log::put_varint( m_values, value ? 1 : 0 );
+        }
+
+        void on_char( char value ) override
+        {
+            add( binary_log::arg_type::character );
+            binary_log::put_varint( m_values, static_cast< unsigned char >( value ) );
+        }
+
+        void on_int( std::int64_t value ) override
+        {
+            add( binary_log::arg_type::signed_int );
+            binary_log::put_varint( m_values, binary_log::zigzag( value ) );
+        }
+
+        void on_uint( std::uint64_t value ) override
+        {
+            add( binary_log::arg_type::unsigned_int );
+            binary_log::put_varint( m_values, value );
+        }
+
+        void on_double( double value ) override
+        {
+            add( binary_log::arg_type::floating );
+            binary_log::put_double( m_values, value );
+        }
+
+        void on_float( float value ) override
+        {
+            add( binary_log::arg_type::single_floating );
+            binary_log::put_float( m_values, value );
+        }
+
+        void on_pointer( const void * value ) override
+        {
+            add( binary_log::arg_type::pointer );
+            binary_log::put_varint(
+                m_values, reinterpret_cast< std::uintptr_t >( value ) );
+        }
+
+        void on_text( string_view_t value ) override
+        {
+            add( binary_log::arg_type::text );
+            binary_log::put_string( m_values, value );
+        }
+
+        void on_catalog_id( std::uint32_t id ) override { m_catalog_id = id; }
+
+        string_view_t format() const noexcept { return m_format; }
+
+        //! Catalog id of the message (if any).
+        const std::optional< std::uint32_t > & catalog_id() const noexcept
+        {
+            return m_catalog_id;
+        }
+
+    private:
+        void add( binary_log::arg_type type )
+        {
+            m_types.push_back( static_cast< char >( type ) );
+        }
+
+        std::string & m_values;
+        std::string & m_types;
+        string_view_t m_format;
+        std::optional< std::uint32_t > m_catalog_id;
+    };
+
+    //! A format for text messages: a single text argument.
+    static constexpr std::string_view text_format{ "{}" };
+
+    /**
+     * @brief Write a call site if it is new and a message header.
+     *
+     * Must be called under the lock.
+     */
+    void begin_message( const call_site_key_t & key,
+                        std::uint8_t flags,
+                        std::string_view format,
+                        std::string_view arg_types,
+                        std::uint32_t catalog_id = 0 )
+    {
+        auto it = m_call_sites.find( key );
+        if( m_call_sites.end() == it )
+        {
+            const auto id = m_call_sites.size();
+            it            = m_call_sites.emplace( key, id ).first;
+
+            m_buf.push_back( static_cast< char >( binary_log::record_type::call_site ) );
+            binary_log::put_varint( m_buf, id );
+            m_buf.push_back( static_cast< char >( key.level ) );
+            m_buf.push_back( static_cast< char >( flags ) );
+            binary_log::put_string( m_buf, format );
+            binary_log::put_string(
+                m_buf, nullptr != key.file ? std::string_view{ key.file } : "" );
+            binary_log::put_varint( m_buf, binary_log::zigzag( key.line ) );
+            binary_log::put_string( m_buf, arg_types );
+            if( 0 != ( flags & binary_log::catalog ) )
+            {
+                binary_log::put_varint( m_buf, catalog_id );
+            }
+        }
+
+        const auto now = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                             std::chrono::system_clock::now().time_since_epoch() )
+                             .count();
+
+        m_buf.push_back( static_cast< char >( binary_log::record_type::message ) );
+        binary_log::put_varint( m_buf, it->second );
+        binary_log::put_varint( m_buf, binary_log::zigzag( now - m_last_timestamp ) );
+        m_last_timestamp = now;
+    }
+
+    void write_buf()
+    {
+        m_output.write( m_buf.data(), static_cast< std::streamsize >( m_buf.size() ) );
+        m_buf.clear();
+    }
+
+    static call_site_key_t make_key( const char * format,
+                                     std::size_t format_size,
+                                     log_message_level level,
+                                     const src_location_t * src_location )
+    {
+        return call_site_key_t{
+            format,
+            format_size,
+            nullptr,
+            level,
+            nullptr != src_location ? src_location->file : nullptr,
+            nullptr != src_location ? src_location->line : 0
+        };
+    }
+
+    void write_text( log_message_level level,
+                     const src_location_t * src_location,
+                     string_view_t message )
+    {
+        const char types[] = { static_cast< char >( binary_log::arg_type::text ) };
+
+        std::lock_guard lock{ m_mutex };
+        begin_message(
+            make_key( text_format.data(), text_format.size(), level, src_location ),
+            0,
+            text_format,
+            std::string_view{ types, sizeof( types ) } );
+        binary_log::put_string( m_buf, message );
+        write_buf();
+    }
+
+    void write_static( log_message_level level,
+                       const src_location_t * src_location,
+                       static_message_t message )
+    {
+        std::lock_guard lock{ m_mutex };
+        begin_message( make_key( message.data(), message.size(), level, src_location ),
+                       binary_log::literal,
+                       message.view(),
+                       {} );
+        write_buf();
+    }
+
+    void write_deferred( log_message_level level,
+                         const src_location_t * src_location,
+                         deferred_message_view_t message )
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_values.clear();
+        m_arg_types.clear();
+        encoder_t encoder{ m_values, m_arg_types };
+        message.visit( encoder );
+
+        const auto format = encoder.format();
+        auto key = make_key( format.data(), format.size(), level, src_location );
+        key.visit_fn = message.visit_fn();
+
+        const auto & catalog_id = encoder.catalog_id();
+        begin_message( key,
+                       catalog_id ? binary_log::catalog : 0,
+                       format,
+                       m_arg_types,
+                       catalog_id.value_or( 0 ) );
+        m_buf.append( m_values );
+        write_buf();
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_text( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_text( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_text( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_text( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_text( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_text( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_text( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_text( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_text( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_text( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_text( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_text( log_message_level::critical, &src_location, message );
+    }
+
+    void log_static_message_trace( static_message_t message ) override
+    {
+        write_static( log_message_level::trace, nullptr, message );
+    }
+
+    void log_static_message_trace( src_location_t src_location,
+                                   static_message_t message ) override
+    {
+        write_static( log_message_level::trace, &src_location, message );
+    }
+
+    void log_static_message_debug( static_message_t message ) override
+    {
+        write_static( log_message_level::debug, nullptr, message );
+    }
+
+    void log_static_message_debug( src_location_t src_location,
+                                   static_message_t message ) override
+    {
+        write_static( log_message_level::debug, &src_location, message );
+    }
+
+    void log_static_message_info( static_message_t message ) override
+    {
+        write_static( log_message_level::info, nullptr, message );
+    }
+
+    void log_static_message_info( src_location_t src_location,
+                                  static_message_t message ) override
+    {
+        write_static( log_message_level::info, &src_location, message );
+    }
+
+    void log_static_message_warn( static_message_t message ) override
+    {
+        write_static( log_message_level::warn, nullptr, message );
+    }
+
+    void log_static_message_warn( src_location_t src_location,
+                                  static_message_t message ) override
+    {
+        write_static( log_message_level::warn, &src_location, message );
+    }
+
+    void log_static_message_error( static_message_t message ) override
+    {
+        write_static( log_message_level::error, nullptr, message );
+    }
+
+    void log_static_message_error( src_location_t src_location,
+                                   static_message_t message ) override
+    {
+        write_static( log_message_level::error, &src_location, message );
+    }
+
+    void log_static_message_critical( static_message_t message ) override
+    {
+        write_static( log_message_level::critical, nullptr, message );
+    }
+
+    void log_static_message_critical( src_location_t src_location,
+                                      static_message_t message ) override
+    {
+        write_static( log_message_level::critical, &src_location, message );
+    }
+
+    void log_deferred_message_trace( deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::trace, nullptr, message );
+    }
+
+    void log_deferred_message_trace( src_location_t src_location,
+                                     deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::trace, &src_location, message );
+    }
+
+    void log_deferred_message_debug( deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::debug, nullptr, message );
+    }
+
+    void log_deferred_message_debug( src_location_t src_location,
+                                     deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::debug, &src_location, message );
+    }
+
+    void log_deferred_message_info( deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::info, nullptr, message );
+    }
+
+    void log_deferred_message_info( src_location_t src_location,
+                                    deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::info, &src_location, message );
+    }
+
+    void log_deferred_message_warn( deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::warn, nullptr, message );
+    }
+
+    void log_deferred_message_warn( src_location_t src_location,
+                                    deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::warn, &src_location, message );
+    }
+
+    void log_deferred_message_error( deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::error, nullptr, message );
+    }
+
+    void log_deferred_message_error( src_location_t src_location,
+                                     deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::error, &src_location, message );
+    }
+
+    void log_deferred_message_critical( deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::critical, nullptr, message );
+    }
+
+    void log_deferred_message_critical( src_location_t src_location,
+                                        deferred_message_view_t message ) override
+    {
+        write_deferred( log_message_level::critical, &src_location, message );
+    }
+
+    void log_flush() override
+    {
+        std::lock_guard lock{ m_mutex };
+        m_output.flush();
+    }
+
+    std::ostream & m_output;
+
+    std::mutex m_mutex;
+    std::unordered_map< call_site_key_t, std::uint64_t, call_site_key_hash_t >
+        m_call_sites;
+    std::int64_t m_last_timestamp{ 0 };
+
+    // Buffers reused for each message.
+    std::string m_buf;
+    std::string m_values;
+    std::string m_arg_types;
+};
+
+} /* namespace logr */
@@ -0,0 +1,369 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * Hierarchical logging categories with inherited levels.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+class category_registry_t;
+
+//
+// category_t
+//
+
+/**
+ * @brief A node of categories tree.
+ *
+ * A category is named with a dotted name (e.g. "net.http.client")
+ * and a category "net.http" is its parent. The root category
+ * has an empty name.
+ *
+ * A category either has its own level or inherits the level
+ * of its parent. Effective level is kept in a cache line sized cell,
+ * so loggers bound to a category check it with a single load
+ * which doesn't share cache line with anything else.
+ *
+ * Categories are created by @c category_registry_t and
+ * live till the end of program.
+ */
+class category_t
+{
+    static constexpr std::size_t cache_line_size = 64;
+
+public:
+    category_t( const category_t & ) = delete;
+    category_t & operator=( const category_t & ) = delete;
+
+    const std::string & name() const noexcept { return m_name; }
+
+    //! Parent category (null for the root one).
+    const category_t * parent() const noexcept { return m_parent; }
+
+    //! Effective level of category.
+    log_message_level log_level() const noexcept
+    {
+        return m_level_cell.level.load( std::memory_order_relaxed );
+    }
+
+    //! Level cell to be cached by loggers.
+    const std::atomic< log_message_level > & level_cell() const noexcept
+    {
+        return m_level_cell.level;
+    }
+
+    //! Whether category has its own level (otherwise it is inherited).
+    bool has_own_level() const noexcept { return m_has_own_level; }
+
+    //! Registry the category belongs to.
+    category_registry_t & registry() const noexcept { return m_registry; }
+
+private:
+    friend class category_registry_t;
+
+    category_t( category_registry_t & registry,
+                std::string name,
+                category_t * parent,
+                log_message_level level )
+        : m_registry{ registry }
+        , m_name{ std::move( name ) }
+        , m_parent{ parent }
+    {
+        m_level_cell.level.store( level, std::memory_order_relaxed );
+    }
+
+    struct alignas( cache_line_size ) level_cell_t
+    {
+        std::atomic< log_message_level > level;
+    };
+
+    category_registry_t & m_registry;
+    const std::string m_name;
+    category_t * const m_parent;
+
+    // Guarded by registry mutex.
+    std::vector< category_t * > m_children;
+    bool m_has_own_level{ false };
+
+    level_cell_t m_level_cell;
+};
+
+//
+// category_registry_t
+//
+
+/**
+ * @brief A registry of logging categories.
+ *
+ * Setting a level of a category changes the effective level
+ * of the category and of all its descendants
+ * having no own level.
+ *
+ * @code
+ * auto & registry = logr::category_registry_t::instance();
+ * logger.log_level_driver().bind( registry.category( "net.http" ) );
+ *
+ * // Enables debug messages of all "net" components.
+ * registry.log_level( "net.*", logr::log_message_level::debug );
+ * @endcode
+ */
+class category_registry_t
+{
+public:
+    explicit category_registry_t(
+        log_message_level root_level = log_message_level::info )
+    {
+        m_root = &create( "", nullptr, root_level );
+        m_root->m_has_own_level = true;
+    }
+
+    category_registry_t( const category_registry_t & ) = delete;
+    category_registry_t & operator=( const category_registry_t & ) = delete;
+
+    //! Get a global instance of registry.
+    static category_registry_t & instance()
+    {
+        static category_registry_t registry;
+        return registry;
+    }
+
+    //! Get the root category.
+    category_t & root() noexcept { return *m_root; }
+
+    /**
+     * @brief Get a category with a given name.
+     *
+     * Category and its missing ancestors are created
+     * if necessary inheriting the level of the nearest existing one.
+     * A trailing ".*" is ignored, so "net.*" is the same as "net".
+     */
+    category_t & category( std::string_view name )
+    {
+        std::lock_guard lock{ m_mutex };
+        return get( normalize( name ) );
+    }
+
+    //! Set own level of a category.
+    void log_level( std::string_view name, log_message_level level )
+    {
+        std::lock_guard lock{ m_mutex };
+        set_level( get( normalize( name ) ), level );
+    }
+
+    //! Set own level of a category.
+    void log_level( category_t & category, log_message_level level )
+    {
+        std::lock_guard lock{ m_mutex };
+        set_level( category, level );
+    }
+
+    /**
+     * @brief Make category inherit the level of its parent.
+     *
+     * The level of the root category cannot be reset.
+     */
+    void reset_log_level( std::string_view name )
+    {
+        std::lock_guard lock{ m_mutex };
+        auto & category = get( normalize( name ) );
+        if( category.m_parent )
+        {
+            category.m_has_own_level = false;
+            propagate( category, category.m_parent->log_level() );
+        }
+    }
+
+    /**
+     * @brief Run a given function for each category.
+     *
+     * Categories are visited in the order of their names.
+     *
+     * @param func  A function accepting `const category_t &`.
+     */
+    template < typename Func >
+    void for_each( Func && func ) const
+    {
+        std::lock_guard lock{ m_mutex };
+        for( const auto & [ name, category ] : m_categories )
+        {
+            func( static_cast< const category_t & >( *category ) );
+        }
+    }
+
+private:
+    static std::string_view normalize( std::string_view name ) noexcept
+    {
+        if( name == "*" )
+        {
+            return {};
+        }
+
+        if( 2 <= name.size() && name.substr( name.size() - 2 ) == ".*" )
+        {
+            name.remove_suffix( 2 );
+        }
+        return name;
+    }
+
+    category_t & create( std::string_view name,
+                         category_t * parent,
+                         log_message_level level )
+    {
+        std::unique_ptr< category_t > category{
+            new category_t{ *this, std::string{ name }, parent, level }
+        };
+        auto * result = category.get();
+        m_categories.emplace( result->name(), std::move( category ) );
+        if( parent )
+        {
+            parent->m_children.push_back( result );
+        }
+        return *result;
+    }
+
+    category_t & get( std::string_view name )
+    {
+        if( name.empty() )
+        {
+            return *m_root;
+        }
+
+        if( auto it = m_categories.find( name ); it != m_categories.end() )
+        {
+            return *it->second;
+        }
+
+        const auto dot = name.rfind( '.' );
+        auto & parent =
+            get( dot == std::string_view::npos ? std::string_view{}
+                                               : name.substr( 0, dot ) );
+        return create( name, &parent, parent.log_level() );
+    }
+
+    static void set_level( category_t & category, log_message_level level )
+    {
+        category.m_has_own_level = true;
+        propagate( category, level );
+    }
+
+    //! Update effective level of a category and its inheriting descendants.
+    static void propagate( category_t & category, log_message_level level )
+    {
+        category.m_level_cell.level.store( level, std::memory_order_relaxed );
+        for( auto * child : category.m_children )
+        {
+            if( !child->m_has_own_level )
+            {
+                propagate( *child, level );
+            }
+        }
+    }
+
+    mutable std::mutex m_mutex;
+
+    std::map< std::string, std::unique_ptr< category_t >, std::less<> >
+        m_categories;
+
+    category_t * m_root;
+};
+
+//
+// category_log_level_driver_t
+//
+
+/**
+ * @brief A log level driver taking level from a category.
+ *
+ * Until bound to a category the driver keeps its own level
+ * (as @c mt_log_level_driver_t does). Once bound it holds a pointer
+ * to category level cell and setting a logger level
+ * sets the level of the category.
+ *
+ * @code
+ * using traits_t = logr::basic_logger_traits_t<
+ *     1024, char, std::allocator< char >,
+ *     logr::category_log_level_driver_t >;
+ *
+ * logr::file_logger_t< traits_t > logger{ "net.log" };
+ * logger.log_level_driver().bind(
+ *     logr::category_registry_t::instance().category( "net.http" ) );
+ * @endcode
+ *
+ * @note Binding is not thread safe with logging, a logger
+ *       should be bound before it is shared with other threads.
+ */
+class category_log_level_driver_t final
+{
+public:
+    explicit category_log_level_driver_t( log_message_level level ) noexcept
+        : m_own_level{ level }
+    {
+    }
+
+    category_log_level_driver_t( const category_log_level_driver_t & ) = delete;
+    category_log_level_driver_t & operator=(
+        const category_log_level_driver_t & ) = delete;
+
+    log_message_level log_level() const noexcept
+    {
+        return m_level->load( std::memory_order_relaxed );
+    }
+
+    /**
+     * @brief Set level of logger.
+     *
+     * Not noexcept: setting the level of a bound category
+     * locks the registry mutex.
+     */
+    void log_level( log_message_level new_log_level )
+    {
+        if( m_category )
+        {
+            m_category->registry().log_level( *m_category, new_log_level );
+        }
+        else
+        {
+            m_own_level.store( new_log_level, std::memory_order_relaxed );
+        }
+    }
+
+    //! Take level from a given category.
+    void bind( category_t & category ) noexcept
+    {
+        m_category = &category;
+        m_level    = &category.level_cell();
+    }
+
+    //! Category the driver is bound to (if any).
+    const category_t * category() const noexcept { return m_category; }
+
+private:
+    std::atomic< log_message_level > m_own_level;
+
+    //! Category level cell or own level.
+    const std::atomic< log_message_level > * m_level{ &m_own_level };
+
+    category_t * m_category{ nullptr };
+};
+
+} /* namespace logr */
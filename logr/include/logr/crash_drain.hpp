@@ -0,0 +1,451 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * Crash and fork handling for loggers holding pending messages
+ * (see `async_logger_t`).
+ *
+ * @code{.cpp}
+ * // Once at startup:
+ * logr::install_crash_drain( STDERR_FILENO );
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#    include <pthread.h>
+#    include <signal.h>
+#    include <unistd.h>
+#endif
+
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+//
+// crash_drainable_t
+//
+
+/**
+ * @brief An interface of a logger that holds messages not yet
+ *        passed to its backend, or needs care around `fork()`.
+ *
+ * Instances register themselves with `crash_drain_registry()`.
+ */
+class crash_drainable_t
+{
+public:
+    /**
+     * @brief Write pending messages to a given file descriptor.
+     *
+     * Called from a signal handler, so must be async-signal-safe:
+     * no locks, no allocations, only `write(2)`.
+     */
+    virtual void crash_drain( int fd ) noexcept = 0;
+
+    //! Called in the parent before `fork()`.
+    virtual void fork_prepare() noexcept = 0;
+
+    //! Called in the parent after `fork()`.
+    virtual void fork_parent() noexcept = 0;
+
+    //! Called in the child after `fork()`.
+    virtual void fork_child() noexcept = 0;
+
+protected:
+    ~crash_drainable_t() = default;
+};
+
+namespace details
+{
+
+//
+// crash_drain_registry_t
+//
+
+/**
+ * @brief A list of registered loggers.
+ *
+ * Loggers are kept in chunks of atomics, chunks are linked
+ * and never freed till the registry is destroyed,
+ * so a signal handler can walk the list without locking.
+ * Another chunk is added once all the slots are taken.
+ */
+class crash_drain_registry_t
+{
+public:
+    //! Number of loggers a chunk holds.
+    static constexpr std::size_t chunk_size = 64;
+
+    crash_drain_registry_t() = default;
+
+    ~crash_drain_registry_t()
+    {
+        auto * chunk = m_head.next.load( std::memory_order_relaxed );
+        while( nullptr != chunk )
+        {
+            std::unique_ptr< chunk_t > c{ chunk };
+            chunk = c->next.load( std::memory_order_relaxed );
+        }
+    }
+
+    crash_drain_registry_t( const crash_drain_registry_t & ) = delete;
+    crash_drain_registry_t & operator=( const crash_drain_registry_t & ) =
+        delete;
+
+    /**
+     * @brief Register a logger.
+     *
+     * @throw std::bad_alloc if another chunk can't be allocated.
+     */
+    void add( crash_drainable_t * entry )
+    {
+        std::lock_guard lock{ m_mutex };
+
+        chunk_t * last = &m_head;
+        for( ;; )
+        {
+            for( auto & e : last->entries )
+            {
+                if( nullptr == e.load( std::memory_order_relaxed ) )
+                {
+                    e.store( entry, std::memory_order_release );
+                    return;
+                }
+            }
+
+            auto * next = last->next.load( std::memory_order_relaxed );
+            if( nullptr == next )
+            {
+                break;
+            }
+            last = next;
+        }
+
+        auto chunk = std::make_unique< chunk_t >();
+        chunk->entries[ 0 ].store( entry, std::memory_order_relaxed );
+        last->next.store( chunk.release(), std::memory_order_release );
+    }
+
+    /**
+     * @brief Unregister a logger.
+     */
+    void remove( crash_drainable_t * entry )
+    {
+        std::lock_guard lock{ m_mutex };
+        for_each_slot( [ entry ]( std::atomic< crash_drainable_t * > & e ) {
+            if( entry == e.load( std::memory_order_relaxed ) )
+            {
+                e.store( nullptr, std::memory_order_release );
+            }
+        } );
+    }
+
+    /**
+     * @brief Drain all registered loggers (async-signal-safe).
+     */
+    void crash_drain( int fd ) noexcept
+    {
+        for_each( [ fd ]( crash_drainable_t & e ) { e.crash_drain( fd ); } );
+    }
+
+    void fork_prepare() noexcept
+    {
+        // Stays locked until fork is over, so loggers
+        // are neither created nor destroyed meanwhile.
+        m_mutex.lock();
+        for_each( []( crash_drainable_t & e ) { e.fork_prepare(); } );
+    }
+
+    void fork_parent() noexcept
+    {
+        for_each( []( crash_drainable_t & e ) { e.fork_parent(); } );
+        m_mutex.unlock();
+    }
+
+    void fork_child() noexcept
+    {
+        for_each( []( crash_drainable_t & e ) { e.fork_child(); } );
+        m_mutex.unlock();
+    }
+
+    //! A file descriptor pending messages are written to on crash.
+    std::atomic< int > crash_fd{ 2 };
+
+private:
+    struct chunk_t
+    {
+        std::array< std::atomic< crash_drainable_t * >, chunk_size > entries{};
+        std::atomic< chunk_t * > next{ nullptr };
+    };
+
+    template < typename F >
+    void for_each_slot( F && f ) noexcept
+    {
+        chunk_t * chunk = &m_head;
+        while( nullptr != chunk )
+        {
+            for( auto & e : chunk->entries )
+            {
+                f( e );
+            }
+            chunk = chunk->next.load( std::memory_order_acquire );
+        }
+    }
+
+    template < typename F >
+    void for_each( F && f ) noexcept
+    {
+        for_each_slot( [ &f ]( std::atomic< crash_drainable_t * > & e ) {
+            if( auto * entry = e.load( std::memory_order_acquire ); nullptr != entry )
+            {
+                f( *entry );
+            }
+        } );
+    }
+
+    std::mutex m_mutex;
+    chunk_t m_head;
+};
+
+/**
+ * @brief Write the whole buffer with `write(2)` (async-signal-safe).
+ */
+inline void crash_write( int fd, std::string_view text ) noexcept
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    while( !text.empty() )
+    {
+        const auto rc = ::write( fd, text.data(), text.size() );
+        if( rc <= 0 )
+        {
+            return;
+        }
+        text.remove_prefix( static_cast< std::size_t >( rc ) );
+    }
+#else
+    static_cast< void >( fd );
+    static_cast< void >( text );
+#endif
+}
+
+/**
+ * @brief Get a name of the level to prefix drained messages.
+ */
+constexpr std::string_view crash_level_name( log_message_level level ) noexcept
+{
+    switch( level )
+    {
+        case log_message_level::trace:
+            return "[trace] ";
+        case log_message_level::debug:
+            return "[debug] ";
+        case log_message_level::info:
+            return "[info] ";
+        case log_message_level::warn:
+            return "[warn] ";
+        case log_message_level::error:
+            return "[error] ";
+        case log_message_level::critical:
+            return "[critical] ";
+        case log_message_level::nolog:
+            break;
+    }
+    return "";
+}
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+
+//! Signals crash drain handles.
+inline constexpr std::array< int, 5 > crash_signals{
+    SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT
+};
+
+/**
+ * @brief Actions that were set before crash drain handlers.
+ */
+inline std::array< struct sigaction, crash_signals.size() > &
+previous_crash_actions() noexcept
+{
+    static std::array< struct sigaction, crash_signals.size() > actions{};
+    return actions;
+}
+
+#endif
+
+}  // namespace details
+
+/**
+ * @brief Get the registry of loggers with pending messages.
+ */
+inline details::crash_drain_registry_t & crash_drain_registry() noexcept
+{
+    static details::crash_drain_registry_t registry;
+    return registry;
+}
+
+namespace details
+{
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+
+inline void crash_signal_handler( int sig ) noexcept
+{
+    static std::atomic< bool > draining{ false };
+    if( !draining.exchange( true ) )
+    {
+        auto & registry = crash_drain_registry();
+        registry.crash_drain( registry.crash_fd.load( std::memory_order_relaxed ) );
+    }
+
+    // Let the previous handler (or the default action) do its job.
+    for( std::size_t i = 0; i < crash_signals.size(); ++i )
+    {
+        if( crash_signals[ i ] == sig )
+        {
+            ::sigaction( sig, &previous_crash_actions()[ i ], nullptr );
+        }
+    }
+    ::raise( sig );
+}
+
+#endif
+
+}  // namespace details
+
+/**
+ * @brief Install crash and fork handlers for registered loggers.
+ *
+ * Sets signal handlers for SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT
+ * that write pending messages of registered loggers to a given
+ * file descriptor with plain `write(2)` and then pass the signal on
+ * to the handler that was set before.
+ *
+ * Also installs `pthread_atfork()` hooks that stop consumer threads
+ * of registered loggers before `fork()` (delivering all pending messages)
+ * and start them again in the parent and in the child.
+ * Messages still queued by other threads at `fork()` are dropped
+ * in the child as they belong to the parent.
+ *
+ * Handlers are installed by the first call, later calls only change
+ * the file descriptor (so the previous handler is never
+ * the crash drain handler itself). Must not be called
+ * concurrently with `fork()`.
+ *
+ * @param fd  A file descriptor to write pending messages to on crash.
+ *
+ * @return False if the platform is not supported or installing failed.
+ */
+inline bool install_crash_drain( int fd = 2 ) noexcept
+{
+#if defined( __unix__ ) || defined( __APPLE__ )
+    auto & registry = crash_drain_registry();
+    registry.crash_fd.store( fd, std::memory_order_relaxed );
+
+    static std::once_flag installed;
+    static bool installed_ok = false;
+    std::call_once( installed, [] {
+        const bool atfork_ok =
+            0
+            == ::pthread_atfork( [] { crash_drain_registry().fork_prepare(); },
+                                 [] { crash_drain_registry().fork_parent(); },
+                                 [] { crash_drain_registry().fork_child(); } );
+
+        struct sigaction action
+        {
+        };
+        action.sa_handler = &details::crash_signal_handler;
+        action.sa_flags   = SA_ONSTACK;
+        sigemptyset( &action.sa_mask );
+
+        bool signals_ok = true;
+        for( std::size_t i = 0; i < details::crash_signals.size(); ++i )
+        {
+            signals_ok =
+                signals_ok
+                && 0
+                       == ::sigaction( details::crash_signals[ i ],
+                                       &action,
+                                       &details::previous_crash_actions()[ i ] );
+        }
+
+        installed_ok = atfork_ok && signals_ok;
+    } );
+
+    return installed_ok;
+#else
+    static_cast< void >( fd );
+    return false;
+#endif
+}
+
+//
+// crash_drain_registration_t
+//
+
+/**
+ * @brief Register a synchronous logger, so it is flushed before `fork()`.
+ *
+ * A logger that passes messages right to its sink has nothing
+ * to drain on crash, but its sink might buffer data that would be
+ * written twice (by the parent and by the child) after `fork()`.
+ * Registration calls `flush()` of the logger before `fork()`.
+ *
+ * @code{.cpp}
+ * logr::ostream_logger_t<> logger{ std::cout };
+ * logr::crash_drain_registration_t reg{ logger };
+ * @endcode
+ *
+ * @tparam Logger  A logger type (derived from `basic_logger_type_t`).
+ */
+template < typename Logger >
+class crash_drain_registration_t final : public crash_drainable_t
+{
+public:
+    explicit crash_drain_registration_t( Logger & logger )
+        : m_logger{ logger }
+    {
+        crash_drain_registry().add( this );
+    }
+
+    ~crash_drain_registration_t() { crash_drain_registry().remove( this ); }
+
+    crash_drain_registration_t( const crash_drain_registration_t & ) = delete;
+    crash_drain_registration_t & operator=( const crash_drain_registration_t & ) =
+        delete;
+
+    void crash_drain( int /* fd */ ) noexcept override {}
+
+    void fork_prepare() noexcept override
+    {
+        try
+        {
+            m_logger.flush();
+        }
+        catch( ... )
+        {
+        }
+    }
+
+    void fork_parent() noexcept override {}
+
+    void fork_child() noexcept override {}
+
+private:
+    Logger & m_logger;
+};
+
+} /* namespace logr */
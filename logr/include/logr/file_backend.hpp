@@ -0,0 +1,904 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A buffered text backend writing to a file descriptor (POSIX only).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <logr/group_commit.hpp>
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+/**
+ * Sidecar index of a log file: a sparse map of write time to offset.
+ */
+namespace file_index
+{
+
+//! File signature.
+inline constexpr std::string_view magic{ "LOGRIDX1" };
+
+//! Current format version.
+inline constexpr std::uint32_t version = 2;
+
+//! The oldest version that can be read.
+inline constexpr std::uint32_t min_version = 1;
+
+//! File header.
+struct header_t
+{
+    char magic[ 8 ];
+    std::uint32_t version;
+    std::uint32_t reserved;
+
+    //! Bytes of log between entries.
+    std::uint64_t interval;
+
+    //! Time a message can wait in a buffer before it is written.
+    std::int64_t max_delay_ns;
+};
+
+/**
+ * @brief An entry: data before the offset was written by the time.
+ *
+ * The level is the max level of messages written since the previous
+ * entry (`nolog` if unknown), the first logged time is the time
+ * the earliest of them was logged. A message can wait in a buffer
+ * of an idle thread for any time, so it is the first logged time
+ * that tells where messages of a time range end.
+ */
+struct entry_t
+{
+    //! Nanoseconds since the epoch (UTC).
+    std::int64_t timestamp;
+    std::uint64_t offset;
+    std::int32_t level;
+    std::uint32_t reserved;
+    std::int64_t first_logged;
+};
+
+//! Size of an entry of version 1 (without the first logged time).
+inline constexpr std::size_t entry_v1_size = offsetof( entry_t, first_logged );
+
+//! Index contents.
+struct index_t
+{
+    header_t header;
+    std::vector< entry_t > entries;
+};
+
+/**
+ * @brief Read an index.
+ *
+ * Throws `std::runtime_error` if the data is not an index.
+ */
+inline index_t read_index( std::istream & input )
+{
+    index_t res;
+    char header_buf[ sizeof( header_t ) ];
+    if( !input.read( header_buf, sizeof( header_buf ) ) )
+    {
+        throw std::runtime_error{ "not a logr index file" };
+    }
+    std::memcpy( &res.header, header_buf, sizeof( header_t ) );
+    if( std::string_view{ res.header.magic, sizeof( res.header.magic ) }
+        != magic )
+    {
+        throw std::runtime_error{ "not a logr index file" };
+    }
+    if( res.header.version < min_version || version < res.header.version )
+    {
+        throw std::runtime_error{ "unsupported logr index version" };
+    }
+
+    const auto entry_size =
+        1 == res.header.version ? entry_v1_size : sizeof( entry_t );
+    char buf[ sizeof( entry_t ) ];
+    while( input.read( buf, static_cast< std::streamsize >( entry_size ) ) )
+    {
+        entry_t e;
+        std::memcpy( &e, buf, sizeof( e ) );
+        if( 1 == res.header.version )
+        {
+            // Version 1 assumes a message is written within max delay.
+            const auto max_delay = res.header.max_delay_ns;
+            e.first_logged =
+                e.timestamp < std::numeric_limits< std::int64_t >::min()
+                                  + max_delay
+                    ? std::numeric_limits< std::int64_t >::min()
+                    : e.timestamp - max_delay;
+        }
+        // Skip entries of a log file that was truncated.
+        while( !res.entries.empty() && res.entries.back().offset > e.offset )
+        {
+            res.entries.pop_back();
+        }
+        res.entries.push_back( e );
+    }
+    return res;
+}
+
+/**
+ * @brief Find a range of a log file with messages logged
+ *        within a time range.
+ *
+ * @param index      Index of the file.
+ * @param from       Nanoseconds since the epoch.
+ * @param to         Nanoseconds since the epoch.
+ * @param file_size  Size of the log file.
+ *
+ * @return Offsets [begin, end), not necessarily at line boundaries.
+ */
+inline std::pair< std::uint64_t, std::uint64_t > find_range(
+    const index_t & index,
+    std::int64_t from,
+    std::int64_t to,
+    std::uint64_t file_size ) noexcept
+{
+    std::uint64_t begin = 0;
+    std::uint64_t end   = file_size;
+
+    // Messages are written after they are logged.
+    for( const auto & e : index.entries )
+    {
+        if( e.timestamp >= from )
+        {
+            break;
+        }
+        begin = e.offset;
+    }
+
+    // Messages after an entry can be logged earlier than messages
+    // before it, so the end is the entry all data after which
+    // is logged later. Messages not covered by entries
+    // can be logged at any time.
+    auto first_after = std::numeric_limits< std::int64_t >::max();
+    if( index.entries.empty() || index.entries.back().offset < file_size )
+    {
+        first_after = std::numeric_limits< std::int64_t >::min();
+    }
+    for( auto it = index.entries.rbegin(); it != index.entries.rend(); ++it )
+    {
+        if( first_after <= to )
+        {
+            break;
+        }
+        end         = it->offset;
+        first_after = std::min( first_after, it->first_logged );
+    }
+
+    end = std::min( end, file_size );
+    return { std::min( begin, end ), end };
+}
+
+} /* namespace file_index */
+
+//
+// file_logger_t
+//
+
+/**
+ * @brief A logger writing text lines to a file descriptor
+ *        (a file, stdout, a pipe).
+ *
+ * Each thread formats its lines into its own staging buffer
+ * (no lock shared with other threads), the buffer is written
+ * with a single `write()` when it grows over a batch size
+ * or gets older than a max delay. `flush()` writes the buffers
+ * of all threads with a single `writev()`.
+ *
+ * Buffers are written as whole lines, so with an `O_APPEND` file
+ * (which is how a file is opened by path) several processes
+ * can share the file without lines being mixed.
+ *
+ * Messages at or above a durable level (if set) are written right away
+ * and a logging thread waits until they are on disk. Concurrent
+ * durable messages share a single `fdatasync()` (see `group_commit_t`).
+ * With a durable level set `flush()` is a commit point as well.
+ *
+ * A file opened by path can have a sidecar index (`path.idx`,
+ * see `file_index`): an entry with the time and the file size is added
+ * each time another `index_interval` bytes are written, so a reader
+ * can jump to a time range without scanning the file (`logr_seek` tool).
+ * Entries are added by writes of batches, which adds nothing
+ * to the cost of a message. Offsets are counted by this process:
+ * an index is not kept right if several processes share the file.
+ *
+ * Staged lines are lost if the process crashes, and a child created
+ * with `fork()` inherits them and writes them a second time.
+ * The logger doesn't register itself for `install_crash_drain()`:
+ * use `crash_drain_registration_t` to have it flushed before `fork()`,
+ * and a durable level for lines that must survive a crash.
+ *
+ * @note The max delay is checked when a message is logged
+ *       (by any thread), there is no timer thread.
+ */
+template < typename Logger_Traits =
+               basic_logger_traits_t< 1024,
+                                      char,
+                                      std::allocator< char >,
+                                      mt_log_level_driver_t<> > >
+class file_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "File logger supports only char messages" );
+
+    //! Default size of a thread's buffer to write it.
+    static constexpr std::size_t default_batch_size = 64 * 1024;
+
+    //! Default time a message can wait in a buffer.
+    static constexpr std::chrono::milliseconds default_max_delay{ 100 };
+
+    /**
+     * @brief Create a logger writing to a given descriptor.
+     *
+     * The descriptor is not closed by the logger.
+     *
+     * @param fd             A file descriptor (e.g. `STDOUT_FILENO`).
+     * @param level          Log level of the logger.
+     * @param batch_size     Size of a thread's buffer to write it.
+     * @param max_delay      Time a message can wait in a buffer.
+     * @param durable_level  Level of messages to wait to be on disk
+     *                       (`nolog` means none).
+     */
+    explicit file_logger_t(
+        int fd,
+        log_message_level level             = log_message_level::info,
+        std::size_t batch_size              = default_batch_size,
+        std::chrono::milliseconds max_delay = default_max_delay,
+        log_message_level durable_level     = log_message_level::nolog )
+        : base_type_t{ level }
+        , m_fd{ fd }
+        , m_batch_size{ batch_size }
+        , m_max_delay{ std::chrono::duration_cast< std::chrono::nanoseconds >(
+                           max_delay )
+                           .count() }
+        , m_durable_level{ durable_level }
+    {
+    }
+
+    /**
+     * @brief Create a logger appending to a file.
+     *
+     * @param index_interval  Bytes of log between index entries
+     *                        (zero means no index).
+     *
+     * Throws `std::system_error` if the file (or the index)
+     * cannot be opened.
+     */
+    explicit file_logger_t(
+        const std::string & path,
+        log_message_level level             = log_message_level::info,
+        std::size_t batch_size              = default_batch_size,
+        std::chrono::milliseconds max_delay = default_max_delay,
+        log_message_level durable_level     = log_message_level::nolog,
+        std::size_t index_interval          = 0 )
+        : file_logger_t{
+            open_file( path ), level, batch_size, max_delay, durable_level
+        }
+    {
+        m_owns_fd = true;
+        if( 0 != index_interval )
+        {
+            open_index( path + ".idx", index_interval );
+        }
+    }
+
+    ~file_logger_t() override
+    {
+        write_all( true );
+
+        if( -1 != m_index_fd )
+        {
+            // Cover the tail of the file.
+            write_index_entry();
+            ::close( m_index_fd );
+        }
+
+        std::lock_guard lock{ m_buffers_mutex };
+        for( auto & b : m_buffers )
+        {
+            b->logger_alive.store( false, std::memory_order_release );
+        }
+
+        if( m_owns_fd )
+        {
+            ::close( m_fd );
+        }
+    }
+
+    file_logger_t( const file_logger_t & ) = delete;
+    file_logger_t & operator=( const file_logger_t & ) = delete;
+
+    //! Commits of durable messages (for statistics).
+    const group_commit_t & group_commit() const noexcept { return m_commit; }
+
+private:
+    //! No deadline.
+    static constexpr std::int64_t no_deadline =
+        std::numeric_limits< std::int64_t >::max();
+
+    /**
+     * @brief A staging buffer of a thread.
+     *
+     * The mutex is taken by other threads only for `flush()`.
+     */
+    struct thread_buffer_t
+    {
+        std::mutex mutex;
+        ::fmt::memory_buffer buf;
+        std::int64_t deadline{ no_deadline };
+
+        //! Max level of messages in the buffer (for the index).
+        int max_level{ -1 };
+
+        //! Wall time of the first message in the buffer (for the index).
+        std::int64_t first_logged{ no_deadline };
+
+        std::atomic< bool > logger_alive{ true };
+    };
+
+    /**
+     * @brief A reference to a buffer kept by the thread.
+     */
+    struct thread_buffer_ref_t
+    {
+        const void * logger;
+        std::shared_ptr< thread_buffer_t > buffer;
+    };
+
+    static int open_file( const std::string & path )
+    {
+        const int fd = ::open(
+            path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+        if( -1 == fd )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "open() failed" };
+        }
+        return fd;
+    }
+
+    //! Open the index and write its header if it is a new file.
+    void open_index( const std::string & path, std::size_t interval )
+    {
+        m_index_fd = ::open(
+            path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+        if( -1 == m_index_fd )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "open() failed" };
+        }
+
+        struct stat st;
+        if( -1 == ::fstat( m_fd, &st ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "fstat() failed" };
+        }
+        m_written           = static_cast< std::uint64_t >( st.st_size );
+        m_index_interval    = interval;
+        m_last_index_offset = m_written;
+
+        if( -1 == ::fstat( m_index_fd, &st ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "fstat() failed" };
+        }
+        if( 0 == st.st_size )
+        {
+            file_index::header_t header{};
+            std::memcpy( header.magic,
+                         file_index::magic.data(),
+                         sizeof( header.magic ) );
+            header.version      = file_index::version;
+            header.interval     = interval;
+            header.max_delay_ns = m_max_delay;
+            write_to( m_index_fd, &header, sizeof( header ) );
+        }
+    }
+
+    /**
+     * @brief Count written data and add an index entry if it is time.
+     *
+     * Data is counted under a lock (a batch is written
+     * with a syscall anyway), so an entry gets the levels and times
+     * of exactly the data before it.
+     *
+     * @param size          Size of written data.
+     * @param level         Max level of messages in the data.
+     * @param first_logged  Wall time of the earliest message in the data.
+     */
+    void index_written( std::size_t size,
+                        int level,
+                        std::int64_t first_logged ) noexcept
+    {
+        if( -1 == m_index_fd || 0 == size )
+        {
+            return;
+        }
+
+        std::lock_guard lock{ m_index_mutex };
+        m_written += size;
+        m_index_level        = std::max( m_index_level, level );
+        m_index_first_logged = std::min( m_index_first_logged, first_logged );
+        if( m_written - m_last_index_offset >= m_index_interval )
+        {
+            add_index_entry();
+        }
+    }
+
+    //! Add an index entry for the tail of data (if any).
+    void write_index_entry() noexcept
+    {
+        std::lock_guard lock{ m_index_mutex };
+        if( m_written > m_last_index_offset )
+        {
+            add_index_entry();
+        }
+    }
+
+    //! Add an index entry for data written so far (under the index lock).
+    void add_index_entry() noexcept
+    {
+        file_index::entry_t e{};
+        e.timestamp    = wall_time();
+        e.offset       = m_written;
+        e.level        = m_index_level;
+        e.first_logged = m_index_first_logged;
+        if( e.level < 0 )
+        {
+            e.level = static_cast< std::int32_t >( log_message_level::nolog );
+        }
+        write_to( m_index_fd, &e, sizeof( e ) );
+
+        m_last_index_offset  = m_written;
+        m_index_level        = -1;
+        m_index_first_logged = no_deadline;
+    }
+
+    //! Nanoseconds since the epoch (UTC).
+    static std::int64_t wall_time() noexcept
+    {
+        return std::chrono::duration_cast< std::chrono::nanoseconds >(
+                   std::chrono::system_clock::now().time_since_epoch() )
+            .count();
+    }
+
+    static std::int64_t now() noexcept
+    {
+#if defined( __linux__ )
+        // Coarse clock is much cheaper and precise enough for delays.
+        ::timespec ts;
+        ::clock_gettime( CLOCK_MONOTONIC_COARSE, &ts );
+        return std::int64_t{ ts.tv_sec } * 1000000000 + ts.tv_nsec;
+#else
+        return std::chrono::duration_cast< std::chrono::nanoseconds >(
+                   std::chrono::steady_clock::now().time_since_epoch() )
+            .count();
+#endif
+    }
+
+    static constexpr std::string_view level_prefix(
+        log_message_level level ) noexcept
+    {
+        switch( level )
+        {
+            case log_message_level::trace:
+                return "TRACE: ";
+            case log_message_level::debug:
+                return "DEBUG: ";
+            case log_message_level::info:
+                return "INFO : ";
+            case log_message_level::warn:
+                return "WARN : ";
+            case log_message_level::error:
+                return "ERR  : ";
+            default:
+                return "CRIT : ";
+        }
+    }
+
+    thread_buffer_t & this_thread_buffer()
+    {
+        static thread_local std::vector< thread_buffer_ref_t > thread_buffers;
+
+        for( auto & ref : thread_buffers )
+        {
+            if( this == ref.logger
+                && ref.buffer->logger_alive.load( std::memory_order_relaxed ) )
+            {
+                return *ref.buffer;
+            }
+        }
+
+        // Forget buffers of destroyed loggers, as the address
+        // might be reused by this logger.
+        thread_buffers.erase(
+            std::remove_if( begin( thread_buffers ),
+                            end( thread_buffers ),
+                            []( const auto & ref ) {
+                                return !ref.buffer->logger_alive.load(
+                                    std::memory_order_relaxed );
+                            } ),
+            end( thread_buffers ) );
+
+        auto buffer = std::make_shared< thread_buffer_t >();
+        {
+            std::lock_guard lock{ m_buffers_mutex };
+            m_buffers.push_back( buffer );
+        }
+
+        thread_buffers.push_back(
+            thread_buffer_ref_t{ this, std::move( buffer ) } );
+        return *thread_buffers.back().buffer;
+    }
+
+    /**
+     * @brief Write data to a file.
+     *
+     * Errors (other than interruption) are ignored: data is dropped.
+     */
+    static void write_to( int fd, const void * p, std::size_t size ) noexcept
+    {
+        const auto * data = static_cast< const char * >( p );
+        while( 0 != size )
+        {
+            const auto n = ::write( fd, data, size );
+            if( n < 0 )
+            {
+                if( EINTR == errno )
+                {
+                    continue;
+                }
+                return;
+            }
+            data += n;
+            size -= static_cast< std::size_t >( n );
+        }
+    }
+
+    void write_line( log_message_level level,
+                     const src_location_t * src_location,
+                     string_view_t message )
+    {
+        const auto t = now();
+        auto & tb    = this_thread_buffer();
+        {
+            std::lock_guard lock{ tb.mutex };
+
+            auto & buf        = tb.buf;
+            const auto prefix = level_prefix( level );
+            buf.append( prefix.data(), prefix.data() + prefix.size() );
+            buf.append( message.data(), message.data() + message.size() );
+            if( nullptr != src_location )
+            {
+                ::fmt::format_to( ::fmt::appender( buf ),
+                                  " @ {}({})",
+                                  src_location->file,
+                                  src_location->line );
+            }
+            buf.push_back( '\n' );
+            tb.max_level = std::max( tb.max_level, static_cast< int >( level ) );
+
+            if( no_deadline == tb.deadline )
+            {
+                tb.deadline = t + m_max_delay;
+                set_deadline( tb.deadline );
+                if( -1 != m_index_fd )
+                {
+                    tb.first_logged = wall_time();
+                }
+            }
+
+            if( buf.size() >= m_batch_size || tb.deadline <= t
+                || level >= m_durable_level )
+            {
+                write_to( m_fd, buf.data(), buf.size() );
+                index_written( buf.size(), tb.max_level, tb.first_logged );
+                buf.clear();
+                tb.deadline     = no_deadline;
+                tb.max_level    = -1;
+                tb.first_logged = no_deadline;
+            }
+        }
+
+        if( level >= m_durable_level )
+        {
+            m_commit.commit( m_fd );
+        }
+
+        // Buffers of other threads got too old.
+        if( m_deadline.load( std::memory_order_relaxed ) <= t )
+        {
+            write_all( false );
+        }
+    }
+
+    //! Make the common deadline not later than a given one.
+    void set_deadline( std::int64_t deadline ) noexcept
+    {
+        auto current = m_deadline.load( std::memory_order_relaxed );
+        while( deadline < current
+               && !m_deadline.compare_exchange_weak(
+                   current, deadline, std::memory_order_relaxed ) )
+        {
+        }
+    }
+
+    /**
+     * @brief Write buffers of all threads with a single `writev()`.
+     *
+     * @param wait  Wait for a concurrent call to finish
+     *              (otherwise return, as it does the job).
+     */
+    void write_all( bool wait )
+    {
+        std::unique_lock write_lock{ m_write_all_mutex, std::defer_lock };
+        if( wait )
+        {
+            write_lock.lock();
+        }
+        else if( !write_lock.try_lock() )
+        {
+            return;
+        }
+
+        // Buffers that get messages from now on set a new deadline.
+        m_deadline.store( no_deadline, std::memory_order_relaxed );
+
+        {
+            std::lock_guard lock{ m_buffers_mutex };
+            m_write_all_buffers = m_buffers;
+        }
+
+        std::size_t i = 0;
+        while( i < m_write_all_buffers.size() )
+        {
+            // Lock a group of buffers and write them at once.
+            m_iov.clear();
+            const auto first = i;
+            std::size_t size  = 0;
+            int max_level     = -1;
+            auto first_logged = no_deadline;
+            for( ; i < m_write_all_buffers.size() && m_iov.size() < IOV_MAX; ++i )
+            {
+                auto & b = *m_write_all_buffers[ i ];
+                b.mutex.lock();
+                if( 0 != b.buf.size() )
+                {
+                    m_iov.push_back( ::iovec{ b.buf.data(), b.buf.size() } );
+                    size += b.buf.size();
+                    max_level    = std::max( max_level, b.max_level );
+                    first_logged = std::min( first_logged, b.first_logged );
+                }
+            }
+
+            writev_data();
+            index_written( size, max_level, first_logged );
+
+            for( auto j = first; j < i; ++j )
+            {
+                auto & b = *m_write_all_buffers[ j ];
+                b.buf.clear();
+                b.deadline     = no_deadline;
+                b.max_level    = -1;
+                b.first_logged = no_deadline;
+                b.mutex.unlock();
+            }
+        }
+
+        m_write_all_buffers.clear();
+        remove_unused_buffers();
+    }
+
+    void writev_data() noexcept
+    {
+        auto * iov = m_iov.data();
+        auto count = m_iov.size();
+        while( 0 != count )
+        {
+            const auto n = ::writev( m_fd, iov, static_cast< int >( count ) );
+            if( n < 0 )
+            {
+                if( EINTR == errno )
+                {
+                    continue;
+                }
+                return;
+            }
+
+            // Skip written data.
+            auto written = static_cast< std::size_t >( n );
+            while( 0 != count && written >= iov->iov_len )
+            {
+                written -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if( 0 != count )
+            {
+                iov->iov_base = static_cast< char * >( iov->iov_base ) + written;
+                iov->iov_len -= written;
+            }
+        }
+    }
+
+    /**
+     * @brief Remove empty buffers of finished threads.
+     *
+     * A buffer is referenced only by the logger if its thread is gone.
+     */
+    void remove_unused_buffers()
+    {
+        std::lock_guard lock{ m_buffers_mutex };
+        m_buffers.erase( std::remove_if( begin( m_buffers ),
+                                         end( m_buffers ),
+                                         []( const auto & b ) {
+                                             if( 1 != b.use_count() )
+                                             {
+                                                 return false;
+                                             }
+                                             std::lock_guard lock{ b->mutex };
+                                             return 0 == b->buf.size();
+                                         } ),
+                         end( m_buffers ) );
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_line( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_line( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_line( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_line( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_line( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_line( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_line( log_message_level::critical, &src_location, message );
+    }
+
+    void log_flush() override
+    {
+        write_all( true );
+        if( log_message_level::nolog != m_durable_level )
+        {
+            m_commit.commit( m_fd );
+        }
+    }
+
+    int m_fd;
+    bool m_owns_fd{ false };
+
+    const std::size_t m_batch_size;
+    const std::int64_t m_max_delay;
+    const log_message_level m_durable_level;
+    group_commit_t m_commit;
+
+    //! The earliest deadline of buffers.
+    std::atomic< std::int64_t > m_deadline{ no_deadline };
+
+    //! Buffers of all threads.
+    std::vector< std::shared_ptr< thread_buffer_t > > m_buffers;
+    std::mutex m_buffers_mutex;
+
+    //! Sidecar index (-1 if none).
+    int m_index_fd{ -1 };
+    std::size_t m_index_interval{};
+
+    //! Guards counting written data and adding index entries.
+    std::mutex m_index_mutex;
+
+    //! Data written by the logger (and the size of the file before it).
+    std::uint64_t m_written{};
+    std::uint64_t m_last_index_offset{};
+
+    //! Max level of messages written since the last index entry.
+    int m_index_level{ -1 };
+
+    //! Wall time of the earliest message written since the last entry.
+    std::int64_t m_index_first_logged{ no_deadline };
+
+    //! Guards the state of write_all().
+    std::mutex m_write_all_mutex;
+    std::vector< std::shared_ptr< thread_buffer_t > > m_write_all_buffers;
+    std::vector< ::iovec > m_iov;
+};
+
+} /* namespace logr */
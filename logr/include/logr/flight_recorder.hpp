@@ -0,0 +1,529 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A flight recorder: a backend keeping the latest messages
+ * in a ring of fixed-size slots in a memory mapped file (POSIX only),
+ * and a reader to recover them after the process is gone.
+ *
+ * The mapping is shared, so the data written to the ring
+ * stays in the file even if the process crashes.
+ *
+ * File layout (native byte order):
+ * @code
+ * file   := header(64 bytes) slot*
+ * header := "LOGRRING" version(u32) slot_size(u32) slots_count(u64)
+ *           next_ticket(u64)
+ * slot   := seq(u64) timestamp(i64) line(u32) checksum(u32)
+ *           file_size(u16) text_size(u16) level(u8) pad(3 bytes)
+ *           file text
+ * @endcode
+ *
+ * A message gets a ticket `t` and goes to slot `t % slots_count`;
+ * slot `seq` is `2t + 1` while it is being written and `2t + 2` when done.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+namespace flight_recorder
+{
+
+//! File signature.
+inline constexpr std::string_view magic{ "LOGRRING" };
+
+//! Current format version.
+inline constexpr std::uint32_t version = 1;
+
+//! File header.
+struct file_header_t
+{
+    char magic[ 8 ];
+    std::uint32_t version;
+    std::uint32_t slot_size;
+    std::uint64_t slots_count;
+
+    //! Next ticket (accessed atomically).
+    std::uint64_t next_ticket;
+};
+
+//! Size reserved for the file header (slots are cache line aligned).
+inline constexpr std::size_t header_size = 64;
+
+//! A header of a slot followed by file name and text.
+struct slot_header_t
+{
+    //! Accessed atomically.
+    std::uint64_t seq;
+    std::int64_t timestamp;
+    std::uint32_t line;
+    std::uint32_t checksum;
+    std::uint16_t file_size;
+    std::uint16_t text_size;
+    std::uint8_t level;
+    std::uint8_t pad[ 3 ];
+};
+
+static_assert( sizeof( file_header_t ) <= header_size );
+static_assert( sizeof( slot_header_t ) == 32 );
+
+//! Default sizes of a ring.
+inline constexpr std::uint32_t default_slot_size   = 256;
+inline constexpr std::uint64_t default_slots_count = 4096;
+
+//! Max slot size (file and text sizes are 16-bit).
+inline constexpr std::uint32_t max_slot_size = 32 * 1024;
+
+/**
+ * @brief Access a field of a mapped file as atomic.
+ */
+inline std::atomic< std::uint64_t > & as_atomic( std::uint64_t & value ) noexcept
+{
+    static_assert( std::atomic< std::uint64_t >::is_always_lock_free );
+    static_assert( sizeof( std::atomic< std::uint64_t > )
+                   == sizeof( std::uint64_t ) );
+    return *reinterpret_cast< std::atomic< std::uint64_t > * >( &value );
+}
+
+/**
+ * @brief A checksum of a completed slot.
+ *
+ * Detects slots torn by a writer that was lapped by another one.
+ */
+inline std::uint32_t slot_checksum( std::uint64_t ticket,
+                                    const slot_header_t & header,
+                                    const char * payload ) noexcept
+{
+    std::uint32_t h = 0x811C9DC5;
+    const auto add  = [ & ]( const void * data, std::size_t size ) {
+        const auto * p = static_cast< const unsigned char * >( data );
+        for( std::size_t i = 0; i < size; ++i )
+        {
+            h = ( h ^ p[ i ] ) * 0x01000193;
+        }
+    };
+
+    add( &ticket, sizeof( ticket ) );
+    add( &header.timestamp, sizeof( header.timestamp ) );
+    add( &header.line, sizeof( header.line ) );
+    add( &header.file_size, sizeof( header.file_size ) );
+    add( &header.text_size, sizeof( header.text_size ) );
+    add( &header.level, sizeof( header.level ) );
+    add( payload, std::size_t{ header.file_size } + header.text_size );
+    return h;
+}
+
+//! A message recovered from a ring.
+struct record_t
+{
+    std::uint64_t ticket{};
+    log_message_level level{ log_message_level::trace };
+    std::chrono::system_clock::time_point timestamp;
+    std::string file;
+    int line{};
+    std::string text;
+};
+
+/**
+ * @brief Read completed messages from a ring file.
+ *
+ * Slots being written or torn are skipped.
+ * Throws `std::runtime_error` if the data is not a ring file.
+ *
+ * @return Messages ordered from the oldest to the latest.
+ */
+inline std::vector< record_t > read_records( std::istream & input )
+{
+    char header_buf[ header_size ];
+    if( !input.read( header_buf, header_size ) )
+    {
+        throw std::runtime_error{ "not a logr flight recorder file" };
+    }
+
+    file_header_t header;
+    std::memcpy( &header, header_buf, sizeof( header ) );
+    if( std::string_view{ header.magic, sizeof( header.magic ) } != magic )
+    {
+        throw std::runtime_error{ "not a logr flight recorder file" };
+    }
+    if( version != header.version )
+    {
+        throw std::runtime_error{ "unsupported logr flight recorder version" };
+    }
+    if( header.slot_size <= sizeof( slot_header_t ) )
+    {
+        throw std::runtime_error{ "bad slot size" };
+    }
+
+    std::vector< record_t > res;
+    std::vector< char > slot( header.slot_size );
+    const auto payload_size = header.slot_size - sizeof( slot_header_t );
+
+    for( std::uint64_t i = 0; i < header.slots_count; ++i )
+    {
+        if( !input.read( slot.data(), header.slot_size ) )
+        {
+            break;
+        }
+
+        slot_header_t sh;
+        std::memcpy( &sh, slot.data(), sizeof( sh ) );
+        if( 0 == sh.seq || 0 != sh.seq % 2 )
+        {
+            continue;
+        }
+
+        const auto ticket    = sh.seq / 2 - 1;
+        const char * payload = slot.data() + sizeof( sh );
+        if( ticket % header.slots_count != i
+            || std::size_t{ sh.file_size } + sh.text_size > payload_size
+            || sh.level
+                   > static_cast< std::uint8_t >( log_message_level::critical )
+            || slot_checksum( ticket, sh, payload ) != sh.checksum )
+        {
+            continue;
+        }
+
+        record_t r;
+        r.ticket    = ticket;
+        r.level     = static_cast< log_message_level >( sh.level );
+        r.timestamp = std::chrono::system_clock::time_point{
+            std::chrono::duration_cast< std::chrono::system_clock::duration >(
+                std::chrono::nanoseconds{ sh.timestamp } )
+        };
+        r.file.assign( payload, sh.file_size );
+        r.line = static_cast< int >( sh.line );
+        r.text.assign( payload + sh.file_size, sh.text_size );
+        res.push_back( std::move( r ) );
+    }
+
+    std::sort( res.begin(), res.end(), []( const auto & a, const auto & b ) {
+        return a.ticket < b.ticket;
+    } );
+    return res;
+}
+
+} /* namespace flight_recorder */
+
+//
+// flight_recorder_logger_t
+//
+
+/**
+ * @brief A logger writing messages to a ring in a memory mapped file.
+ *
+ * Writing a message takes a ticket with an atomic add and copies
+ * the message to the ticket's slot: no locks, no syscalls, no waiting.
+ * The ring keeps the latest `slots_count` messages, text that doesn't fit
+ * a slot is truncated (and so is a file name, keeping its tail).
+ *
+ * An existing ring file of the same geometry is continued,
+ * otherwise the file is reinitialized.
+ * Use `logr_dump` tool (or `flight_recorder::read_records()`)
+ * to read the messages.
+ */
+template < typename Logger_Traits =
+               basic_logger_traits_t< 1024,
+                                      char,
+                                      std::allocator< char >,
+                                      mt_log_level_driver_t<> > >
+class flight_recorder_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "Flight recorder supports only char messages" );
+
+    /**
+     * @brief Open (or create) a ring file and map it.
+     *
+     * @param path         A path to the file.
+     * @param level        Log level of the logger.
+     * @param slots_count  Number of messages the ring keeps.
+     * @param slot_size    Size of a slot (a message with its header),
+     *                     rounded up to 8 bytes.
+     *
+     * Throws `std::system_error` if the file cannot be opened or mapped.
+     */
+    explicit flight_recorder_logger_t(
+        const std::string & path,
+        log_message_level level   = log_message_level::trace,
+        std::uint64_t slots_count = flight_recorder::default_slots_count,
+        std::uint32_t slot_size   = flight_recorder::default_slot_size )
+        : base_type_t{ level }
+        , m_slots_count{ std::max< std::uint64_t >( slots_count, 1 ) }
+        , m_slot_size{ std::clamp< std::uint32_t >(
+              ( slot_size + 7 ) / 8 * 8,
+              sizeof( flight_recorder::slot_header_t ) + 8,
+              flight_recorder::max_slot_size ) }
+        , m_size{ flight_recorder::header_size + m_slots_count * m_slot_size }
+    {
+        const int fd = ::open( path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+        if( -1 == fd )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "open() failed" };
+        }
+
+        try
+        {
+            map( fd );
+        }
+        catch( ... )
+        {
+            ::close( fd );
+            throw;
+        }
+
+        // The mapping holds the file.
+        ::close( fd );
+    }
+
+    ~flight_recorder_logger_t() override { ::munmap( m_data, m_size ); }
+
+    flight_recorder_logger_t( const flight_recorder_logger_t & ) = delete;
+    flight_recorder_logger_t & operator=( const flight_recorder_logger_t & ) =
+        delete;
+
+private:
+    void map( int fd )
+    {
+        struct stat st;
+        if( -1 == ::fstat( fd, &st ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "fstat() failed" };
+        }
+
+        const bool reuse = static_cast< std::size_t >( st.st_size ) == m_size;
+
+        if( !reuse && -1 == ::ftruncate( fd, 0 ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "ftruncate() failed" };
+        }
+
+#if defined( __linux__ )
+        // Allocate blocks now, so writes don't hit SIGBUS on a full disk.
+        // Returns an error code instead of setting errno.
+        const int err = ::posix_fallocate( fd, 0, static_cast< off_t >( m_size ) );
+        if( 0 != err )
+        {
+            throw std::system_error{ err,
+                                     std::system_category(),
+                                     "posix_fallocate() failed" };
+        }
+#else
+        if( -1 == ::ftruncate( fd, static_cast< off_t >( m_size ) ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "ftruncate() failed" };
+        }
+#endif
+
+        void * data =
+            ::mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        if( MAP_FAILED == data )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "mmap() failed" };
+        }
+        m_data = static_cast< char * >( data );
+
+        auto * header =
+            reinterpret_cast< flight_recorder::file_header_t * >( m_data );
+        if( reuse
+            && std::string_view{ header->magic, sizeof( header->magic ) }
+                   == flight_recorder::magic
+            && flight_recorder::version == header->version
+            && m_slot_size == header->slot_size
+            && m_slots_count == header->slots_count )
+        {
+            return;
+        }
+
+        std::memset( m_data, 0, m_size );
+        header->version     = flight_recorder::version;
+        header->slot_size   = m_slot_size;
+        header->slots_count = m_slots_count;
+        // Signature goes last, so a half initialized file is not recognized.
+        std::memcpy( header->magic,
+                     flight_recorder::magic.data(),
+                     flight_recorder::magic.size() );
+    }
+
+    void write_record( log_message_level level,
+                       const src_location_t * src_location,
+                       string_view_t message ) noexcept
+    {
+        auto * header =
+            reinterpret_cast< flight_recorder::file_header_t * >( m_data );
+        const auto ticket =
+            flight_recorder::as_atomic( header->next_ticket )
+                .fetch_add( 1, std::memory_order_relaxed );
+
+        char * slot = m_data + flight_recorder::header_size
+                      + ( ticket % m_slots_count ) * m_slot_size;
+        auto * sh = reinterpret_cast< flight_recorder::slot_header_t * >( slot );
+        auto & seq = flight_recorder::as_atomic( sh->seq );
+
+        // Mark the slot as being written before touching the data.
+        seq.store( 2 * ticket + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+
+        const auto payload_size =
+            m_slot_size - sizeof( flight_recorder::slot_header_t );
+        char * payload = slot + sizeof( flight_recorder::slot_header_t );
+
+        std::string_view file;
+        if( nullptr != src_location && nullptr != src_location->file )
+        {
+            file = src_location->file;
+            // Keep the tail of a long path, it is more informative.
+            const auto max_file_size = payload_size / 2;
+            if( file.size() > max_file_size )
+            {
+                file.remove_prefix( file.size() - max_file_size );
+            }
+        }
+        const auto text_size =
+            std::min( message.size(), payload_size - file.size() );
+
+        flight_recorder::slot_header_t data{};
+        data.timestamp = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                             std::chrono::system_clock::now().time_since_epoch() )
+                             .count();
+        data.line = nullptr != src_location
+                        ? static_cast< std::uint32_t >( src_location->line )
+                        : 0;
+        data.file_size = static_cast< std::uint16_t >( file.size() );
+        data.text_size = static_cast< std::uint16_t >( text_size );
+        data.level     = static_cast< std::uint8_t >( level );
+
+        std::memcpy( payload, file.data(), file.size() );
+        std::memcpy( payload + file.size(), message.data(), text_size );
+        data.checksum = flight_recorder::slot_checksum( ticket, data, payload );
+
+        // Everything but seq.
+        const auto * src = reinterpret_cast< const char * >( &data );
+        std::memcpy( slot + sizeof( data.seq ),
+                     src + sizeof( data.seq ),
+                     sizeof( data ) - sizeof( data.seq ) );
+
+        seq.store( 2 * ticket + 2, std::memory_order_release );
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_record( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_record( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_record( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_record( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_record( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_record( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_record( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_record( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_record( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_record( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_record( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_record( log_message_level::critical, &src_location, message );
+    }
+
+    /**
+     * @brief Schedule writing the ring to disk.
+     *
+     * Not needed to survive a process crash (only an OS one).
+     */
+    void log_flush() override { ::msync( m_data, m_size, MS_ASYNC ); }
+
+    const std::uint64_t m_slots_count;
+    const std::uint32_t m_slot_size;
+    const std::size_t m_size;
+
+    char * m_data{ nullptr };
+};
+
+} /* namespace logr */
@@ -0,0 +1,114 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * Group commit of file writes used by durability policy
+ * of file backends (POSIX only).
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include <unistd.h>
+
+namespace logr
+{
+
+//
+// group_commit_t
+//
+
+/**
+ * @brief Makes writes to a file durable with as few syncs as possible.
+ *
+ * A thread that wrote data and calls `commit()` waits for the next
+ * `fdatasync()` of the file. If no sync is running the thread does it
+ * itself, otherwise it waits for the running one to finish and
+ * the next one (done by one of waiting threads) covers writes
+ * of all threads that came during the previous sync.
+ * So under a storm of durable messages there is at most one sync
+ * running and one pending, no matter how many threads log.
+ */
+class group_commit_t
+{
+public:
+    /**
+     * @brief Wait until data written before the call is on disk.
+     *
+     * Sync errors are ignored (as write errors are).
+     */
+    void commit( int fd ) noexcept
+    {
+        std::unique_lock lock{ m_mutex };
+        const auto ticket = ++m_requested;
+        while( m_committed < ticket )
+        {
+            if( m_syncing )
+            {
+                m_cv.wait( lock );
+                continue;
+            }
+
+            // Lead a sync for all requests so far.
+            m_syncing         = true;
+            const auto target = m_requested;
+            lock.unlock();
+
+            sync_data( fd );
+
+            lock.lock();
+            m_syncing   = false;
+            m_committed = target;
+            ++m_syncs_count;
+            m_cv.notify_all();
+        }
+    }
+
+    //! Number of commits requested.
+    std::uint64_t commits_count() const
+    {
+        std::lock_guard lock{ m_mutex };
+        return m_requested;
+    }
+
+    //! Number of syncs done.
+    std::uint64_t syncs_count() const
+    {
+        std::lock_guard lock{ m_mutex };
+        return m_syncs_count;
+    }
+
+private:
+    static void sync_data( int fd ) noexcept
+    {
+#if defined( __APPLE__ )
+        while( -1 == ::fsync( fd ) && EINTR == errno )
+#else
+        while( -1 == ::fdatasync( fd ) && EINTR == errno )
+#endif
+        {
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    //! Last ticket given to a commit.
+    std::uint64_t m_requested{};
+
+    //! All tickets up to this one are committed.
+    std::uint64_t m_committed{};
+
+    bool m_syncing{ false };
+    std::uint64_t m_syncs_count{};
+};
+
+} /* namespace logr */
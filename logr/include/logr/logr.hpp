@@ -5,9 +5,16 @@
 
 #pragma once
 
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <variant>
+#include <chrono>
 
 #include <fmt/core.h>
 
@@ -33,6 +40,11 @@ namespace details
  * Uses `fmt::basic_memory_buffer<*>` for receiving log data
  * which is a SmallVector flavored CharT buffer that doesn't allocate
  * if the data fits in a given static buffer.
+ *
+ * Alternatively it can hold a string produced by a message builder
+ * (in place of the buffer, so the common case pays nothing for it).
+ * Container is movable, so a backend receiving it by rvalue
+ * can take over a heap allocated message without copying it.
  */
 template < std::size_t Inline_Size,
            typename CharT     = char,
@@ -43,6 +55,19 @@ public:
     //! Alias for string view for a given char type.
     using string_view_t = std::basic_string_view< CharT >;
 
+    //! A string type the container can take over.
+    using string_t = std::basic_string< CharT, std::char_traits< CharT >, Allocator >;
+
+    basic_small_message_container_t() = default;
+
+    /**
+     * @brief Create a container holding a given string.
+     */
+    explicit basic_small_message_container_t( string_t && str ) noexcept
+        : m_message{ std::in_place_type< string_t >, std::move( str ) }
+    {
+    }
+
     /**
      * @brief Create a a view to a message.
      *
@@ -50,7 +75,12 @@ public:
      */
     string_view_t make_view() const noexcept
     {
-        return string_view_t{ m_message.data(), m_message.size() };
+        if( const auto * str = std::get_if< string_t >( &m_message ) )
+        {
+            return string_view_t{ *str };
+        }
+        const auto & buf = *std::get_if< message_buffer_t >( &m_message );
+        return string_view_t{ buf.data(), buf.size() };
     }
 
     using message_buffer_t =
@@ -58,12 +88,52 @@ public:
 
     /**
      * @brief Get an output buffer.
+     *
+     * If the container holds a string, it switches to the buffer.
+     *
      * @return A reference to a lower level buffer.
      */
-    message_buffer_t & msg_buffer() noexcept { return m_message; };
+    message_buffer_t & msg_buffer() noexcept
+    {
+        if( auto * buf = std::get_if< message_buffer_t >( &m_message ) )
+        {
+            return *buf;
+        }
+        return m_message.template emplace< message_buffer_t >();
+    };
+
+    //! Does the container hold a string instead of a buffer.
+    bool holds_string() const noexcept
+    {
+        return std::holds_alternative< string_t >( m_message );
+    }
+
+    /**
+     * @brief Get the held string.
+     *
+     * @pre holds_string() is true.
+     */
+    string_t & str() noexcept { return *std::get_if< string_t >( &m_message ); }
+
+    /**
+     * @brief Does the message text live on the heap.
+     *
+     * Only then a backend taking the container over
+     * saves a copy of the text.
+     */
+    bool owns_heap_data() const noexcept
+    {
+        if( const auto * str = std::get_if< string_t >( &m_message ) )
+        {
+            // A short string keeps the text inline too.
+            return str->capacity() > string_t{ str->get_allocator() }.capacity();
+        }
+        return std::get_if< message_buffer_t >( &m_message )->capacity()
+               > Inline_Size;
+    }
 
 private:
-    message_buffer_t m_message;
+    std::variant< message_buffer_t, string_t > m_message;
 };
 
 } /* namespace details */
@@ -236,831 +306,2697 @@ auto format_to( write_to_ouput_wrapper_t< Buffer > out,
 ///@}
 
 //
-// log_level
+// deferred_arg_traits_t
 //
 
+namespace details
+{
+
+template < typename T >
+struct is_string_view : public std::false_type
+{
+};
+
+template < typename CharT, typename Traits >
+struct is_string_view< std::basic_string_view< CharT, Traits > >
+    : public std::true_type
+{
+};
+
+template < typename CharT >
+struct is_string_view< ::fmt::basic_string_view< CharT > > : public std::true_type
+{
+};
+
+template < typename T >
+inline constexpr bool is_char_pointer_v =
+    std::is_pointer_v< T >
+    && ( std::is_same_v< std::remove_cv_t< std::remove_pointer_t< T > >, char >
+         || std::is_same_v< std::remove_cv_t< std::remove_pointer_t< T > >,
+                            wchar_t > );
+
+}  // namespace details
+
 /**
- * @brief Log messages levels.
+ * @brief A customization point for capturing arguments of deferred messages.
  *
- * Primarly logr uses spdlog, so the list of log levels
- * is a copy of spdlog log levels.
+ * Deferred message copies its arguments and the formatting happens
+ * later (possibly on another thread), so only the values that remain
+ * valid after the call can be captured.
+ * By default trivially copyable types are captured as is,
+ * except for char pointers and string views which refer to
+ * the text owned by someone else.
+ *
+ * A type can opt-in by specializing the traits:
+ * @code{.cpp}
+ * template <>
+ * struct logr::deferred_arg_traits_t< session_id_t >
+ * {
+ *     static constexpr bool capturable = true;
+ *     // Must be trivially copyable and formattable by fmt.
+ *     using stored_type = std::uint64_t;
+ *     static stored_type capture( const session_id_t & id ) noexcept
+ *     {
+ *         return id.value();
+ *     }
+ * };
+ * @endcode
  */
-enum class log_message_level : int
+template < typename T, typename = void >
+struct deferred_arg_traits_t
 {
-    trace,
-    debug,
-    info,
-    warn,
-    error,
-    critical,
-    nolog
+    static constexpr bool capturable = std::is_trivially_copyable_v< T >
+                                       && !details::is_char_pointer_v< T >
+                                       && !details::is_string_view< T >::value;
+
+    using stored_type = T;
+
+    static constexpr const T & capture( const T & value ) noexcept
+    {
+        return value;
+    }
 };
 
+namespace details
+{
+
 //
-// src_location_t
+// deferred_args_pack_t
 //
 
 /**
- * @brief A aggregate struct for src location.
- *
- * @see LOGR_SRC_LOCATION
+ * @brief A trivially copyable tuple of captured arguments.
  */
+template < typename... Ts >
+struct deferred_args_pack_t;
 
-struct src_location_t
+template <>
+struct deferred_args_pack_t<>
 {
-    constexpr src_location_t() = default;
+    template < typename F, typename... Args >
+    void apply( F && f, const Args &... args ) const
+    {
+        f( args... );
+    }
+};
 
-    constexpr src_location_t( const char * f, int l )
-        : file{ f }
-        , line{ l }
+template < typename T, typename... Ts >
+struct deferred_args_pack_t< T, Ts... >
+{
+    constexpr deferred_args_pack_t( const T & h, const Ts &... t ) noexcept
+        : head{ h }
+        , tail{ t... }
     {
     }
 
-    const char * file{ nullptr };
-    int line{ 0 };
+    template < typename F, typename... Args >
+    void apply( F && f, const Args &... args ) const
+    {
+        tail.apply( std::forward< F >( f ), args..., head );
+    }
+
+    T head;
+    deferred_args_pack_t< Ts... > tail;
 };
 
+template < typename Arg >
+using deferred_stored_t =
+    typename deferred_arg_traits_t< std::decay_t< Arg > >::stored_type;
+
+template < typename Arg >
+inline constexpr bool is_deferred_capturable_v =
+    deferred_arg_traits_t< std::decay_t< Arg > >::capturable;
+
+}  // namespace details
+
 //
-// no_src_location_t
+// basic_deferred_arg_visitor_t
 //
 
 /**
- * @brief A tag class for collapsing src location usage.
- *
- * This class helps to remove src-location attribute of a message
- * without modifying existing logging code.
- * If `LOGR_CLIENT_COLLAPSE_SRC_LOCATION` macro is defined then
- * `LOGR_SRC_LOCATION` is set to @c no_src_location_t.
+ * @brief A visitor of captured deferred message
+ *        (see `basic_deferred_message_view_t::visit()`).
  *
- * @see LOGR_CLIENT_COLLAPSE_SRC_LOCATION
- * @see LOGR_SRC_LOCATION
+ * Lets a backend get a format string and raw argument values
+ * instead of a rendered text (e.g. for a binary log).
+ * Arithmetic, char and pointer arguments are passed as is,
+ * others are rendered with "{}" and passed as text.
  */
-struct no_src_location_t
+template < typename CharT >
+class basic_deferred_arg_visitor_t
 {
+public:
+    using string_view_t = std::basic_string_view< CharT >;
+
+    //! Called first with the format string.
+    virtual void on_format( string_view_t format ) = 0;
+
+    virtual void on_bool( bool value ) = 0;
+    virtual void on_char( CharT value ) = 0;
+    virtual void on_int( std::int64_t value ) = 0;
+    virtual void on_uint( std::uint64_t value ) = 0;
+    virtual void on_double( double value ) = 0;
+    virtual void on_pointer( const void * value ) = 0;
+    virtual void on_text( string_view_t value ) = 0;
+
+    /**
+     * @brief Handle a float argument.
+     *
+     * Widened to double a float gets a longer shortest representation
+     * (0.1f is 0.10000000149011612), so a visitor that keeps values
+     * should store floats as is. By default passes value to `on_double()`.
+     */
+    virtual void on_float( float value ) { on_double( value ); }
+
+    /**
+     * @brief Handle an id of a message from a message catalog
+     *        (see `catalog_message_t`).
+     *
+     * Called before `on_format()`. By default does nothing.
+     */
+    virtual void on_catalog_id( std::uint32_t id ) { static_cast< void >( id ); }
+
+protected:
+    ~basic_deferred_arg_visitor_t() = default;
 };
 
+namespace details
+{
+
+/**
+ * @brief Pass a captured argument to a visitor.
+ */
+template < typename CharT, typename T >
+void visit_deferred_arg( basic_deferred_arg_visitor_t< CharT > & visitor,
+                         const T & arg )
+{
+    if constexpr( std::is_same_v< T, bool > )
+    {
+        visitor.on_bool( arg );
+    }
+    else if constexpr( std::is_same_v< T, CharT > )
+    {
+        visitor.on_char( arg );
+    }
+    else if constexpr( std::is_integral_v< T > && std::is_signed_v< T > )
+    {
+        visitor.on_int( static_cast< std::int64_t >( arg ) );
+    }
+    else if constexpr( std::is_integral_v< T > )
+    {
+        visitor.on_uint( static_cast< std::uint64_t >( arg ) );
+    }
+    else if constexpr( std::is_same_v< T, float > )
+    {
+        visitor.on_float( arg );
+    }
+    else if constexpr( std::is_floating_point_v< T > )
+    {
+        visitor.on_double( static_cast< double >( arg ) );
+    }
+    else if constexpr( std::is_pointer_v< T > )
+    {
+        visitor.on_pointer( static_cast< const void * >( arg ) );
+    }
+    else
+    {
+        ::fmt::basic_memory_buffer< CharT > buf;
+        if constexpr( std::is_same_v< CharT, char > )
+        {
+            ::fmt::vformat_to(
+                ::fmt::appender( buf ), "{}", ::fmt::make_format_args( arg ) );
+        }
+        else
+        {
+            ::fmt::vformat_to( std::back_inserter( buf ),
+                               ::fmt::wstring_view{ L"{}" },
+                               ::fmt::make_wformat_args( arg ) );
+        }
+        visitor.on_text( { buf.data(), buf.size() } );
+    }
+}
+
+}  // namespace details
+
 //
-// st_log_level_driver_t
+// basic_deferred_message_view_t
 //
 
 /**
- * @brief A single thread log level driver.
+ * @brief A type erased view of a deferred message.
  *
- * Handles log level access without any synchronization.
+ * Refers to a trivially copyable capture of a message
+ * (format string pointer and argument values).
+ * Its bytes can be copied to another storage (with the given alignment),
+ * and formatting can be done later from that copy.
  *
- * @note Class doesn't have a virtual destructor
- *       as the intended usage scenario is to
- *       use it as a private base class explicitly
- *       moving access functions to public part of a base class.
+ * @code{.cpp}
+ * // Producer side:
+ * std::memcpy( storage, msg.data(), msg.size() );
+ * auto format_fn = msg.format_fn();
+ *
+ * // Later, possibly on another thread:
+ * format_fn( storage, out_buf );
+ * @endcode
  */
-class st_log_level_driver_t final
+template < typename CharT >
+class basic_deferred_message_view_t
 {
 public:
-    explicit st_log_level_driver_t( log_message_level level ) noexcept
-        : m_log_level{ level }
+    using char_t = CharT;
+
+    //! Output buffer deferred message is rendered to.
+    using buffer_t = ::fmt::detail::buffer< CharT >;
+
+    //! A function to render a captured message.
+    using format_fn_t = void ( * )( const void * data, buffer_t & out );
+
+    //! A visitor of a captured message.
+    using visitor_t = basic_deferred_arg_visitor_t< CharT >;
+
+    //! A function to pass captured format and arguments to a visitor.
+    using visit_fn_t = void ( * )( const void * data, visitor_t & visitor );
+
+    basic_deferred_message_view_t( const void * data,
+                                   std::size_t size,
+                                   std::size_t alignment,
+                                   format_fn_t format_fn,
+                                   visit_fn_t visit_fn ) noexcept
+        : m_data{ data }
+        , m_size{ size }
+        , m_alignment{ alignment }
+        , m_format_fn{ format_fn }
+        , m_visit_fn{ visit_fn }
     {
     }
 
-    // No virtual destructor as the data is trivial.
+    //! Captured message bytes.
+    const void * data() const noexcept { return m_data; }
+
+    //! The size of captured message.
+    std::size_t size() const noexcept { return m_size; }
+
+    //! The alignment required by captured message.
+    std::size_t alignment() const noexcept { return m_alignment; }
+
+    //! A function to render the captured message (or its copy).
+    format_fn_t format_fn() const noexcept { return m_format_fn; }
+
+    //! A function to visit the captured message (or its copy).
+    visit_fn_t visit_fn() const noexcept { return m_visit_fn; }
 
     /**
-     * @brief Get currently enabled log level.
-     *
-     * @return Log level set for logger.
+     * @brief Render the message.
      */
-    log_message_level log_level() const noexcept { return m_log_level; }
+    void format_to( buffer_t & out ) const { m_format_fn( m_data, out ); }
 
     /**
-     * @brief Set log level for logger.
-     *
-     * @param new_log_level  New log level for logger.
+     * @brief Pass format string and argument values to a visitor.
      */
-    void log_level( log_message_level new_log_level ) noexcept
-    {
-        m_log_level = new_log_level;
-    }
+    void visit( visitor_t & visitor ) const { m_visit_fn( m_data, visitor ); }
+
+    /**
+     * @brief A view is a deferred message itself,
+     *        so a copy can be passed to a logger again.
+     */
+    basic_deferred_message_view_t view() const noexcept { return *this; }
 
 private:
-    log_message_level m_log_level;
+    const void * m_data;
+    std::size_t m_size;
+    std::size_t m_alignment;
+    format_fn_t m_format_fn;
+    visit_fn_t m_visit_fn;
 };
 
 //
-// mt_log_level_driver_t
+// basic_deferred_message_t
 //
 
 /**
- * @brief A multi thread log level driver.
- *
- * Handles log level access with atomic.
+ * @brief A message with captured arguments to be formatted later.
  *
- * @note Class doesn't have a virtual destructor
- *       as the intended usage scenario is to
- *       use it as a private base class explicitly
- *       moving access functions to public part of a base class.
+ * Created with `deferred_format()`.
+ * It is a message producer of its own: pass it to any of
+ * logger's messaging functions instead of a message builder.
+ * A backend that supports it (e.g. async logger) copies the capture
+ * and formats it on its own (consumer) thread, others format
+ * the message right away.
  *
- * @tparam Load_MO  Memory order for loading value.
- * @tparam Store_MO  Memory order for storing new value.
+ * @note Format string must have a static storage duration
+ *       (a string literal), as only a pointer to it is captured.
  */
-template < std::memory_order Load_MO  = std::memory_order_relaxed,
-           std::memory_order Store_MO = std::memory_order_relaxed >
-class mt_log_level_driver_t final
+template < typename CharT, typename... Stored_Args >
+class basic_deferred_message_t
 {
 public:
-    explicit mt_log_level_driver_t( log_message_level level ) noexcept
-        : m_log_level{ level }
+    using char_t = CharT;
+    using view_t = basic_deferred_message_view_t< char_t >;
+
+    constexpr basic_deferred_message_t( ::fmt::basic_string_view< char_t > fs,
+                                        const Stored_Args &... args ) noexcept
+        : m_format{ fs.data() }
+        , m_format_size{ fs.size() }
+        , m_args{ args... }
     {
     }
 
-    // No virtual destructor as the data is trivial.
-
     /**
-     * @brief Get currently enabled log level.
-     *
-     * @return Log level set for logger.
+     * @brief Get a type erased view of this message.
      */
-    log_message_level log_level() const noexcept
+    view_t view() const noexcept
     {
-        return m_log_level.load( Load_MO );
+        return view_t{ this,
+                       sizeof( basic_deferred_message_t ),
+                       alignof( basic_deferred_message_t ),
+                       &basic_deferred_message_t::format,
+                       &basic_deferred_message_t::visit };
     }
 
-    /**
-     * @brief Set log level for logger.
-     *
-     * @param new_log_level  New log level for logger.
-     */
-    void log_level( log_message_level new_log_level ) noexcept
+private:
+    static void format( const void * data, typename view_t::buffer_t & out )
     {
-        m_log_level.store( new_log_level, Store_MO );
+        const auto & self = *static_cast< const basic_deferred_message_t * >( data );
+        const ::fmt::basic_string_view< char_t > fs{ self.m_format,
+                                                     self.m_format_size };
+
+        self.m_args.apply( [ & ]( const auto &... args ) {
+            if constexpr( std::is_same_v< char_t, char > )
+            {
+                ::fmt::vformat_to(
+                    ::fmt::appender( out ), fs, ::fmt::make_format_args( args... ) );
+            }
+            else
+            {
+                ::fmt::vformat_to( std::back_inserter( out ),
+                                   fs,
+                                   ::fmt::make_wformat_args( args... ) );
+            }
+        } );
     }
 
-private:
-    std::atomic< log_message_level > m_log_level;
+    static void visit( const void * data, typename view_t::visitor_t & visitor )
+    {
+        const auto & self = *static_cast< const basic_deferred_message_t * >( data );
+        visitor.on_format( { self.m_format, self.m_format_size } );
+
+        self.m_args.apply( [ & ]( const auto &... args ) {
+            ( details::visit_deferred_arg( visitor, args ), ... );
+        } );
+    }
+
+    const char_t * m_format;
+    std::size_t m_format_size;
+    details::deferred_args_pack_t< Stored_Args... > m_args;
 };
 
-//
-// basic_logger_traits_t
-//
+template < typename T >
+struct is_deferred_message : public std::false_type
+{
+};
+
+template < typename CharT, typename... Stored_Args >
+struct is_deferred_message< basic_deferred_message_t< CharT, Stored_Args... > >
+    : public std::true_type
+{
+};
+
+template < typename CharT >
+struct is_deferred_message< basic_deferred_message_view_t< CharT > >
+    : public std::true_type
+{
+};
+
+namespace details
+{
 
 /**
- * @brief Logger traits.
+ * @brief A format string of a deferred message.
  *
- * @tparam Inline_Size       The size of stack buffer used for messages.
- * @tparam CharT             Cheracter type.
- * @tparam Allocator         Allocator used for buffer
- *                           (in case stack buffer is not enough).
- * @tparam Log_Level_Driver  Log level control block.
+ * Only a pointer to the format string is captured and the message
+ * is formatted later (on another thread), so it accepts only
+ * a string literal (a `std::string` or `fmt::runtime()` doesn't compile).
+ * The string is checked against argument types like
+ * `fmt::format_string` does.
  */
-template < std::size_t Inline_Size,
-           typename CharT            = char,
-           typename Allocator        = std::allocator< CharT >,
-           typename Log_Level_Driver = st_log_level_driver_t >
-struct basic_logger_traits_t
+template < typename CharT, typename... Args >
+class deferred_format_string_t
 {
-    //! Inline message size.
-    static constexpr std::size_t inline_size = Inline_Size;
+public:
+    template < std::size_t N >
+    FMT_CONSTEVAL deferred_format_string_t( const CharT ( &fs )[ N ] )
+        : m_str{ fs }
+    {
+        // Check the format string.
+        static_cast< void >( fmt_format_string< CharT, Args... >{ fs } );
+    }
 
-    //! Charecter type.
-    using char_t = CharT;
+    ::fmt::basic_string_view< CharT > get() const noexcept { return m_str; }
 
-    //! Allocator.
-    using allocator_t = Allocator;
-
-    //! Log level handling routine.
-    using log_level_driver_t = Log_Level_Driver;
+private:
+    ::fmt::basic_string_view< CharT > m_str;
 };
 
-//
-// basic_logger_t
-//
+}  // namespace details
 
 /**
- * @brief A logger front-end base class.
+ * @name Create a message to be formatted later.
  *
- * Introduces `.xlevel( message )` interface. It
- * contains a propper mechanics for rendering log-messages (if needed)
- * and routing them to a set of overaridable functions with string view
- * interface (a more complex logic can be achieved using
- * overriding with message_container_t parameters).
- * So once a specific log level implementation (ovverriden function)
- * is called it means that a given level is active.
+ * @code{.cpp}
+ * logger.info( LOGR_SRC_LOCATION,
+ *              logr::deferred_format( "X is {} and Y is {}", x, y ) );
+ * @endcode
  *
- * @note Looking at implementation it may seem odd to have
- *       a transition from `xlevel(...)` messaging function
- *       stating level in its name to `message()` function having
- *       level specified as template parameter than back to
- *       to-be-overriden function `log_message_xlevel()` function
- *       stating its level in its name (via @c log_message_level_x).
- *       But that is a reuse mechanics not to manualy check for a
- *       particular log level and propagate copies of
- *       handle message builders biolerplates.
+ * Arguments are captured by value, so they must be trivially copyable
+ * or have an opt-in specialization of @c deferred_arg_traits_t,
+ * otherwise the call doesn't compile. Format string must be
+ * a string literal.
  *
- * @tparam Inline_Size       The size of stack buffer used for messages.
- * @tparam CharT             Cheracter type.
- * @tparam Allocator         Allocator used for buffer
- *                           (in case stack buffer is not enough).
- * @tparam Log_Level_Driver  Log level control block.
+ * @note Unlike message builders arguments are evaluated
+ *       even if the message level is disabled.
  */
-template < std::size_t Inline_Size,
-           typename CharT            = char,
-           typename Allocator        = std::allocator< CharT >,
-           typename Log_Level_Driver = st_log_level_driver_t >
-class basic_logger_type_t
+///@{
+template < typename... Args >
+auto deferred_format(
+    details::deferred_format_string_t< char,
+                                       details::deferred_stored_t< Args >... > fs,
+    Args &&... args )
 {
-public:
-    static constexpr auto inline_size = Inline_Size;
-    using char_t                      = CharT;
-    using allocator_t                 = Allocator;
+    static_assert( ( details::is_deferred_capturable_v< Args > && ... ),
+                   "An argument type cannot be captured for deferred "
+                   "formatting safely, consider specializing "
+                   "logr::deferred_arg_traits_t for it" );
+
+    static_assert(
+        ( std::is_trivially_copyable_v< details::deferred_stored_t< Args > >
+          && ... ),
+        "Stored type of deferred argument must be trivially copyable" );
+
+    return basic_deferred_message_t< char,
+                                     details::deferred_stored_t< Args >... >{
+        fs.get(), deferred_arg_traits_t< std::decay_t< Args > >::capture( args )...
+    };
+}
 
-    using message_container_t = details::
-        basic_small_message_container_t< inline_size, char_t, allocator_t >;
+template < typename... Args >
+auto deferred_format(
+    details::deferred_format_string_t< wchar_t,
+                                       details::deferred_stored_t< Args >... > fs,
+    Args &&... args )
+{
+    static_assert( ( details::is_deferred_capturable_v< Args > && ... ),
+                   "An argument type cannot be captured for deferred "
+                   "formatting safely, consider specializing "
+                   "logr::deferred_arg_traits_t for it" );
+
+    static_assert(
+        ( std::is_trivially_copyable_v< details::deferred_stored_t< Args > >
+          && ... ),
+        "Stored type of deferred argument must be trivially copyable" );
+
+    return basic_deferred_message_t< wchar_t,
+                                     details::deferred_stored_t< Args >... >{
+        fs.get(), deferred_arg_traits_t< std::decay_t< Args > >::capture( args )...
+    };
+}
+///@}
 
-    using string_view_t    = typename message_container_t::string_view_t;
-    using message_buffer_t = typename message_container_t::message_buffer_t;
+//
+// basic_static_message_t
+//
 
-    // clang-format off
-    /**
-     * @brief A shortcut to check a valid write-to message builder.
-     */
-    template < typename Message_Builder >
-    static inline constexpr bool is_by_return_msg_builder_v =
-        std::is_invocable_r< string_view_t, Message_Builder >::value;
+/**
+ * @brief A message text with static storage duration.
+ *
+ * A logger passes it to backend as is, so a backend that stores
+ * messages can keep a pointer and a size instead of copying the text.
+ * Plain char arrays and strings are always passed as a string view,
+ * a literal must be marked as static explicitly:
+ *
+ * @code
+ * using namespace logr::literals;
+ * logger.info( "Connection established"_static );
+ * @endcode
+ */
+template < typename CharT >
+class basic_static_message_t
+{
+public:
+    using string_view_t = std::basic_string_view< CharT >;
 
     /**
-     * @brief A shortcut to check a valid write-to message builder.
+     * @brief Refer to a text with static storage duration.
+     *
+     * @note Prefer `_static` literal, it can't refer to a temporary text.
      */
-    template < typename Message_Builder >
-    static inline constexpr bool is_by_writeto_msg_builder_v =
-        std::is_invocable_v< Message_Builder,
-                             write_to_ouput_wrapper_t< message_buffer_t > >
-        || std::is_invocable_v< Message_Builder,
-                                write_to_ouput_wrapper_t< message_buffer_t > & >;
+    constexpr basic_static_message_t( const CharT * data,
+                                      std::size_t size ) noexcept
+        : m_data{ data }
+        , m_size{ size }
+    {
+    }
 
-    /**
-     * @brief A shortcut to check a valid message builder.
-     */
-    template < typename Message_Builder >
-    static inline constexpr bool valid_message_producer_v =
-        is_by_return_msg_builder_v< Message_Builder >
-        || is_by_writeto_msg_builder_v< Message_Builder >;
-    // clang-format on
+    constexpr const CharT * data() const noexcept { return m_data; }
+    constexpr std::size_t size() const noexcept { return m_size; }
+
+    constexpr string_view_t view() const noexcept
+    {
+        return string_view_t{ m_data, m_size };
+    }
+
+private:
+    const CharT * m_data;
+    std::size_t m_size;
+};
+
+namespace literals
+{
+
+//! Mark a string literal as a static message.
+constexpr basic_static_message_t< char > operator""_static(
+    const char * literal,
+    std::size_t size ) noexcept
+{
+    return basic_static_message_t< char >{ literal, size };
+}
+
+//! Mark a wide string literal as a static message.
+constexpr basic_static_message_t< wchar_t > operator""_static(
+    const wchar_t * literal,
+    std::size_t size ) noexcept
+{
+    return basic_static_message_t< wchar_t >{ literal, size };
+}
+
+} /* namespace literals */
+
+//
+// log_level
+//
+
+/**
+ * @brief Log messages levels.
+ *
+ * Primarly logr uses spdlog, so the list of log levels
+ * is a copy of spdlog log levels.
+ */
+enum class log_message_level : int
+{
+    trace,
+    debug,
+    info,
+    warn,
+    error,
+    critical,
+    nolog
+};
+
+//
+// src_location_t
+//
+
+/**
+ * @brief A aggregate struct for src location.
+ *
+ * @see LOGR_SRC_LOCATION
+ */
+
+struct src_location_t
+{
+    constexpr src_location_t() = default;
+
+    constexpr src_location_t( const char * f, int l )
+        : file{ f }
+        , line{ l }
+    {
+    }
+
+    const char * file{ nullptr };
+    int line{ 0 };
+};
+
+//
+// no_src_location_t
+//
+
+/**
+ * @brief A tag class for collapsing src location usage.
+ *
+ * This class helps to remove src-location attribute of a message
+ * without modifying existing logging code.
+ * If `LOGR_CLIENT_COLLAPSE_SRC_LOCATION` macro is defined then
+ * `LOGR_SRC_LOCATION` is set to @c no_src_location_t.
+ *
+ * @see LOGR_CLIENT_COLLAPSE_SRC_LOCATION
+ * @see LOGR_SRC_LOCATION
+ */
+struct no_src_location_t
+{
+};
 
+//
+// rate_limit_t
+//
+
+/**
+ * @brief A lock-free token bucket limiting a rate of messages.
+ *
+ * Implemented as a generic cell rate algorithm: the only state is
+ * a theoretical arrival time of the next message, so taking a token
+ * is a single CAS and a denied message costs a load and a compare
+ * (plus increment of suppressed messages counter).
+ */
+class rate_limit_t
+{
+public:
     /**
-     * @brief Log-level driver type.
+     * @brief Try to take a token for a message.
+     *
+     * @param rate   Max average number of messages per second.
+     * @param burst  Max number of messages passed at once.
+     * @param now    Current time.
+     *
+     * @return True if message is allowed, otherwise message is
+     *         counted as suppressed.
      */
-    using log_level_driver_t = Log_Level_Driver;
+    bool try_acquire( double rate,
+                      std::size_t burst,
+                      std::chrono::steady_clock::time_point now ) noexcept
+    {
+        const std::int64_t now_ns =
+            std::chrono::duration_cast< std::chrono::nanoseconds >(
+                now.time_since_epoch() )
+                .count();
+        // Burst of messages spans at most max_span,
+        // so neither tolerance nor arrival time can overflow.
+        constexpr auto max_burst = static_cast< std::uint64_t >( max_span );
+        const auto burst_count   = static_cast< std::int64_t >(
+            burst < 1 ? 1 : ( burst < max_burst ? burst : max_burst ) );
+        const auto max_interval = max_span / burst_count;
+        const double rate_interval = 1e9 / rate;
+
+        // Zero, negative, NaN and tiny rates get the max interval.
+        const std::int64_t interval =
+            0.0 < rate && rate_interval < static_cast< double >( max_interval )
+                ? static_cast< std::int64_t >( rate_interval )
+                : max_interval;
+        const auto tolerance = interval * ( burst_count - 1 );
+
+        auto tat = m_tat.load( std::memory_order_relaxed );
+        do
+        {
+            if( now_ns < tat - tolerance )
+            {
+                m_suppressed.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+        } while( !m_tat.compare_exchange_weak(
+            tat,
+            saturating_add( tat < now_ns ? now_ns : tat, interval ),
+            std::memory_order_relaxed ) );
+
+        return true;
+    }
+
+    //! Get the number of suppressed messages and reset it.
+    std::uint64_t take_suppressed() noexcept
+    {
+        return m_suppressed.exchange( 0, std::memory_order_relaxed );
+    }
+
+private:
+    //! Max time span of a burst (about a century).
+    static constexpr std::int64_t max_span = std::int64_t{ 1 } << 62;
+
+    static std::int64_t saturating_add( std::int64_t a, std::int64_t b ) noexcept
+    {
+        // Both values are not negative.
+        return std::numeric_limits< std::int64_t >::max() - a < b
+                   ? std::numeric_limits< std::int64_t >::max()
+                   : a + b;
+    }
+
+    //! Theoretical arrival time of the next message (in ns).
+    std::atomic< std::int64_t > m_tat{ 0 };
+    std::atomic< std::uint64_t > m_suppressed{ 0 };
+};
+
+//
+// call_site_t
+//
+
+/**
+ * @brief A logging call site with its own runtime enable switch.
+ *
+ * An enabled call site logs messages regardless of logger's log level
+ * (but not the levels eliminated at compile time).
+ * Call sites are created with @c LOGR_CALL_SITE macro and
+ * are registered in @c call_site_registry_t.
+ *
+ * @code
+ * logger.debug( LOGR_CALL_SITE, [&]( auto out ){
+ *     format_to( out, "session state: {}", state );
+ * } );
+ * @endcode
+ */
+class call_site_t
+{
+public:
+    //! Create a call site and register it in call sites registry.
+    explicit call_site_t( src_location_t location ) noexcept;
+
+    call_site_t( const call_site_t & ) = delete;
+    call_site_t & operator=( const call_site_t & ) = delete;
+
+    const src_location_t & location() const noexcept { return m_location; }
+
+    bool enabled() const noexcept { return 0 != level_boost(); }
+
+    void enabled( bool value ) noexcept
+    {
+        m_level_boost.store( value ? enabled_level_boost : 0,
+                             std::memory_order_relaxed );
+    }
 
     /**
-     * @brief A very base class of logger.
+     * @brief A value to add to message level when comparing it
+     *        with logger's log level.
+     *
+     * Enabled call site raises its messages above any log level,
+     * so logger checks both level and call site with a single branch.
      */
-    using root_logger_type_t = basic_logger_type_t< inline_size,
-                                                    char_t,
-                                                    allocator_t,
-                                                    log_level_driver_t >;
+    int level_boost() const noexcept
+    {
+        return m_level_boost.load( std::memory_order_relaxed );
+    }
 
+    //! Rate limit of messages at the call site.
+    rate_limit_t & rate_limit() noexcept { return m_rate_limit; }
+
+    //! Next registered call site.
+    const call_site_t * next() const noexcept { return m_next; }
+    call_site_t * next() noexcept { return m_next; }
+
+private:
+    friend class call_site_registry_t;
+
+    static constexpr int enabled_level_boost =
+        static_cast< int >( log_message_level::nolog );
+
+    const src_location_t m_location;
+    std::atomic< int > m_level_boost{ 0 };
+    rate_limit_t m_rate_limit;
+    call_site_t * m_next{ nullptr };
+};
+
+//
+// call_site_registry_t
+//
+
+/**
+ * @brief A registry of all call sites of a program.
+ *
+ * Call sites are registered when they are created and live
+ * till the end of the program, so registry is never shrinked.
+ */
+class call_site_registry_t
+{
 public:
+    //! Get an instance of registry.
+    static call_site_registry_t & instance() noexcept
+    {
+        static call_site_registry_t registry;
+        return registry;
+    }
+
     /**
-     * @brief Construct logger with a given log level.
+     * @brief Run a given function for each registered call site.
      *
-     * @param  level  Logging messages level.
-     * @param  alloc  Allocator used for message buffer.
+     * @param func  A function accepting `call_site_t &`.
      */
-    explicit basic_logger_type_t(
-        log_message_level level,
-        const allocator_t & alloc = allocator_t() ) noexcept
-        : m_log_level{ level }
-        , m_alloc{ alloc }
+    template < typename Func >
+    void for_each( Func && func )
     {
+        for( auto * site = m_head.load( std::memory_order_acquire ); site;
+             site        = site->next() )
+        {
+            func( *site );
+        }
     }
 
     /**
-     * @brief Construct logger with a default log level.
+     * @brief Enable or disable call sites at a given location.
      *
-     * @param  alloc  Allocator used for message buffer.
+     * A file matches a call site if it is equal to a file
+     * of call site location or is its trailing part starting
+     * after a path separator (so "x.cpp" matches "src/x.cpp").
+     *
+     * @param file     File of call sites.
+     * @param line     Line of call sites, 0 means all lines of file.
+     * @param enabled  Whether to enable or disable call sites.
+     *
+     * @return Number of call sites found.
      */
-    explicit basic_logger_type_t(
-        const allocator_t & alloc = allocator_t() ) noexcept
-        : basic_logger_type_t{ log_message_level::info, alloc }
+    std::size_t enable( std::string_view file, int line, bool enabled = true )
+    {
+        std::size_t count{ 0 };
+        for_each( [ & ]( call_site_t & site ) {
+            const auto & loc = site.location();
+            if( ( 0 == line || loc.line == line ) && file_matches( loc, file ) )
+            {
+                site.enabled( enabled );
+                ++count;
+            }
+        } );
+        return count;
+    }
+
+    //! Disable all call sites.
+    void disable_all()
+    {
+        for_each( []( call_site_t & site ) { site.enabled( false ); } );
+    }
+
+private:
+    friend class call_site_t;
+
+    constexpr call_site_registry_t() noexcept = default;
+
+    void add( call_site_t & site ) noexcept
+    {
+        site.m_next = m_head.load( std::memory_order_relaxed );
+        while( !m_head.compare_exchange_weak(
+            site.m_next, &site, std::memory_order_release ) )
+        {
+        }
+    }
+
+    static bool file_matches( const src_location_t & loc,
+                              std::string_view file ) noexcept
+    {
+        if( nullptr == loc.file || file.empty() )
+        {
+            return false;
+        }
+
+        const std::string_view site_file{ loc.file };
+        if( site_file.size() < file.size()
+            || site_file.substr( site_file.size() - file.size() ) != file )
+        {
+            return false;
+        }
+
+        if( site_file.size() == file.size() )
+        {
+            return true;
+        }
+
+        const auto sep = site_file[ site_file.size() - file.size() - 1 ];
+        return '/' == sep || '\\' == sep;
+    }
+
+    std::atomic< call_site_t * > m_head{ nullptr };
+};
+
+inline call_site_t::call_site_t( src_location_t location ) noexcept
+    : m_location{ location }
+{
+    call_site_registry_t::instance().add( *this );
+}
+
+namespace details
+{
+
+/**
+ * @brief A holder of a call site identified by a tag type.
+ *
+ * Call site is a static data member, so it is created
+ * and registered on program start and using it costs no guard check
+ * (as it would for a function local static).
+ */
+template < typename Tag >
+struct call_site_holder_t
+{
+    static inline call_site_t site{ Tag::location() };
+};
+
+}  // namespace details
+
+//
+// st_log_level_driver_t
+//
+
+/**
+ * @brief A single thread log level driver.
+ *
+ * Handles log level access without any synchronization.
+ *
+ * @note Class doesn't have a virtual destructor
+ *       as the intended usage scenario is to
+ *       use it as a private base class explicitly
+ *       moving access functions to public part of a base class.
+ */
+class st_log_level_driver_t final
+{
+public:
+    explicit st_log_level_driver_t( log_message_level level ) noexcept
+        : m_log_level{ level }
+    {
+    }
+
+    // No virtual destructor as the data is trivial.
+
+    /**
+     * @brief Get currently enabled log level.
+     *
+     * @return Log level set for logger.
+     */
+    log_message_level log_level() const noexcept { return m_log_level; }
+
+    /**
+     * @brief Set log level for logger.
+     *
+     * @param new_log_level  New log level for logger.
+     */
+    void log_level( log_message_level new_log_level ) noexcept
+    {
+        m_log_level = new_log_level;
+    }
+
+private:
+    log_message_level m_log_level;
+};
+
+//
+// mt_log_level_driver_t
+//
+
+/**
+ * @brief A multi thread log level driver.
+ *
+ * Handles log level access with atomic.
+ *
+ * @note Class doesn't have a virtual destructor
+ *       as the intended usage scenario is to
+ *       use it as a private base class explicitly
+ *       moving access functions to public part of a base class.
+ *
+ * @tparam Load_MO  Memory order for loading value.
+ * @tparam Store_MO  Memory order for storing new value.
+ */
+template < std::memory_order Load_MO  = std::memory_order_relaxed,
+           std::memory_order Store_MO = std::memory_order_relaxed >
+class mt_log_level_driver_t final
+{
+public:
+    explicit mt_log_level_driver_t( log_message_level level ) noexcept
+        : m_log_level{ level }
+    {
+    }
+
+    // No virtual destructor as the data is trivial.
+
+    /**
+     * @brief Get currently enabled log level.
+     *
+     * @return Log level set for logger.
+     */
+    log_message_level log_level() const noexcept
+    {
+        return m_log_level.load( Load_MO );
+    }
+
+    /**
+     * @brief Set log level for logger.
+     *
+     * @param new_log_level  New log level for logger.
+     */
+    void log_level( log_message_level new_log_level ) noexcept
+    {
+        m_log_level.store( new_log_level, Store_MO );
+    }
+
+private:
+    std::atomic< log_message_level > m_log_level;
+};
+
+//
+// shared_log_level_t
+//
+
+/**
+ * @brief A log level shared by many loggers.
+ *
+ * Occupies a whole cache line, so changing the level
+ * doesn't cause false sharing with any other data.
+ *
+ * @see shared_log_level_driver_t
+ */
+class alignas( 64 ) shared_log_level_t final
+{
+public:
+    explicit constexpr shared_log_level_t(
+        log_message_level level = log_message_level::info ) noexcept
+        : m_log_level{ level }
+    {
+    }
+
+    shared_log_level_t( const shared_log_level_t & ) = delete;
+    shared_log_level_t & operator=( const shared_log_level_t & ) = delete;
+
+    log_message_level log_level() const noexcept
+    {
+        return m_log_level.load( std::memory_order_relaxed );
+    }
+
+    void log_level( log_message_level new_log_level ) noexcept
+    {
+        m_log_level.store( new_log_level, std::memory_order_relaxed );
+    }
+
+private:
+    std::atomic< log_message_level > m_log_level;
+};
+
+//
+// shared_log_level_driver_t
+//
+
+/**
+ * @brief A log level driver referring to a shared level.
+ *
+ * All loggers using the driver follow a given level,
+ * so a single store reconfigures all of them.
+ * The level is referred statically, so the driver has no data
+ * and checking a level is a single load from a fixed address.
+ *
+ * @code
+ * inline logr::shared_log_level_t connections_log_level{};
+ *
+ * using connection_logger_traits_t = logr::basic_logger_traits_t<
+ *     1024, char, std::allocator< char >,
+ *     logr::shared_log_level_driver_t< connections_log_level > >;
+ *
+ * // Sets level for all connection loggers.
+ * connections_log_level.log_level( logr::log_message_level::debug );
+ * @endcode
+ *
+ * @note Level passed to logger constructor is ignored,
+ *       the shared level keeps its value.
+ *
+ * @tparam Level  Shared level (an object with static storage duration).
+ */
+template < shared_log_level_t & Level >
+class shared_log_level_driver_t final
+{
+public:
+    explicit shared_log_level_driver_t( log_message_level ) noexcept {}
+
+    /**
+     * @brief Get currently enabled log level.
+     *
+     * @return Shared log level.
+     */
+    log_message_level log_level() const noexcept { return Level.log_level(); }
+
+    /**
+     * @brief Set shared log level (for all loggers using it).
+     *
+     * @param new_log_level  New log level.
+     */
+    void log_level( log_message_level new_log_level ) noexcept
+    {
+        Level.log_level( new_log_level );
+    }
+};
+
+//
+// basic_logger_traits_t
+//
+
+/**
+ * @brief Logger traits.
+ *
+ * @tparam Inline_Size       The size of stack buffer used for messages.
+ * @tparam CharT             Cheracter type.
+ * @tparam Allocator         Allocator used for buffer
+ *                           (in case stack buffer is not enough).
+ * @tparam Log_Level_Driver  Log level control block.
+ * @tparam Compiled_Min_Level  The lowest level of messages compiled in.
+ */
+template < std::size_t Inline_Size,
+           typename CharT                       = char,
+           typename Allocator                   = std::allocator< CharT >,
+           typename Log_Level_Driver            = st_log_level_driver_t,
+           log_message_level Compiled_Min_Level = log_message_level::trace >
+struct basic_logger_traits_t
+{
+    //! Inline message size.
+    static constexpr std::size_t inline_size = Inline_Size;
+
+    //! Charecter type.
+    using char_t = CharT;
+
+    //! Allocator.
+    using allocator_t = Allocator;
+
+    //! Log level handling routine.
+    using log_level_driver_t = Log_Level_Driver;
+
+    /**
+     * @brief The lowest level of messages compiled in.
+     *
+     * Messages of less severe levels are eliminated at compile time
+     * regardless of the log level set at runtime.
+     */
+    static constexpr log_message_level compiled_min_level = Compiled_Min_Level;
+};
+
+namespace details
+{
+
+template < typename Logger_Traits, typename = void >
+struct compiled_min_level_of
+    : std::integral_constant< log_message_level, log_message_level::trace >
+{
+};
+
+template < typename Logger_Traits >
+struct compiled_min_level_of<
+    Logger_Traits,
+    std::void_t< decltype( Logger_Traits::compiled_min_level ) > >
+    : std::integral_constant< log_message_level,
+                              Logger_Traits::compiled_min_level >
+{
+};
+
+}  // namespace details
+
+//
+// basic_logger_t
+//
+
+/**
+ * @brief A logger front-end base class.
+ *
+ * Introduces `.xlevel( message )` interface. It
+ * contains a propper mechanics for rendering log-messages (if needed)
+ * and routing them to a set of overaridable functions with string view
+ * interface (a more complex logic can be achieved using
+ * overriding with message_container_t parameters).
+ * So once a specific log level implementation (ovverriden function)
+ * is called it means that a given level is active.
+ *
+ * @note Looking at implementation it may seem odd to have
+ *       a transition from `xlevel(...)` messaging function
+ *       stating level in its name to `message()` function having
+ *       level specified as template parameter than back to
+ *       to-be-overriden function `log_message_xlevel()` function
+ *       stating its level in its name (via @c log_message_level_x).
+ *       But that is a reuse mechanics not to manualy check for a
+ *       particular log level and propagate copies of
+ *       handle message builders biolerplates.
+ *
+ * @tparam Inline_Size       The size of stack buffer used for messages.
+ * @tparam CharT             Cheracter type.
+ * @tparam Allocator         Allocator used for buffer
+ *                           (in case stack buffer is not enough).
+ * @tparam Log_Level_Driver  Log level control block.
+ * @tparam Compiled_Min_Level  The lowest level of messages compiled in,
+ *                             calls for less severe levels compile
+ *                             to nothing.
+ */
+template < std::size_t Inline_Size,
+           typename CharT                       = char,
+           typename Allocator                   = std::allocator< CharT >,
+           typename Log_Level_Driver            = st_log_level_driver_t,
+           log_message_level Compiled_Min_Level = log_message_level::trace >
+class basic_logger_type_t
+{
+public:
+    static constexpr auto inline_size        = Inline_Size;
+    static constexpr auto compiled_min_level = Compiled_Min_Level;
+    using char_t                             = CharT;
+    using allocator_t                        = Allocator;
+
+    using message_container_t = details::
+        basic_small_message_container_t< inline_size, char_t, allocator_t >;
+
+    using string_view_t    = typename message_container_t::string_view_t;
+    using message_buffer_t = typename message_container_t::message_buffer_t;
+
+    // clang-format off
+    /**
+     * @brief A shortcut to check a valid write-to message builder.
+     */
+    template < typename Message_Builder >
+    static inline constexpr bool is_by_return_msg_builder_v =
+        std::is_invocable_r< string_view_t, Message_Builder >::value;
+
+    /**
+     * @brief A shortcut to check a by-return message builder
+     *        whose result can be passed to backend by rvalue.
+     */
+    template < typename Message_Builder >
+    static inline constexpr bool is_by_return_owned_msg_builder_v =
+        std::is_same_v< std::invoke_result_t< Message_Builder >,
+                        typename message_container_t::string_t >;
+
+    /**
+     * @brief A shortcut to check a valid write-to message builder.
+     */
+    template < typename Message_Builder >
+    static inline constexpr bool is_by_writeto_msg_builder_v =
+        std::is_invocable_v< Message_Builder,
+                             write_to_ouput_wrapper_t< message_buffer_t > >
+        || std::is_invocable_v< Message_Builder,
+                                write_to_ouput_wrapper_t< message_buffer_t > & >;
+
+    /**
+     * @brief A shortcut to check a deferred message.
+     */
+    template < typename Message_Builder >
+    static inline constexpr bool is_deferred_msg_v =
+        is_deferred_message< Message_Builder >::value;
+
+    /**
+     * @brief A shortcut to check a valid message builder.
+     */
+    template < typename Message_Builder >
+    static inline constexpr bool valid_message_producer_v =
+        is_by_return_msg_builder_v< Message_Builder >
+        || is_by_writeto_msg_builder_v< Message_Builder >
+        || is_deferred_msg_v< Message_Builder >;
+    // clang-format on
+
+    /**
+     * @brief A type erased view of deferred message passed to backend.
+     */
+    using deferred_message_view_t = basic_deferred_message_view_t< char_t >;
+
+    /**
+     * @brief A literal message passed to backend.
+     */
+    using static_message_t = basic_static_message_t< char_t >;
+
+    /**
+     * @brief Log-level driver type.
+     */
+    using log_level_driver_t = Log_Level_Driver;
+
+    /**
+     * @brief A very base class of logger.
+     */
+    using root_logger_type_t = basic_logger_type_t< inline_size,
+                                                    char_t,
+                                                    allocator_t,
+                                                    log_level_driver_t,
+                                                    compiled_min_level >;
+
+    /**
+     * @brief Check if messages of a given level are compiled in.
+     */
+    static constexpr bool is_compiled_in( log_message_level level ) noexcept
+    {
+        return static_cast< int >( compiled_min_level )
+               <= static_cast< int >( level );
+    }
+
+public:
+    /**
+     * @brief Construct logger with a given log level.
+     *
+     * @param  level  Logging messages level.
+     * @param  alloc  Allocator used for message buffer.
+     */
+    explicit basic_logger_type_t(
+        log_message_level level,
+        const allocator_t & alloc = allocator_t() ) noexcept
+        : m_log_level{ level }
+        , m_alloc{ alloc }
+    {
+    }
+
+    /**
+     * @brief Construct logger with a default log level.
+     *
+     * @param  alloc  Allocator used for message buffer.
+     */
+    explicit basic_logger_type_t(
+        const allocator_t & alloc = allocator_t() ) noexcept
+        : basic_logger_type_t{ log_message_level::info, alloc }
+    {
+    }
+
+    /**
+     * @brief Get currently enabled log level.
+     *
+     * @return Log level set for logger.
+     */
+    auto log_level() const noexcept { return m_log_level.log_level(); }
+
+    /**
+     * @brief Set log level for logger.
+     *
+     * @param new_log_level  New log level for logger.
+     */
+    void log_level( log_message_level new_log_level ) noexcept(
+        noexcept( std::declval< log_level_driver_t & >().log_level(
+            new_log_level ) ) )
+    {
+        m_log_level.log_level( new_log_level );
+    }
+
+    /**
+     * @brief Get log level driver of the logger.
+     *
+     * Gives access to driver specific settings
+     * (e.g. binding to a category, see @c category_log_level_driver_t).
+     */
+    log_level_driver_t & log_level_driver() noexcept { return m_log_level; }
+
+    virtual ~basic_logger_type_t() = default;
+
+#if !defined( LOGR_CLIENT_ZERO_LOGGER )
+
+    //
+    // Basic message logging mechanics for all levels.
+    //
+
+    template < log_message_level Level >
+    void message( string_view_t raw_message )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( needs_log( Level ) )
+        {
+            log_message_level_x< Level >( raw_message );
+        }
+    }
+
+    template < log_message_level Level >
+    void message( src_location_t src_location, string_view_t raw_message )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( needs_log( Level ) )
+        {
+            dispatch_message< Level >( src_location, raw_message );
+        }
+    }
+
+    /**
+     * @brief Log a string literal marked as static message.
+     *
+     * The literal is passed to backend as a static message
+     * (see @c basic_static_message_t).
+     */
+    template < log_message_level Level >
+    void message( static_message_t raw_message )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( needs_log( Level ) )
+        {
+            log_static_message_level_x< Level >( raw_message );
+        }
+    }
+
+    template < log_message_level Level >
+    void message( src_location_t src_location, static_message_t raw_message )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( needs_log( Level ) )
+        {
+            dispatch_message< Level >( src_location, raw_message );
+        }
+    }
+
+    template < log_message_level Level,
+               typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void message( Message_Builder msg_builder )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( needs_log( Level ) )
+        {
+            if constexpr( is_by_return_msg_builder_v<
+                              Message_Builder > )  // NOLINT
+            {
+                if constexpr( is_by_return_owned_msg_builder_v< Message_Builder > )
+                {
+                    // Pass the string on, so backend can take it over.
+                    dispatch_container< Level >(
+                        message_container_t{ msg_builder() } );
+                }
+                else
+                {
+                    log_message_level_x< Level >( msg_builder() );
+                }
+            }
+            else if constexpr( is_deferred_msg_v< Message_Builder > )
+            {
+                static_assert(
+                    std::is_same_v< typename Message_Builder::char_t, char_t >,
+                    "Deferred message must have the same char type as logger" );
+
+                log_deferred_message_level_x< Level >( msg_builder.view() );
+            }
+            else
+            {
+                static_assert( is_by_writeto_msg_builder_v< Message_Builder >,
+                               "Bad producer, that assert must never be failed, "
+                               "unless a new message producer types are added" );
+
+                message_container_t msg;
+
+                {
+                    write_to_ouput_wrapper_t out{ msg.msg_buffer() };
+                    msg_builder( out );
+                }
+
+                // Dispatch message container, so backend can take it over.
+                dispatch_container< Level >( std::move( msg ) );
+            }
+        }
+    }
+
+    template < log_message_level Level,
+               typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void message( src_location_t src_location, Message_Builder msg_builder )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( needs_log( Level ) )
+        {
+            dispatch_message< Level >( src_location, std::move( msg_builder ) );
+        }
+    }
+
+    /**
+     * @brief Log a message at a given call site.
+     *
+     * A message is logged if its level is enabled for logger
+     * or if the call site is enabled (see @c call_site_registry_t).
+     */
+    template < log_message_level Level, typename Message >
+    void message( const call_site_t & site, Message && msg )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( static_cast< int >( log_level() )
+                 <= static_cast< int >( Level ) + site.level_boost() )
+        {
+            dispatch_message< Level >( site.location(),
+                                       std::forward< Message >( msg ) );
+        }
+    }
+
+    /**
+     * @brief Log a message at a given call site limiting its rate.
+     *
+     * If the rate limit is exceeded the message is suppressed
+     * without running its builder. The next message passing the limit
+     * tells how many messages were suppressed
+     * ("... [suppressed 48213 similar]").
+     *
+     * @param site   Call site the rate is limited for.
+     * @param rate   Max average number of messages per second.
+     * @param burst  Max number of messages passed at once.
+     * @param msg    Message (or message builder).
+     */
+    template < log_message_level Level, typename Message >
+    void message_limited( call_site_t & site,
+                          double rate,
+                          std::size_t burst,
+                          Message && msg )
+    {
+        if constexpr( !is_compiled_in( Level ) )
+        {
+            // Eliminated at compile time.
+        }
+        else if( static_cast< int >( log_level() )
+                     <= static_cast< int >( Level ) + site.level_boost()
+                 && site.rate_limit().try_acquire(
+                     rate, burst, std::chrono::steady_clock::now() ) )
+        {
+            const auto suppressed = site.rate_limit().take_suppressed();
+            if( 0 == suppressed )
+            {
+                dispatch_message< Level >( site.location(),
+                                           std::forward< Message >( msg ) );
+            }
+            else
+            {
+                dispatch_suppressed_message< Level >(
+                    site.location(), suppressed, std::forward< Message >( msg ) );
+            }
+        }
+    }
+
+    //
+    // Trace messaging.
+    //
+
+    void trace( string_view_t raw_message )
+    {
+        message< log_message_level::trace >( raw_message );
+    }
+
+    void trace( no_src_location_t, string_view_t raw_message )
+    {
+        message< log_message_level::trace >( raw_message );
+    }
+
+    void trace( src_location_t src_location, string_view_t raw_message )
+    {
+        message< log_message_level::trace >( src_location, raw_message );
+    }
+
+    void trace( static_message_t raw_message )
+    {
+        message< log_message_level::trace >( raw_message );
+    }
+
+    void trace( no_src_location_t, static_message_t raw_message )
+    {
+        message< log_message_level::trace >( raw_message );
+    }
+
+    void trace( src_location_t src_location, static_message_t raw_message )
+    {
+        message< log_message_level::trace >( src_location, raw_message );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void trace( Message_Builder msg_builder )
+    {
+        message< log_message_level::trace >( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void trace( no_src_location_t, Message_Builder msg_builder )
+    {
+        trace( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void trace( src_location_t src_location, Message_Builder msg_builder )
+    {
+        message< log_message_level::trace >( src_location,
+                                             std::move( msg_builder ) );
+    }
+
+    template < typename Message >
+    void trace( const call_site_t & site, Message && msg )
+    {
+        message< log_message_level::trace >( site,
+                                             std::forward< Message >( msg ) );
+    }
+
+    template < typename Message >
+    void trace_limited( call_site_t & site,
+                        double rate,
+                        std::size_t burst,
+                        Message && msg )
+    {
+        message_limited< log_message_level::trace >(
+            site, rate, burst, std::forward< Message >( msg ) );
+    }
+
+    //
+    // Debug messaging.
+    //
+
+    void debug( string_view_t raw_message )
+    {
+        message< log_message_level::debug >( raw_message );
+    }
+
+    void debug( no_src_location_t, string_view_t raw_message )
+    {
+        message< log_message_level::debug >( raw_message );
+    }
+
+    void debug( src_location_t src_location, string_view_t raw_message )
+    {
+        message< log_message_level::debug >( src_location, raw_message );
+    }
+
+    void debug( static_message_t raw_message )
+    {
+        message< log_message_level::debug >( raw_message );
+    }
+
+    void debug( no_src_location_t, static_message_t raw_message )
+    {
+        message< log_message_level::debug >( raw_message );
+    }
+
+    void debug( src_location_t src_location, static_message_t raw_message )
+    {
+        message< log_message_level::debug >( src_location, raw_message );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void debug( Message_Builder msg_builder )
+    {
+        message< log_message_level::debug >( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void debug( no_src_location_t, Message_Builder msg_builder )
+    {
+        debug( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void debug( src_location_t src_location, Message_Builder msg_builder )
+    {
+        message< log_message_level::debug >( src_location,
+                                             std::move( msg_builder ) );
+    }
+
+    template < typename Message >
+    void debug( const call_site_t & site, Message && msg )
+    {
+        message< log_message_level::debug >( site,
+                                             std::forward< Message >( msg ) );
+    }
+
+    template < typename Message >
+    void debug_limited( call_site_t & site,
+                        double rate,
+                        std::size_t burst,
+                        Message && msg )
+    {
+        message_limited< log_message_level::debug >(
+            site, rate, burst, std::forward< Message >( msg ) );
+    }
+
+    //
+    // Info messaging.
+    //
+
+    void info( string_view_t raw_message )
+    {
+        message< log_message_level::info >( raw_message );
+    }
+
+    void info( no_src_location_t, string_view_t raw_message )
+    {
+        message< log_message_level::info >( raw_message );
+    }
+
+    void info( src_location_t src_location, string_view_t raw_message )
+    {
+        message< log_message_level::info >( src_location, raw_message );
+    }
+
+    void info( static_message_t raw_message )
+    {
+        message< log_message_level::info >( raw_message );
+    }
+
+    void info( no_src_location_t, static_message_t raw_message )
+    {
+        message< log_message_level::info >( raw_message );
+    }
+
+    void info( src_location_t src_location, static_message_t raw_message )
+    {
+        message< log_message_level::info >( src_location, raw_message );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void info( Message_Builder msg_builder )
+    {
+        message< log_message_level::info >( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void info( no_src_location_t, Message_Builder msg_builder )
+    {
+        info( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void info( src_location_t src_location, Message_Builder msg_builder )
+    {
+        message< log_message_level::info >( src_location,
+                                            std::move( msg_builder ) );
+    }
+
+    template < typename Message >
+    void info( const call_site_t & site, Message && msg )
+    {
+        message< log_message_level::info >( site, std::forward< Message >( msg ) );
+    }
+
+    template < typename Message >
+    void info_limited( call_site_t & site,
+                       double rate,
+                       std::size_t burst,
+                       Message && msg )
+    {
+        message_limited< log_message_level::info >(
+            site, rate, burst, std::forward< Message >( msg ) );
+    }
+
+    //
+    // Warn messaging.
+    //
+
+    void warn( string_view_t raw_message )
+    {
+        message< log_message_level::warn >( raw_message );
+    }
+
+    void warn( no_src_location_t, string_view_t raw_message )
+    {
+        message< log_message_level::warn >( raw_message );
+    }
+
+    void warn( src_location_t src_location, string_view_t raw_message )
+    {
+        message< log_message_level::warn >( src_location, raw_message );
+    }
+
+    void warn( static_message_t raw_message )
+    {
+        message< log_message_level::warn >( raw_message );
+    }
+
+    void warn( no_src_location_t, static_message_t raw_message )
+    {
+        message< log_message_level::warn >( raw_message );
+    }
+
+    void warn( src_location_t src_location, static_message_t raw_message )
+    {
+        message< log_message_level::warn >( src_location, raw_message );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void warn( Message_Builder msg_builder )
+    {
+        message< log_message_level::warn >( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void warn( no_src_location_t, Message_Builder msg_builder )
+    {
+        warn( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void warn( src_location_t src_location, Message_Builder msg_builder )
+    {
+        message< log_message_level::warn >( src_location,
+                                            std::move( msg_builder ) );
+    }
+
+    template < typename Message >
+    void warn( const call_site_t & site, Message && msg )
+    {
+        message< log_message_level::warn >( site, std::forward< Message >( msg ) );
+    }
+
+    template < typename Message >
+    void warn_limited( call_site_t & site,
+                       double rate,
+                       std::size_t burst,
+                       Message && msg )
+    {
+        message_limited< log_message_level::warn >(
+            site, rate, burst, std::forward< Message >( msg ) );
+    }
+
+    //
+    // Error messaging.
+    //
+
+    void error( string_view_t raw_message )
+    {
+        message< log_message_level::error >( raw_message );
+    }
+
+    void error( no_src_location_t, string_view_t raw_message )
+    {
+        message< log_message_level::error >( raw_message );
+    }
+
+    void error( src_location_t src_location, string_view_t raw_message )
+    {
+        message< log_message_level::error >( src_location, raw_message );
+    }
+
+    void error( static_message_t raw_message )
+    {
+        message< log_message_level::error >( raw_message );
+    }
+
+    void error( no_src_location_t, static_message_t raw_message )
+    {
+        message< log_message_level::error >( raw_message );
+    }
+
+    void error( src_location_t src_location, static_message_t raw_message )
+    {
+        message< log_message_level::error >( src_location, raw_message );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void error( Message_Builder msg_builder )
+    {
+        message< log_message_level::error >( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void error( no_src_location_t, Message_Builder msg_builder )
+    {
+        error( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void error( src_location_t src_location, Message_Builder msg_builder )
+    {
+        message< log_message_level::error >( src_location,
+                                             std::move( msg_builder ) );
+    }
+
+    template < typename Message >
+    void error( const call_site_t & site, Message && msg )
+    {
+        message< log_message_level::error >( site,
+                                             std::forward< Message >( msg ) );
+    }
+
+    template < typename Message >
+    void error_limited( call_site_t & site,
+                        double rate,
+                        std::size_t burst,
+                        Message && msg )
+    {
+        message_limited< log_message_level::error >(
+            site, rate, burst, std::forward< Message >( msg ) );
+    }
+
+    //
+    // Critical messaging.
+    //
+
+    void critical( string_view_t raw_message )
+    {
+        message< log_message_level::critical >( raw_message );
+    }
+
+    void critical( no_src_location_t, string_view_t raw_message )
+    {
+        message< log_message_level::critical >( raw_message );
+    }
+
+    void critical( src_location_t src_location, string_view_t raw_message )
+    {
+        message< log_message_level::critical >( src_location, raw_message );
+    }
+
+    void critical( static_message_t raw_message )
+    {
+        message< log_message_level::critical >( raw_message );
+    }
+
+    void critical( no_src_location_t, static_message_t raw_message )
+    {
+        message< log_message_level::critical >( raw_message );
+    }
+
+    void critical( src_location_t src_location, static_message_t raw_message )
+    {
+        message< log_message_level::critical >( src_location, raw_message );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void critical( Message_Builder msg_builder )
+    {
+        message< log_message_level::critical >( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void critical( no_src_location_t, Message_Builder msg_builder )
+    {
+        critical( std::move( msg_builder ) );
+    }
+
+    template < typename Message_Builder,
+               typename = std::enable_if_t<
+                   valid_message_producer_v< Message_Builder > > >
+    void critical( src_location_t src_location, Message_Builder msg_builder )
+    {
+        message< log_message_level::critical >( src_location,
+                                                std::move( msg_builder ) );
+    }
+
+    template < typename Message >
+    void critical( const call_site_t & site, Message && msg )
+    {
+        message< log_message_level::critical >( site,
+                                                std::forward< Message >( msg ) );
+    }
+
+    template < typename Message >
+    void critical_limited( call_site_t & site,
+                           double rate,
+                           std::size_t burst,
+                           Message && msg )
+    {
+        message_limited< log_message_level::critical >(
+            site, rate, burst, std::forward< Message >( msg ) );
+    }
+
+    /**
+     * @brief Log message with runtime defined log level.
+     *
+     * @code
+     * // Log warning on every 128 dropped messages.
+     * const auto log_lvl =  dropped_msg_count && (0 == dropped_msg_count % 128) ?
+     *     log_message_level::trace : log_message_level::warn;
+     * logger().message_level_x( log_lvl, []( auto out ){
+     *     format_to( out,
+     *                FMT_STRING("session drops msg, total count: {}"),
+     *                dropped_msg_count );
+     * } );
+     * @endcode
+     *
+     * @pre log_lvl must be one of possible log_message_level values.
+     *
+     * @param log_lvl  Log level to log a message with.
+     * @since v0.6.0
+     */
+    template < typename... Args >
+    void message_level_x( log_message_level log_lvl, Args &&... args )
+    {
+        switch( log_lvl )
+        {
+            case log_message_level::trace:
+                this->trace( std::forward< Args >( args )... );
+                return;
+
+            case log_message_level::debug:
+                this->debug( std::forward< Args >( args )... );
+                return;
+
+            case log_message_level::info:
+                this->info( std::forward< Args >( args )... );
+                return;
+
+            case log_message_level::warn:
+                this->warn( std::forward< Args >( args )... );
+                return;
+
+            case log_message_level::error:
+                this->error( std::forward< Args >( args )... );
+                return;
+
+            case log_message_level::critical:
+                this->critical( std::forward< Args >( args )... );
+                return;
+
+            case log_message_level::nolog:
+                return;
+        };
+    }
+
+    void flush() { log_flush(); }
+
+#else  // defined(LOGR_CLIENT_ZERO_LOGGER) case
+
+    // Eliminate any logging.
+    template < typename... Args >
+    constexpr void trace( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void debug( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void info( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void warn( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void error( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void critical( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void trace_limited( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void debug_limited( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void info_limited( Args &&... ) const noexcept
+    {
+    }
+
+    template < typename... Args >
+    constexpr void warn_limited( Args &&... ) const noexcept
     {
     }
 
-    /**
-     * @brief Get currently enabled log level.
-     *
-     * @return Log level set for logger.
-     */
-    auto log_level() const noexcept { return m_log_level.log_level(); }
-
-    /**
-     * @brief Set log level for logger.
-     *
-     * @param new_log_level  New log level for logger.
-     */
-    void log_level( log_message_level new_log_level ) noexcept
+    template < typename... Args >
+    constexpr void error_limited( Args &&... ) const noexcept
     {
-        m_log_level.log_level( new_log_level );
     }
 
-    virtual ~basic_logger_type_t() = default;
+    template < typename... Args >
+    constexpr void critical_limited( Args &&... ) const noexcept
+    {
+    }
 
-#if !defined( LOGR_CLIENT_ZERO_LOGGER )
+    constexpr void flush() const noexcept {}
+#endif
 
+private:
     //
-    // Basic message logging mechanics for all levels.
+    // Routing of enabled messages with src location.
     //
 
     template < log_message_level Level >
-    void message( string_view_t raw_message )
+    void dispatch_message( src_location_t src_location, string_view_t raw_message )
     {
-        if( needs_log( Level ) )
-        {
-            log_message_level_x< Level >( raw_message );
-        }
+        log_message_level_x< Level >( src_location, raw_message );
     }
 
     template < log_message_level Level >
-    void message( src_location_t src_location, string_view_t raw_message )
+    void dispatch_message( src_location_t src_location,
+                           static_message_t raw_message )
     {
-        if( needs_log( Level ) )
-        {
-            log_message_level_x< Level >( src_location, raw_message );
-        }
+        log_static_message_level_x< Level >( src_location, raw_message );
     }
 
     template < log_message_level Level,
                typename Message_Builder,
                typename = std::enable_if_t<
                    valid_message_producer_v< Message_Builder > > >
-    void message( Message_Builder msg_builder )
+    void dispatch_message( src_location_t src_location,
+                           Message_Builder msg_builder )
     {
-        if( needs_log( Level ) )
+        if constexpr( is_by_return_msg_builder_v< Message_Builder > )
         {
-            if constexpr( is_by_return_msg_builder_v<
-                              Message_Builder > )  // NOLINT
+            if constexpr( is_by_return_owned_msg_builder_v< Message_Builder > )
             {
-                log_message_level_x< Level >( msg_builder() );
+                // Pass the string on, so backend can take it over.
+                dispatch_container< Level >( message_container_t{ msg_builder() },
+                                             src_location );
             }
             else
             {
-                static_assert( is_by_writeto_msg_builder_v< Message_Builder >,
-                               "Bad producer, that assert must never be failed, "
-                               "unless a new message producer types are added" );
+                log_message_level_x< Level >( src_location, msg_builder() );
+            }
+        }
+        else if constexpr( is_deferred_msg_v< Message_Builder > )
+        {
+            static_assert(
+                std::is_same_v< typename Message_Builder::char_t, char_t >,
+                "Deferred message must have the same char type as logger" );
 
-                message_container_t msg;
+            log_deferred_message_level_x< Level >( src_location,
+                                                   msg_builder.view() );
+        }
+        else
+        {
+            static_assert( is_by_writeto_msg_builder_v< Message_Builder >,
+                           "Bad producer, that assert must never be failed, "
+                           "unless a new message producer types are added" );
 
-                {
-                    write_to_ouput_wrapper_t out{ msg.msg_buffer() };
-                    msg_builder( out );
-                }
+            message_container_t msg;
 
-                // Dispatch message as a string view.
-                log_message_level_x< Level >( msg.make_view() );
+            {
+                write_to_ouput_wrapper_t out{ msg.msg_buffer() };
+                msg_builder( out );
             }
+
+            // Dispatch message container, so backend can take it over.
+            dispatch_container< Level >( std::move( msg ), src_location );
         }
     }
 
-    template < log_message_level Level,
-               typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void message( src_location_t src_location, Message_Builder msg_builder )
+    /**
+     * @brief Route a message telling how many similar messages
+     *        were suppressed before it.
+     */
+    template < log_message_level Level, typename Message >
+    void dispatch_suppressed_message( src_location_t src_location,
+                                      std::uint64_t suppressed,
+                                      Message && msg )
     {
-        if( needs_log( Level ) )
-        {
-            if constexpr( is_by_return_msg_builder_v< Message_Builder > )
-            {
-                log_message_level_x< Level >( src_location, msg_builder() );
-            }
-            else
-            {
-                static_assert( is_by_writeto_msg_builder_v< Message_Builder >,
-                               "Bad producer, that assert must never be failed, "
-                               "unless a new message producer types are added" );
+        using message_t = std::remove_cv_t< std::remove_reference_t< Message > >;
 
-                message_container_t msg;
+        message_container_t container;
+        auto & buf = container.msg_buffer();
 
-                {
-                    write_to_ouput_wrapper_t out{ msg.msg_buffer() };
-                    msg_builder( out );
-                }
+        if constexpr( std::is_same_v< message_t, static_message_t > )
+        {
+            buf.append( msg.data(), msg.data() + msg.size() );
+        }
+        else if constexpr( std::is_convertible_v< Message, string_view_t > )
+        {
+            const string_view_t raw_message{ msg };
+            buf.append( raw_message.data(),
+                        raw_message.data() + raw_message.size() );
+        }
+        else if constexpr( is_by_return_msg_builder_v< message_t > )
+        {
+            const auto & result = msg();
+            const string_view_t raw_message{ result };
+            buf.append( raw_message.data(),
+                        raw_message.data() + raw_message.size() );
+        }
+        else if constexpr( is_deferred_msg_v< message_t > )
+        {
+            msg.view().format_to( buf );
+        }
+        else
+        {
+            static_assert( is_by_writeto_msg_builder_v< message_t >,
+                           "Bad producer, that assert must never be failed, "
+                           "unless a new message producer types are added" );
 
-                // Dispatch message as a string view.
-                log_message_level_x< Level >( src_location, msg.make_view() );
-            }
+            write_to_ouput_wrapper_t out{ buf };
+            msg( out );
         }
-    }
 
-    //
-    // Trace messaging.
-    //
+        if constexpr( std::is_same_v< char_t, char > )
+        {
+            ::fmt::format_to(
+                ::fmt::appender( buf ), " [suppressed {} similar]", suppressed );
+        }
+        else
+        {
+            ::fmt::format_to( std::back_inserter( buf ),
+                              L" [suppressed {} similar]",
+                              suppressed );
+        }
 
-    void trace( string_view_t raw_message )
-    {
-        message< log_message_level::trace >( raw_message );
+        dispatch_container< Level >( std::move( container ), src_location );
     }
 
-    template < size_t N >
-    void trace( const char_t raw_message[ N ] )
+    /**
+     * @brief Route a built message to the owned message routine
+     *        if a backend can take over its heap data.
+     *
+     * Otherwise the text is passed to a string view routine directly,
+     * so backends not overriding owned message routines
+     * pay only one virtual call.
+     */
+    template < log_message_level Level, typename... Src_Location >
+    void dispatch_container( message_container_t && msg,
+                             Src_Location... src_location )
     {
-        message< log_message_level::trace >( string_view_t( raw_message, N - 1 ) );
+        if( msg.owns_heap_data() )
+        {
+            log_owned_message_level_x< Level >( src_location...,
+                                                std::move( msg ) );
+        }
+        else
+        {
+            log_message_level_x< Level >( src_location..., msg.make_view() );
+        }
     }
 
-    void trace( no_src_location_t, string_view_t raw_message )
+    /**
+     * @brief A routing function to an implementation routine for a given
+     *        log level.
+     *
+     * @param args  A wildcard params to be directed to an implementation routine.
+     */
+    template < log_message_level Level, typename... Args >
+    void log_message_level_x( Args &&... args )
     {
-        message< log_message_level::trace >( raw_message );
-    }
+        if constexpr( Level == log_message_level::trace )
+        {
+            log_message_trace( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::debug )
+        {
+            log_message_debug( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::info )
+        {
+            log_message_info( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::warn )
+        {
+            log_message_warn( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::error )
+        {
+            log_message_error( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::critical )
+        {
+            log_message_critical( std::forward< Args >( args )... );
+        }
+        else
+        {
+            // Unfortunately static_assert( false, "Message" )
+            // would fire always, so here is a workaround
+            // to make it fire only in cases of template instantiation
 
-    void trace( src_location_t src_location, string_view_t raw_message )
-    {
-        message< log_message_level::trace >( src_location, raw_message );
-    }
+            struct dummy_type_t
+            {
+            };
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void trace( Message_Builder msg_builder )
-    {
-        message< log_message_level::trace >( std::move( msg_builder ) );
+            static_assert(
+                !std::is_same_v< dummy_type_t, dummy_type_t >,  // Always false.
+                "Unknown message level" );
+        }
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void trace( no_src_location_t, Message_Builder msg_builder )
+    /**
+     * @brief A routing function to deferred message routine for a given
+     *        log level.
+     *
+     * @param args  A wildcard params to be directed to an implementation routine.
+     */
+    template < log_message_level Level, typename... Args >
+    void log_deferred_message_level_x( Args &&... args )
     {
-        trace( std::move( msg_builder ) );
+        if constexpr( Level == log_message_level::trace )
+        {
+            log_deferred_message_trace( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::debug )
+        {
+            log_deferred_message_debug( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::info )
+        {
+            log_deferred_message_info( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::warn )
+        {
+            log_deferred_message_warn( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::error )
+        {
+            log_deferred_message_error( std::forward< Args >( args )... );
+        }
+        else
+        {
+            static_assert( Level == log_message_level::critical,
+                           "Unknown message level" );
+            log_deferred_message_critical( std::forward< Args >( args )... );
+        }
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void trace( src_location_t src_location, Message_Builder msg_builder )
+    /**
+     * @brief A routing function to static message routine for a given
+     *        log level.
+     *
+     * @param args  A wildcard params to be directed to an implementation routine.
+     */
+    template < log_message_level Level, typename... Args >
+    void log_static_message_level_x( Args &&... args )
     {
-        message< log_message_level::trace >( src_location,
-                                             std::move( msg_builder ) );
+        if constexpr( Level == log_message_level::trace )
+        {
+            log_static_message_trace( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::debug )
+        {
+            log_static_message_debug( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::info )
+        {
+            log_static_message_info( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::warn )
+        {
+            log_static_message_warn( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::error )
+        {
+            log_static_message_error( std::forward< Args >( args )... );
+        }
+        else
+        {
+            static_assert( Level == log_message_level::critical,
+                           "Unknown message level" );
+            log_static_message_critical( std::forward< Args >( args )... );
+        }
     }
 
-    //
-    // Debug messaging.
-    //
-
-    void debug( string_view_t raw_message )
+    /**
+     * @brief A routing function to owned message routine for a given
+     *        log level.
+     *
+     * @param args  A wildcard params to be directed to an implementation routine.
+     */
+    template < log_message_level Level, typename... Args >
+    void log_owned_message_level_x( Args &&... args )
     {
-        message< log_message_level::debug >( raw_message );
+        if constexpr( Level == log_message_level::trace )
+        {
+            log_owned_message_trace( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::debug )
+        {
+            log_owned_message_debug( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::info )
+        {
+            log_owned_message_info( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::warn )
+        {
+            log_owned_message_warn( std::forward< Args >( args )... );
+        }
+        else if constexpr( Level == log_message_level::error )
+        {
+            log_owned_message_error( std::forward< Args >( args )... );
+        }
+        else
+        {
+            static_assert( Level == log_message_level::critical,
+                           "Unknown message level" );
+            log_owned_message_critical( std::forward< Args >( args )... );
+        }
     }
 
-    void debug( no_src_location_t, string_view_t raw_message )
+    /**
+     * @brief Format deferred message right away and pass it as a string view.
+     */
+    template < log_message_level Level, typename... Src_Location >
+    void format_deferred_message( deferred_message_view_t message,
+                                  Src_Location... src_location )
     {
-        message< log_message_level::debug >( raw_message );
+        message_container_t msg;
+        message.format_to( msg.msg_buffer() );
+        log_message_level_x< Level >( src_location..., msg.make_view() );
     }
 
-    void debug( src_location_t src_location, string_view_t raw_message )
+protected:
+    // ===============================================================
+    // Optional override functions.
+    //
+    // Deferred messages (see `deferred_format()`): a backend can
+    // copy the captured message and render it later. By default
+    // the message is rendered right away and passed to
+    // a corresponding string view routine.
+
+    virtual void log_deferred_message_trace( deferred_message_view_t message )
     {
-        message< log_message_level::debug >( src_location, raw_message );
+        format_deferred_message< log_message_level::trace >( message );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void debug( Message_Builder msg_builder )
+    virtual void log_deferred_message_debug( deferred_message_view_t message )
     {
-        message< log_message_level::debug >( std::move( msg_builder ) );
+        format_deferred_message< log_message_level::debug >( message );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void debug( no_src_location_t, Message_Builder msg_builder )
+    virtual void log_deferred_message_info( deferred_message_view_t message )
     {
-        debug( std::move( msg_builder ) );
+        format_deferred_message< log_message_level::info >( message );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void debug( src_location_t src_location, Message_Builder msg_builder )
+    virtual void log_deferred_message_warn( deferred_message_view_t message )
     {
-        message< log_message_level::debug >( src_location,
-                                             std::move( msg_builder ) );
+        format_deferred_message< log_message_level::warn >( message );
     }
 
-    //
-    // Info messaging.
-    //
-
-    void info( string_view_t raw_message )
+    virtual void log_deferred_message_error( deferred_message_view_t message )
     {
-        message< log_message_level::info >( raw_message );
+        format_deferred_message< log_message_level::error >( message );
     }
 
-    void info( no_src_location_t, string_view_t raw_message )
+    virtual void log_deferred_message_critical( deferred_message_view_t message )
     {
-        message< log_message_level::info >( raw_message );
+        format_deferred_message< log_message_level::critical >( message );
     }
 
-    void info( src_location_t src_location, string_view_t raw_message )
+    virtual void log_deferred_message_trace( src_location_t src_location,
+                                             deferred_message_view_t message )
     {
-        message< log_message_level::info >( src_location, raw_message );
+        format_deferred_message< log_message_level::trace >( message,
+                                                             src_location );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void info( Message_Builder msg_builder )
+    virtual void log_deferred_message_debug( src_location_t src_location,
+                                             deferred_message_view_t message )
     {
-        message< log_message_level::info >( std::move( msg_builder ) );
+        format_deferred_message< log_message_level::debug >( message,
+                                                             src_location );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void info( no_src_location_t, Message_Builder msg_builder )
+    virtual void log_deferred_message_info( src_location_t src_location,
+                                            deferred_message_view_t message )
     {
-        info( std::move( msg_builder ) );
+        format_deferred_message< log_message_level::info >( message,
+                                                            src_location );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void info( src_location_t src_location, Message_Builder msg_builder )
+    virtual void log_deferred_message_warn( src_location_t src_location,
+                                            deferred_message_view_t message )
     {
-        message< log_message_level::info >( src_location,
-                                            std::move( msg_builder ) );
+        format_deferred_message< log_message_level::warn >( message,
+                                                            src_location );
     }
 
-    //
-    // Warn messaging.
-    //
-
-    void warn( string_view_t raw_message )
+    virtual void log_deferred_message_error( src_location_t src_location,
+                                             deferred_message_view_t message )
     {
-        message< log_message_level::warn >( raw_message );
+        format_deferred_message< log_message_level::error >( message,
+                                                             src_location );
     }
 
-    void warn( no_src_location_t, string_view_t raw_message )
+    virtual void log_deferred_message_critical( src_location_t src_location,
+                                                deferred_message_view_t message )
     {
-        message< log_message_level::warn >( raw_message );
+        format_deferred_message< log_message_level::critical >( message,
+                                                                src_location );
     }
 
-    void warn( src_location_t src_location, string_view_t raw_message )
+    // Owned messages: messages built by write-to builders and
+    // `std::basic_string` returned by by-return builders are passed
+    // in a container a backend can take over (e.g. steal
+    // a heap allocated buffer instead of copying the text).
+    // Only a text on the heap is passed this way, a short one
+    // goes to a string view routine right away.
+    // By default the message is passed to a corresponding
+    // string view routine.
+
+    virtual void log_owned_message_trace( message_container_t && message )
     {
-        message< log_message_level::warn >( src_location, raw_message );
+        log_message_trace( message.make_view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void warn( Message_Builder msg_builder )
+    virtual void log_owned_message_debug( message_container_t && message )
     {
-        message< log_message_level::warn >( std::move( msg_builder ) );
+        log_message_debug( message.make_view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void warn( no_src_location_t, Message_Builder msg_builder )
+    virtual void log_owned_message_info( message_container_t && message )
     {
-        warn( std::move( msg_builder ) );
+        log_message_info( message.make_view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void warn( src_location_t src_location, Message_Builder msg_builder )
+    virtual void log_owned_message_warn( message_container_t && message )
     {
-        message< log_message_level::warn >( src_location,
-                                            std::move( msg_builder ) );
+        log_message_warn( message.make_view() );
     }
 
-    //
-    // Error messaging.
-    //
-
-    void error( string_view_t raw_message )
+    virtual void log_owned_message_error( message_container_t && message )
     {
-        message< log_message_level::error >( raw_message );
+        log_message_error( message.make_view() );
     }
 
-    void error( no_src_location_t, string_view_t raw_message )
+    virtual void log_owned_message_critical( message_container_t && message )
     {
-        message< log_message_level::error >( raw_message );
+        log_message_critical( message.make_view() );
     }
 
-    void error( src_location_t src_location, string_view_t raw_message )
+    virtual void log_owned_message_trace( src_location_t src_location,
+                                          message_container_t && message )
     {
-        message< log_message_level::error >( src_location, raw_message );
+        log_message_trace( src_location, message.make_view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void error( Message_Builder msg_builder )
+    virtual void log_owned_message_debug( src_location_t src_location,
+                                          message_container_t && message )
     {
-        message< log_message_level::error >( std::move( msg_builder ) );
+        log_message_debug( src_location, message.make_view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void error( no_src_location_t, Message_Builder msg_builder )
+    virtual void log_owned_message_info( src_location_t src_location,
+                                         message_container_t && message )
     {
-        error( std::move( msg_builder ) );
+        log_message_info( src_location, message.make_view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void error( src_location_t src_location, Message_Builder msg_builder )
+    virtual void log_owned_message_warn( src_location_t src_location,
+                                         message_container_t && message )
     {
-        message< log_message_level::error >( src_location,
-                                             std::move( msg_builder ) );
+        log_message_warn( src_location, message.make_view() );
     }
 
-    //
-    // Critical messaging.
-    //
-
-    void critical( string_view_t raw_message )
+    virtual void log_owned_message_error( src_location_t src_location,
+                                          message_container_t && message )
     {
-        message< log_message_level::critical >( raw_message );
+        log_message_error( src_location, message.make_view() );
     }
 
-    void critical( no_src_location_t, string_view_t raw_message )
+    virtual void log_owned_message_critical( src_location_t src_location,
+                                             message_container_t && message )
     {
-        message< log_message_level::critical >( raw_message );
+        log_message_critical( src_location, message.make_view() );
     }
 
-    void critical( src_location_t src_location, string_view_t raw_message )
+    // Static messages: literals marked with `_static` are passed as a pointer
+    // and a size of a text with static storage duration,
+    // a backend can store them without copying the text.
+    // By default the message is passed to a corresponding
+    // string view routine.
+
+    virtual void log_static_message_trace( static_message_t message )
     {
-        message< log_message_level::critical >( src_location, raw_message );
+        log_message_trace( message.view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void critical( Message_Builder msg_builder )
+    virtual void log_static_message_debug( static_message_t message )
     {
-        message< log_message_level::critical >( std::move( msg_builder ) );
+        log_message_debug( message.view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void critical( no_src_location_t, Message_Builder msg_builder )
+    virtual void log_static_message_info( static_message_t message )
     {
-        critical( std::move( msg_builder ) );
+        log_message_info( message.view() );
     }
 
-    template < typename Message_Builder,
-               typename = std::enable_if_t<
-                   valid_message_producer_v< Message_Builder > > >
-    void critical( src_location_t src_location, Message_Builder msg_builder )
+    virtual void log_static_message_warn( static_message_t message )
     {
-        message< log_message_level::critical >( src_location,
-                                                std::move( msg_builder ) );
+        log_message_warn( message.view() );
     }
 
-    /**
-     * @brief Log message with runtime defined log level.
-     *
-     * @code
-     * // Log warning on every 128 dropped messages.
-     * const auto log_lvl =  dropped_msg_count && (0 == dropped_msg_count % 128) ?
-     *     log_message_level::trace : log_message_level::warn;
-     * logger().message_level_x( log_lvl, []( auto out ){
-     *     format_to( out,
-     *                FMT_STRING("session drops msg, total count: {}"),
-     *                dropped_msg_count );
-     * } );
-     * @endcode
-     *
-     * @pre log_lvl must be one of possible log_message_level values.
-     *
-     * @param log_lvl  Log level to log a message with.
-     * @since v0.6.0
-     */
-    template < typename... Args >
-    void message_level_x( log_message_level log_lvl, Args &&... args )
+    virtual void log_static_message_error( static_message_t message )
     {
-        switch( log_lvl )
-        {
-            case log_message_level::trace:
-                this->trace( std::forward< Args >( args )... );
-                return;
-
-            case log_message_level::debug:
-                this->debug( std::forward< Args >( args )... );
-                return;
-
-            case log_message_level::info:
-                this->info( std::forward< Args >( args )... );
-                return;
-
-            case log_message_level::warn:
-                this->warn( std::forward< Args >( args )... );
-                return;
-
-            case log_message_level::error:
-                this->error( std::forward< Args >( args )... );
-                return;
-
-            case log_message_level::critical:
-                this->critical( std::forward< Args >( args )... );
-                return;
-
-            case log_message_level::nolog:
-                return;
-        };
+        log_message_error( message.view() );
     }
 
-    void flush() { log_flush(); }
-
-#else  // defined(LOGR_CLIENT_ZERO_LOGGER) case
-
-    // Eliminate any logging.
-    template < typename... Args >
-    constexpr void trace( Args &&... ) const noexcept
+    virtual void log_static_message_critical( static_message_t message )
     {
+        log_message_critical( message.view() );
     }
 
-    template < typename... Args >
-    constexpr void debug( Args &&... ) const noexcept
+    virtual void log_static_message_trace( src_location_t src_location,
+                                           static_message_t message )
     {
+        log_message_trace( src_location, message.view() );
     }
 
-    template < typename... Args >
-    constexpr void info( Args &&... ) const noexcept
+    virtual void log_static_message_debug( src_location_t src_location,
+                                           static_message_t message )
     {
+        log_message_debug( src_location, message.view() );
     }
 
-    template < typename... Args >
-    constexpr void warn( Args &&... ) const noexcept
+    virtual void log_static_message_info( src_location_t src_location,
+                                          static_message_t message )
     {
+        log_message_info( src_location, message.view() );
     }
 
-    template < typename... Args >
-    constexpr void error( Args &&... ) const noexcept
+    virtual void log_static_message_warn( src_location_t src_location,
+                                          static_message_t message )
     {
+        log_message_warn( src_location, message.view() );
     }
 
-    template < typename... Args >
-    constexpr void critical( Args &&... ) const noexcept
+    virtual void log_static_message_error( src_location_t src_location,
+                                           static_message_t message )
     {
+        log_message_error( src_location, message.view() );
     }
 
-    constexpr void flush() const noexcept {}
-#endif
-
-private:
-    /**
-     * @brief A routing function to an implementation routine for a given
-     *        log level.
-     *
-     * @param args  A wildcard params to be directed to an implementation routine.
-     */
-    template < log_message_level Level, typename... Args >
-    void log_message_level_x( Args &&... args )
+    virtual void log_static_message_critical( src_location_t src_location,
+                                              static_message_t message )
     {
-        if constexpr( Level == log_message_level::trace )
-        {
-            log_message_trace( std::forward< Args >( args )... );
-        }
-        else if constexpr( Level == log_message_level::debug )
-        {
-            log_message_debug( std::forward< Args >( args )... );
-        }
-        else if constexpr( Level == log_message_level::info )
-        {
-            log_message_info( std::forward< Args >( args )... );
-        }
-        else if constexpr( Level == log_message_level::warn )
-        {
-            log_message_warn( std::forward< Args >( args )... );
-        }
-        else if constexpr( Level == log_message_level::error )
-        {
-            log_message_error( std::forward< Args >( args )... );
-        }
-        else if constexpr( Level == log_message_level::critical )
-        {
-            log_message_critical( std::forward< Args >( args )... );
-        }
-        else
-        {
-            // Unfortunately static_assert( false, "Message" )
-            // would fire always, so here is a workaround
-            // to make it fire only in cases of template instantiation
-
-            struct dummy_type_t
-            {
-            };
-
-            static_assert(
-                !std::is_same_v< dummy_type_t, dummy_type_t >,  // Always false.
-                "Unknown message level" );
-        }
+        log_message_critical( src_location, message.view() );
     }
+    // ===============================================================
 
-protected:
     // ===============================================================
     // Mandatory override functions (logger backend interface).
     //
@@ -1124,7 +3060,8 @@ using basic_logger_t =
     basic_logger_type_t< Logger_Traits::inline_size,
                          typename Logger_Traits::char_t,
                          typename Logger_Traits::allocator_t,
-                         typename Logger_Traits::log_level_driver_t >;
+                         typename Logger_Traits::log_level_driver_t,
+                         details::compiled_min_level_of< Logger_Traits >::value >;
 
 //
 // devirt_fixup_t
@@ -1340,4 +3277,45 @@ public:
         }
 #endif
 
+/**
+ * @brief A helper macro defining a call site at a given location.
+ *
+ * Gives a reference to a static @c call_site_t unique for
+ * the place the macro is used at.
+ * A project can define its own call site macro the same way
+ * as src location macro:
+ * ```
+ * #define XPRJ_CALL_SITE                                        \
+ *     LOGR_MAKE_CALL_SITE(                                      \
+ *         LOGR_STRIP_FILE_NAME_N( XPRJ_PRJ_ROOT_LENGTH_HINT ), \
+ *         __LINE__ )
+ * ```
+ */
+#define LOGR_MAKE_CALL_SITE( file, line )                                     \
+    ( []() -> ::logr::call_site_t & {                                         \
+        struct logr_call_site_tag_t                                           \
+        {                                                                     \
+            static constexpr ::logr::src_location_t location() noexcept       \
+            {                                                                 \
+                return ::logr::src_location_t{ file, line };                  \
+            }                                                                 \
+        };                                                                    \
+        return ::logr::details::call_site_holder_t<                           \
+            logr_call_site_tag_t >::site;                                     \
+    }() )
+
+#if !defined( LOGR_PRJ_ROOT_LENGTH_HINT )
+#    define LOGR_PRJ_ROOT_LENGTH_HINT 0
+#endif
+
+/**
+ * @brief A call site of logr project (see @c LOGR_SRC_LOCATION).
+ *
+ * Call site always has a location,
+ * even if `LOGR_PRJ_COLLAPSE_SRC_LOCATION` is defined.
+ */
+#define LOGR_CALL_SITE                                                      \
+    LOGR_MAKE_CALL_SITE( LOGR_STRIP_FILE_NAME_N( LOGR_PRJ_ROOT_LENGTH_HINT ), \
+                         __LINE__ )
+
 } /* namespace logr */
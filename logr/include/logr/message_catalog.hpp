@@ -0,0 +1,181 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * Schema of fixed messages generated from a message catalog
+ * (see `logr_add_message_catalog()` CMake function)
+ * and a deferred message carrying a message id.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+//
+// catalog_param_t
+//
+
+/**
+ * @brief A parameter of a catalog message.
+ */
+struct catalog_param_t
+{
+    std::string_view name;
+
+    //! C++ type as written in the catalog.
+    std::string_view type;
+};
+
+//
+// catalog_entry_t
+//
+
+/**
+ * @brief Schema of a catalog message.
+ *
+ * A generated catalog header defines a descriptor type
+ * for each message (with the same data as static members)
+ * and `catalog_entries` array of all messages.
+ */
+struct catalog_entry_t
+{
+    //! Stable message id.
+    std::uint32_t id;
+
+    //! Message name (the function is `log_<name>()`).
+    std::string_view name;
+
+    log_message_level level;
+
+    std::string_view format;
+
+    const catalog_param_t * params;
+    std::size_t params_count;
+};
+
+/**
+ * @brief Find a catalog entry by message id.
+ *
+ * @return Null if there is no such message.
+ */
+template < std::size_t N >
+constexpr const catalog_entry_t * find_catalog_entry(
+    const catalog_entry_t ( &entries )[ N ], std::uint32_t id ) noexcept
+{
+    for( const auto & e : entries )
+    {
+        if( e.id == id )
+        {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+//
+// catalog_message_t
+//
+
+/**
+ * @brief A deferred message of a catalog.
+ *
+ * It is a deferred message (see `deferred_format()`) which passes
+ * the message id to a visitor (see `on_catalog_id()`),
+ * so a backend (e.g. `binary_logger_t`) can keep the id
+ * with the captured arguments. Rendered text is produced by
+ * the compiled format of the message.
+ *
+ * @tparam Msg          Message descriptor (generated `<name>_msg_t`).
+ * @tparam Stored_Args  Types of captured arguments.
+ */
+template < typename Msg, typename... Stored_Args >
+class catalog_message_t
+{
+public:
+    using char_t = char;
+    using view_t = basic_deferred_message_view_t< char_t >;
+
+    constexpr explicit catalog_message_t( const Stored_Args &... args ) noexcept
+        : m_args{ args... }
+    {
+    }
+
+    /**
+     * @brief Get a type erased view of this message.
+     */
+    view_t view() const noexcept
+    {
+        return view_t{ this,
+                       sizeof( catalog_message_t ),
+                       alignof( catalog_message_t ),
+                       &catalog_message_t::format,
+                       &catalog_message_t::visit };
+    }
+
+private:
+    static void format( const void * data, typename view_t::buffer_t & out )
+    {
+        const auto & self = *static_cast< const catalog_message_t * >( data );
+        self.m_args.apply(
+            [ & ]( const auto &... args ) { Msg::format_to( out, args... ); } );
+    }
+
+    static void visit( const void * data, typename view_t::visitor_t & visitor )
+    {
+        const auto & self = *static_cast< const catalog_message_t * >( data );
+        visitor.on_catalog_id( Msg::id );
+        visitor.on_format( Msg::format );
+
+        self.m_args.apply( [ & ]( const auto &... args ) {
+            ( details::visit_deferred_arg( visitor, args ), ... );
+        } );
+    }
+
+    details::deferred_args_pack_t< Stored_Args... > m_args;
+};
+
+template < typename Msg, typename... Stored_Args >
+struct is_deferred_message< catalog_message_t< Msg, Stored_Args... > >
+    : public std::true_type
+{
+};
+
+/**
+ * @brief Make a message producer for a catalog message
+ *        (used by generated functions).
+ *
+ * If all the params can be captured (see `deferred_arg_traits_t`)
+ * it is a `catalog_message_t`, so the id reaches the backend.
+ * Otherwise it is a message builder rendering the text
+ * (and the id is not passed on).
+ *
+ * @tparam Msg  Message descriptor (generated `<name>_msg_t`).
+ */
+template < typename Msg, typename... Params >
+auto make_catalog_message( const Params &... params )
+{
+    if constexpr( ( details::is_deferred_capturable_v< Params > && ... ) )
+    {
+        return catalog_message_t< Msg, details::deferred_stored_t< Params >... >{
+            deferred_arg_traits_t< Params >::capture( params )...
+        };
+    }
+    else
+    {
+        return [ & ]( auto out ) { Msg::format_to( out.buf(), params... ); };
+    }
+}
+
+} /* namespace logr */
@@ -0,0 +1,492 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A text file backend writing messages through a memory mapping
+ * of a preallocated file (POSIX only).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <logr/group_commit.hpp>
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+//
+// mmap_file_logger_t
+//
+
+/**
+ * @brief A logger writing text lines to a file through `mmap()`.
+ *
+ * The file is preallocated in chunks and the current chunk (a window)
+ * is mapped to memory. A message is written by reserving space
+ * in the window with an atomic add and copying the line there,
+ * so there is neither a syscall nor a lock per message.
+ * Only when the window is full a writer takes a mutex
+ * to map the next one.
+ *
+ * The file has a preallocated zero-filled tail until `log_flush()`
+ * or destruction, which unmap the window and truncate the file
+ * to the written data (the next message maps a new window).
+ *
+ * Messages are appended to the existing content of the file.
+ * If a process crashes the file keeps a zero-filled tail,
+ * so the tail is cut off when the file is opened again.
+ *
+ * A thread logging a message at or above a durable level (if set)
+ * waits until the message is on disk, concurrent durable messages
+ * share a single `fdatasync()` (see `group_commit_t`).
+ * With a durable level set `log_flush()` is a commit point as well.
+ */
+template < typename Logger_Traits =
+               basic_logger_traits_t< 1024,
+                                      char,
+                                      std::allocator< char >,
+                                      mt_log_level_driver_t<> > >
+class mmap_file_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "mmap file logger supports only char messages" );
+
+    //! Default size of a preallocated chunk.
+    static constexpr std::size_t default_chunk_size = 16 * 1024 * 1024;
+
+    /**
+     * @brief Open (or create) a file and map the first window.
+     *
+     * @param path           A path to the file.
+     * @param level          Log level of the logger.
+     * @param chunk_size     Size of a preallocated window
+     *                       (rounded up to a page size).
+     * @param durable_level  Level of messages to wait to be on disk
+     *                       (`nolog` means none).
+     *
+     * Throws `std::system_error` if the file cannot be opened or mapped.
+     */
+    explicit mmap_file_logger_t(
+        const std::string & path,
+        log_message_level level         = log_message_level::info,
+        std::size_t chunk_size          = default_chunk_size,
+        log_message_level durable_level = log_message_level::nolog )
+        : base_type_t{ level }
+        , m_page_size{ static_cast< std::size_t >( ::sysconf( _SC_PAGESIZE ) ) }
+        , m_chunk_size{ round_up( std::max( chunk_size, m_page_size ) ) }
+        , m_durable_level{ durable_level }
+    {
+        m_fd = ::open( path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+        if( -1 == m_fd )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "open() failed" };
+        }
+
+        struct stat st;
+        if( -1 == ::fstat( m_fd, &st ) )
+        {
+            const auto err = errno;
+            ::close( m_fd );
+            throw std::system_error{ err,
+                                     std::system_category(),
+                                     "fstat() failed" };
+        }
+        try
+        {
+            m_data_end = find_data_end( static_cast< std::size_t >( st.st_size ) );
+            if( m_data_end != static_cast< std::size_t >( st.st_size )
+                && -1 == ::ftruncate( m_fd, static_cast< off_t >( m_data_end ) ) )
+            {
+                throw std::system_error{ errno,
+                                         std::system_category(),
+                                         "ftruncate() failed" };
+            }
+
+            open_window( 0 );
+        }
+        catch( ... )
+        {
+            ::close( m_fd );
+            throw;
+        }
+    }
+
+    ~mmap_file_logger_t() override
+    {
+        close_window();
+        [[maybe_unused]] const auto rc =
+            ::ftruncate( m_fd, static_cast< off_t >( m_data_end ) );
+        ::close( m_fd );
+    }
+
+    mmap_file_logger_t( const mmap_file_logger_t & ) = delete;
+    mmap_file_logger_t & operator=( const mmap_file_logger_t & ) = delete;
+
+private:
+    //! A value of reserved position meaning there is no window to write to.
+    static constexpr std::size_t window_closed =
+        std::numeric_limits< std::size_t >::max() / 2;
+
+    std::size_t round_up( std::size_t size ) const noexcept
+    {
+        return ( size + m_page_size - 1 ) / m_page_size * m_page_size;
+    }
+
+    static constexpr std::string_view level_prefix(
+        log_message_level level ) noexcept
+    {
+        switch( level )
+        {
+            case log_message_level::trace:
+                return "TRACE: ";
+            case log_message_level::debug:
+                return "DEBUG: ";
+            case log_message_level::info:
+                return "INFO : ";
+            case log_message_level::warn:
+                return "WARN : ";
+            case log_message_level::error:
+                return "ERR  : ";
+            default:
+                return "CRIT : ";
+        }
+    }
+
+    void write_line( log_message_level level,
+                     const src_location_t * src_location,
+                     string_view_t message )
+    {
+        ::fmt::basic_memory_buffer< char, 256 > suffix;
+        if( nullptr != src_location )
+        {
+            ::fmt::format_to( ::fmt::appender( suffix ),
+                              " @ {}({})",
+                              src_location->file,
+                              src_location->line );
+        }
+        suffix.push_back( '\n' );
+
+        const auto prefix = level_prefix( level );
+        const auto size   = prefix.size() + message.size() + suffix.size();
+
+        for( ;; )
+        {
+            // Rollover waits for writers, so the window
+            // stays mapped while m_writers is not zero.
+            m_writers.fetch_add( 1 );
+            const auto pos         = m_reserved.fetch_add( size );
+            const auto window_size =
+                m_window_size.load( std::memory_order_relaxed );
+
+            if( pos + size <= window_size )
+            {
+                char * p = m_window.load( std::memory_order_relaxed ) + pos;
+                std::memcpy( p, prefix.data(), prefix.size() );
+                p += prefix.size();
+                std::memcpy( p, message.data(), message.size() );
+                p += message.size();
+                std::memcpy( p, suffix.data(), suffix.size() );
+
+                m_writers.fetch_sub( 1, std::memory_order_release );
+                if( level >= m_durable_level )
+                {
+                    // Dirty pages of a mapping are synced as well.
+                    m_commit.commit( m_fd );
+                }
+                return;
+            }
+
+            if( pos <= window_size )
+            {
+                // The only reservation that crosses the end of the window:
+                // data ends here.
+                m_window_end = pos;
+            }
+            m_writers.fetch_sub( 1, std::memory_order_release );
+
+            std::lock_guard lock{ m_mutex };
+            if( m_reserved.load()
+                > m_window_size.load( std::memory_order_relaxed ) )
+            {
+                close_window();
+                open_window( size );
+            }
+        }
+    }
+
+    /**
+     * @brief Find the end of data skipping a zero-filled tail
+     *        of a window left by a crashed process.
+     *
+     * @param size  Size of the file.
+     */
+    std::size_t find_data_end( std::size_t size ) const
+    {
+        std::vector< char > buf( std::min< std::size_t >( size, 64 * 1024 ) );
+        auto end = size;
+        while( 0 != end )
+        {
+            const auto n = std::min( buf.size(), end );
+            const auto rc =
+                ::pread( m_fd, buf.data(), n, static_cast< off_t >( end - n ) );
+            if( rc < 0 && EINTR == errno )
+            {
+                continue;
+            }
+            if( rc < 0 )
+            {
+                throw std::system_error{ errno,
+                                         std::system_category(),
+                                         "pread() failed" };
+            }
+            if( rc != static_cast< ssize_t >( n ) )
+            {
+                throw std::system_error{ EIO,
+                                         std::system_category(),
+                                         "pread() failed" };
+            }
+
+            auto i = n;
+            while( 0 != i && '\0' == buf[ i - 1 ] )
+            {
+                --i;
+            }
+            if( 0 != i )
+            {
+                return end - n + i;
+            }
+            end -= n;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Map a window starting at the end of data.
+     *
+     * Must be called under the lock (or in constructor).
+     *
+     * @param min_size  A size of a line to fit into the window.
+     */
+    void open_window( std::size_t min_size )
+    {
+        const auto offset = m_data_end / m_page_size * m_page_size;
+        const auto start  = m_data_end - offset;
+        const auto size   = std::max( m_chunk_size, round_up( start + min_size ) );
+
+#if defined( __linux__ )
+        // Returns an error code instead of setting errno.
+        const int err = ::posix_fallocate(
+            m_fd, static_cast< off_t >( offset ), static_cast< off_t >( size ) );
+        if( 0 != err )
+        {
+            throw std::system_error{ err,
+                                     std::system_category(),
+                                     "posix_fallocate() failed" };
+        }
+#else
+        if( -1 == ::ftruncate( m_fd, static_cast< off_t >( offset + size ) ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "ftruncate() failed" };
+        }
+#endif
+
+        void * window = ::mmap( nullptr,
+                                size,
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED,
+                                m_fd,
+                                static_cast< off_t >( offset ) );
+        if( MAP_FAILED == window )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "mmap() failed" };
+        }
+
+        m_window.store( static_cast< char * >( window ),
+                        std::memory_order_relaxed );
+        m_window_size.store( size, std::memory_order_relaxed );
+        m_window_offset = offset;
+        m_window_end    = size;
+
+        // Publishes the window to writers.
+        m_reserved.store( start );
+    }
+
+    /**
+     * @brief Stop writers, unmap the window and advance the end of data.
+     *
+     * Must be called under the lock (or in destructor).
+     */
+    void close_window() noexcept
+    {
+        const auto reserved = m_reserved.exchange( window_closed );
+
+        while( 0 != m_writers.load( std::memory_order_acquire ) )
+        {
+            std::this_thread::yield();
+        }
+
+        char * window      = m_window.load( std::memory_order_relaxed );
+        const auto size    = m_window_size.load( std::memory_order_relaxed );
+        if( nullptr == window )
+        {
+            return;
+        }
+
+        const auto used = reserved <= size ? reserved : m_window_end;
+        m_data_end      = m_window_offset + used;
+
+        ::munmap( window, size );
+        m_window.store( nullptr, std::memory_order_relaxed );
+        m_window_size.store( 0, std::memory_order_relaxed );
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_line( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_line( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_line( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_line( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_line( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_line( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_line( log_message_level::critical, &src_location, message );
+    }
+
+    /**
+     * @brief Unmap the window and cut the preallocated tail,
+     *        so the file contains exactly the written lines.
+     */
+    void log_flush() override
+    {
+        std::lock_guard lock{ m_mutex };
+        close_window();
+        if( -1 == ::ftruncate( m_fd, static_cast< off_t >( m_data_end ) ) )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "ftruncate() failed" };
+        }
+
+        if( log_message_level::nolog != m_durable_level )
+        {
+            m_commit.commit( m_fd );
+        }
+    }
+
+    const std::size_t m_page_size;
+    const std::size_t m_chunk_size;
+    const log_message_level m_durable_level;
+
+    int m_fd{ -1 };
+    group_commit_t m_commit;
+
+    //! File offset where written data ends (excluding the current window).
+    std::size_t m_data_end{};
+
+    // Writers read the window after reserving a position
+    // (which is published after the window is set).
+    std::atomic< char * > m_window{ nullptr };
+    std::atomic< std::size_t > m_window_size{};
+    std::size_t m_window_offset{};
+
+    //! Data end within the window set by a writer that hit the end.
+    std::size_t m_window_end{};
+
+    //! Next free position in the window.
+    std::atomic< std::size_t > m_reserved{ window_closed };
+
+    //! Writers copying to the window.
+    std::atomic< std::size_t > m_writers{};
+
+    //! Guards window rollover.
+    std::mutex m_mutex;
+};
+
+} /* namespace logr */
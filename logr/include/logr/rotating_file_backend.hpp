@@ -0,0 +1,652 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A rotating text file backend with rotation done
+ * on a helper thread (POSIX only).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <logr/group_commit.hpp>
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+//
+// rotating_file_logger_t
+//
+
+/**
+ * @brief A logger writing text lines to a file rotated by size or age.
+ *
+ * Lines are written to `path`. When the file grows over `max_size`
+ * (or gets older than `max_age`) it is retired as `path.1`,
+ * older files are shifted (`path.1` becomes `path.2` and so on)
+ * and only `max_files` of them are kept.
+ *
+ * Rotation costs nothing to a logging thread: a helper thread
+ * opens and preallocates the next file ahead of time (as `path.next`),
+ * so switching to it is an atomic pointer swap. Renaming, closing
+ * and handling of the retired file happen on the helper thread.
+ * A writer reserves a range of the file with an atomic add
+ * and writes a line with `pwrite()`, there is no lock per message.
+ *
+ * If the next file is not ready yet (the limit is reached faster
+ * than the helper prepares it) lines go to the current file,
+ * which gets larger than `max_size`.
+ *
+ * A retire handler (if any) is called on the helper thread
+ * with the path of a just retired file (`path.1`), e.g. to compress it.
+ * Files produced by the handler are not shifted or removed.
+ *
+ * A thread logging a message at or above a durable level (if set)
+ * waits until the message is on disk, concurrent durable messages
+ * share a single `fdatasync()` (see `group_commit_t`).
+ *
+ * `log_flush()` waits for a pending rotation to complete
+ * and with a durable level set it is a commit point as well.
+ */
+template < typename Logger_Traits =
+               basic_logger_traits_t< 1024,
+                                      char,
+                                      std::allocator< char >,
+                                      mt_log_level_driver_t<> > >
+class rotating_file_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "Rotating file logger supports only char messages" );
+
+    //! A handler of a retired file (called with its path).
+    using retire_handler_t = std::function< void( const std::string & ) >;
+
+    //! Default max size of a file.
+    static constexpr std::size_t default_max_size = 64 * 1024 * 1024;
+
+    //! Default number of retired files to keep.
+    static constexpr unsigned default_max_files = 5;
+
+    /**
+     * @brief Open (or create) a file to append to.
+     *
+     * @param path            A path to the file.
+     * @param level           Log level of the logger.
+     * @param max_size        Size of a file to rotate it.
+     * @param max_files       Number of retired files to keep.
+     * @param max_age         Age of a file to rotate it (zero means none).
+     * @param retire_handler  A handler of retired files.
+     * @param durable_level   Level of messages to wait to be on disk
+     *                        (`nolog` means none).
+     *
+     * Throws `std::system_error` if the file cannot be opened.
+     */
+    explicit rotating_file_logger_t(
+        std::string path,
+        log_message_level level           = log_message_level::info,
+        std::size_t max_size              = default_max_size,
+        unsigned max_files                = default_max_files,
+        std::chrono::milliseconds max_age = std::chrono::milliseconds::zero(),
+        retire_handler_t retire_handler   = retire_handler_t{},
+        log_message_level durable_level   = log_message_level::nolog )
+        : base_type_t{ level }
+        , m_path{ std::move( path ) }
+        , m_next_path{ m_path + ".next" }
+        , m_max_size{ std::max< std::size_t >( max_size, 1 ) }
+        , m_max_files{ max_files }
+        , m_max_age{ max_age }
+        , m_retire_handler{ std::move( retire_handler ) }
+        , m_durable_level{ durable_level }
+    {
+        auto & seg = m_segments[ 0 ];
+        seg.fd =
+            ::open( m_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644 );
+        if( -1 == seg.fd )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "open() failed" };
+        }
+
+        struct stat st;
+        if( -1 == ::fstat( seg.fd, &st ) )
+        {
+            const auto err = errno;
+            ::close( seg.fd );
+            throw std::system_error{ err,
+                                     std::system_category(),
+                                     "fstat() failed" };
+        }
+
+        const auto size = static_cast< std::uint64_t >( st.st_size );
+        seg.reserved.store( size, std::memory_order_relaxed );
+        preallocate( seg.fd, size );
+
+        // No writer crosses the limit of a file which is already full.
+        m_pending      = size >= m_max_size;
+        m_active_since = std::chrono::steady_clock::now();
+        m_current.store( &seg );
+
+        m_helper = std::thread{ [ this ] { helper_loop(); } };
+    }
+
+    ~rotating_file_logger_t() override
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_helper.join();
+
+        close_segment( *m_current.load() );
+        if( m_next_ready )
+        {
+            close_segment( other_segment() );
+            ::unlink( m_next_path.c_str() );
+        }
+    }
+
+    rotating_file_logger_t( const rotating_file_logger_t & ) = delete;
+    rotating_file_logger_t & operator=( const rotating_file_logger_t & ) =
+        delete;
+
+private:
+    /**
+     * @brief An open file.
+     *
+     * There are two segments (the current one and the one retired
+     * or prepared by the helper), so a writer holding a stale pointer
+     * never touches freed memory.
+     */
+    struct segment_t
+    {
+        int fd{ -1 };
+
+        //! Size of the file including reserved ranges.
+        std::atomic< std::uint64_t > reserved{};
+
+        //! Number of threads using the segment.
+        std::atomic< int > writers{};
+
+        //! Commits of durable messages written to the segment.
+        group_commit_t commit;
+    };
+
+    //! Delay to retry opening the next file.
+    static constexpr std::chrono::seconds retry_delay{ 1 };
+
+    static constexpr std::string_view level_prefix(
+        log_message_level level ) noexcept
+    {
+        switch( level )
+        {
+            case log_message_level::trace:
+                return "TRACE: ";
+            case log_message_level::debug:
+                return "DEBUG: ";
+            case log_message_level::info:
+                return "INFO : ";
+            case log_message_level::warn:
+                return "WARN : ";
+            case log_message_level::error:
+                return "ERR  : ";
+            default:
+                return "CRIT : ";
+        }
+    }
+
+    //! Allocate space for the rest of the file not changing its size.
+    void preallocate( [[maybe_unused]] int fd,
+                      [[maybe_unused]] std::uint64_t size ) noexcept
+    {
+#if defined( __linux__ )
+        if( size < m_max_size )
+        {
+            // Not supported by some file systems, which is fine.
+            ::fallocate( fd,
+                         FALLOC_FL_KEEP_SIZE,
+                         static_cast< off_t >( size ),
+                         static_cast< off_t >( m_max_size - size ) );
+        }
+#endif
+    }
+
+    //! Release preallocated space and close the file.
+    void close_segment( segment_t & seg ) noexcept
+    {
+#if defined( __linux__ )
+        const auto size = seg.reserved.load( std::memory_order_relaxed );
+        if( size < m_max_size )
+        {
+            ::fallocate( seg.fd,
+                         FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                         static_cast< off_t >( size ),
+                         static_cast< off_t >( m_max_size - size ) );
+        }
+#endif
+        ::close( seg.fd );
+        seg.fd = -1;
+    }
+
+    segment_t & other_segment() noexcept
+    {
+        return m_current.load() == &m_segments[ 0 ] ? m_segments[ 1 ]
+                                                    : m_segments[ 0 ];
+    }
+
+    //! Create the next file (on the helper thread).
+    bool open_next_segment() noexcept
+    {
+        auto & seg = other_segment();
+        seg.fd     = ::open( m_next_path.c_str(),
+                         O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                         0644 );
+        if( -1 == seg.fd )
+        {
+            return false;
+        }
+
+        seg.reserved.store( 0, std::memory_order_relaxed );
+        preallocate( seg.fd, 0 );
+        return true;
+    }
+
+    /**
+     * @brief Rename files and close the retired one (on the helper thread).
+     *
+     * The current file is already written as `path.next`.
+     */
+    void retire_segment() noexcept
+    {
+        if( 0 == m_max_files )
+        {
+            ::unlink( m_path.c_str() );
+        }
+        else
+        {
+            for( auto i = m_max_files - 1; i != 0; --i )
+            {
+                ::rename( retired_path( i ).c_str(),
+                          retired_path( i + 1 ).c_str() );
+            }
+            ::rename( m_path.c_str(), retired_path( 1 ).c_str() );
+        }
+        ::rename( m_next_path.c_str(), m_path.c_str() );
+
+        // Wait for writers which got the segment before the swap.
+        auto & seg = other_segment();
+        while( 0 != seg.writers.load( std::memory_order_acquire ) )
+        {
+            std::this_thread::yield();
+        }
+
+        if( log_message_level::nolog != m_durable_level )
+        {
+            // So flush (waiting for retirement) covers the file.
+            seg.commit.commit( seg.fd );
+        }
+        close_segment( seg );
+    }
+
+    std::string retired_path( unsigned index ) const
+    {
+        return m_path + "." + std::to_string( index );
+    }
+
+    //! Make the next segment current (under the mutex).
+    void swap_segments()
+    {
+        m_current.store( &other_segment() );
+        m_active_since = std::chrono::steady_clock::now();
+        m_next_ready   = false;
+        m_pending      = false;
+        m_retire       = true;
+        m_cv.notify_all();
+    }
+
+    //! Whether the current file is too old (under the mutex).
+    bool current_expired()
+    {
+        if( std::chrono::milliseconds::zero() == m_max_age )
+        {
+            return false;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if( now < m_active_since + m_max_age )
+        {
+            return false;
+        }
+
+        if( 0 == m_current.load()->reserved.load( std::memory_order_relaxed ) )
+        {
+            // Don't rotate empty files.
+            m_active_since = now;
+            return false;
+        }
+        return true;
+    }
+
+    void helper_loop()
+    {
+        using clock_t = std::chrono::steady_clock;
+
+        std::unique_lock lock{ m_mutex };
+        auto retry_at      = clock_t::time_point{};
+        bool handle_retire = false;
+        for( ;; )
+        {
+            if( m_retire )
+            {
+                lock.unlock();
+                retire_segment();
+                lock.lock();
+                m_retire      = false;
+                handle_retire = m_retire_handler && 0 != m_max_files;
+                m_cv.notify_all();
+            }
+
+            if( !m_next_ready && !m_stop && clock_t::now() >= retry_at )
+            {
+                lock.unlock();
+                const bool ok = open_next_segment();
+                lock.lock();
+                m_next_ready  = ok;
+                m_open_failed = !ok;
+                retry_at      = ok ? clock_t::time_point{}
+                                   : clock_t::now() + retry_delay;
+                m_cv.notify_all();
+            }
+
+            if( m_next_ready && !m_stop && ( m_pending || current_expired() ) )
+            {
+                swap_segments();
+                continue;
+            }
+
+            if( handle_retire )
+            {
+                handle_retire = false;
+                lock.unlock();
+                try
+                {
+                    m_retire_handler( retired_path( 1 ) );
+                }
+                catch( ... )
+                {
+                }
+                lock.lock();
+                continue;
+            }
+
+            if( m_stop )
+            {
+                break;
+            }
+
+            auto deadline = clock_t::time_point::max();
+            if( !m_next_ready )
+            {
+                deadline = retry_at;
+            }
+            else if( std::chrono::milliseconds::zero() != m_max_age )
+            {
+                deadline = m_active_since + m_max_age;
+            }
+
+            if( clock_t::time_point::max() == deadline )
+            {
+                m_cv.wait( lock );
+            }
+            else
+            {
+                m_cv.wait_until( lock, deadline );
+            }
+        }
+    }
+
+    //! Rotate the segment a writer filled up.
+    void rotate( segment_t * seg )
+    {
+        std::lock_guard lock{ m_mutex };
+        if( seg != m_current.load() || m_stop )
+        {
+            // Rotated by age.
+            return;
+        }
+
+        if( m_next_ready )
+        {
+            swap_segments();
+        }
+        else
+        {
+            m_pending = true;
+            m_cv.notify_all();
+        }
+    }
+
+    static void pwrite_data( int fd,
+                             const char * data,
+                             std::size_t size,
+                             std::uint64_t offset ) noexcept
+    {
+        while( 0 != size )
+        {
+            const auto n =
+                ::pwrite( fd, data, size, static_cast< off_t >( offset ) );
+            if( n < 0 )
+            {
+                if( EINTR == errno )
+                {
+                    continue;
+                }
+                return;
+            }
+            data += n;
+            size -= static_cast< std::size_t >( n );
+            offset += static_cast< std::uint64_t >( n );
+        }
+    }
+
+    /**
+     * @brief Register as a writer of the current segment.
+     *
+     * The check after registering guarantees the helper
+     * doesn't close the segment until the writer is done.
+     */
+    segment_t * acquire_segment() noexcept
+    {
+        for( ;; )
+        {
+            auto * seg = m_current.load();
+            seg->writers.fetch_add( 1 );
+            if( seg == m_current.load() )
+            {
+                return seg;
+            }
+            seg->writers.fetch_sub( 1, std::memory_order_release );
+        }
+    }
+
+    void write_line( log_message_level level,
+                     const src_location_t * src_location,
+                     string_view_t message )
+    {
+        ::fmt::basic_memory_buffer< char, 512 > line;
+        const auto prefix = level_prefix( level );
+        line.append( prefix.data(), prefix.data() + prefix.size() );
+        line.append( message.data(), message.data() + message.size() );
+        if( nullptr != src_location )
+        {
+            ::fmt::format_to( ::fmt::appender( line ),
+                              " @ {}({})",
+                              src_location->file,
+                              src_location->line );
+        }
+        line.push_back( '\n' );
+
+        auto * seg = acquire_segment();
+        const auto offset =
+            seg->reserved.fetch_add( line.size(), std::memory_order_relaxed );
+        pwrite_data( seg->fd, line.data(), line.size(), offset );
+        if( level >= m_durable_level )
+        {
+            seg->commit.commit( seg->fd );
+        }
+        seg->writers.fetch_sub( 1, std::memory_order_release );
+
+        if( offset < m_max_size && offset + line.size() >= m_max_size )
+        {
+            // The only writer crossing the limit.
+            rotate( seg );
+        }
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_line( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_line( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_line( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_line( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_line( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_line( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_line( log_message_level::critical, &src_location, message );
+    }
+
+    void log_flush() override
+    {
+        if( log_message_level::nolog != m_durable_level )
+        {
+            auto * seg = acquire_segment();
+            seg->commit.commit( seg->fd );
+            seg->writers.fetch_sub( 1, std::memory_order_release );
+        }
+
+        // Lines are already written, wait for the rotation.
+        std::unique_lock lock{ m_mutex };
+        m_cv.wait( lock, [ this ] {
+            return !m_retire
+                   && ( m_open_failed || ( !m_pending && m_next_ready ) );
+        } );
+    }
+
+    const std::string m_path;
+    const std::string m_next_path;
+    const std::size_t m_max_size;
+    const unsigned m_max_files;
+    const std::chrono::milliseconds m_max_age;
+    const retire_handler_t m_retire_handler;
+    const log_message_level m_durable_level;
+
+    std::array< segment_t, 2 > m_segments;
+    std::atomic< segment_t * > m_current{ nullptr };
+
+    //! Guards the state of rotation.
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    //! The next segment is open.
+    bool m_next_ready{ false };
+
+    //! The current segment is full, but the next one isn't ready.
+    bool m_pending{ false };
+
+    //! The previous segment is to be retired.
+    bool m_retire{ false };
+
+    //! The next file cannot be opened (retried later).
+    bool m_open_failed{ false };
+
+    bool m_stop{ false };
+    std::chrono::steady_clock::time_point m_active_since;
+
+    std::thread m_helper;
+};
+
+} /* namespace logr */
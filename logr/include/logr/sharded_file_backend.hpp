@@ -0,0 +1,637 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A text backend writing a file per thread and a merge of such files
+ * into a single timeline (POSIX only).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined( __linux__ )
+#    include <sys/syscall.h>
+#endif
+
+#include <fmt/format.h>
+
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+namespace sharded_file
+{
+
+//! Start of a header line of a file.
+inline constexpr std::string_view header_prefix = "# logr shard ";
+
+/**
+ * @brief Get a key of a record line.
+ *
+ * A record line starts with a monotonic timestamp (nanoseconds)
+ * and a sequence number of the record in its shard: `"TS SEQ ..."`.
+ *
+ * @return Whether the line is a record line.
+ */
+inline bool parse_record_key( std::string_view line,
+                              std::uint64_t & timestamp,
+                              std::uint64_t & seq ) noexcept
+{
+    const auto parse_number = [ & ]( std::uint64_t & value ) {
+        std::size_t i = 0;
+        value         = 0;
+        for( ; i < line.size() && '0' <= line[ i ] && line[ i ] <= '9'; ++i )
+        {
+            value = value * 10 + static_cast< std::uint64_t >( line[ i ] - '0' );
+        }
+        if( 0 == i || i == line.size() || ' ' != line[ i ] )
+        {
+            return false;
+        }
+        line.remove_prefix( i + 1 );
+        return true;
+    };
+
+    return parse_number( timestamp ) && parse_number( seq );
+}
+
+/**
+ * @brief Merge shard files into a single timeline.
+ *
+ * Records are streamed with a k-way merge by timestamp
+ * (ties are ordered by input index and sequence number),
+ * so only one record per input is kept in memory.
+ * Header lines (see `header_prefix`) are skipped, lines which are
+ * not record lines (continuation of a multi-line message)
+ * stay with their record.
+ */
+inline void merge( const std::vector< std::istream * > & inputs,
+                   std::ostream & output )
+{
+    struct input_t
+    {
+        std::istream * stream;
+        std::string line;
+        bool has_line{ false };
+
+        void next_line()
+        {
+            do
+            {
+                has_line = static_cast< bool >( std::getline( *stream, line ) );
+            } while( has_line
+                     && 0 == line.rfind( header_prefix, 0 ) );
+        }
+    };
+
+    struct record_t
+    {
+        std::uint64_t timestamp;
+        std::size_t index;
+        std::uint64_t seq;
+        std::string text;
+
+        bool operator>( const record_t & other ) const noexcept
+        {
+            if( timestamp != other.timestamp )
+            {
+                return timestamp > other.timestamp;
+            }
+            if( index != other.index )
+            {
+                return index > other.index;
+            }
+            return seq > other.seq;
+        }
+    };
+
+    std::vector< input_t > in;
+    in.reserve( inputs.size() );
+    for( auto * s : inputs )
+    {
+        in.push_back( input_t{ s, {} } );
+        in.back().next_line();
+    }
+
+    // Read a record with continuation lines.
+    const auto read_record = [ & ]( std::size_t index, record_t & r ) {
+        auto & input = in[ index ];
+        while( input.has_line )
+        {
+            r.index = index;
+            r.text  = std::move( input.line );
+            input.next_line();
+
+            if( !parse_record_key( r.text, r.timestamp, r.seq ) )
+            {
+                // A continuation without its record (a torn head).
+                continue;
+            }
+
+            std::uint64_t ts;
+            std::uint64_t seq;
+            while( input.has_line
+                   && !parse_record_key( input.line, ts, seq ) )
+            {
+                r.text += '\n';
+                r.text += input.line;
+                input.next_line();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    std::priority_queue< record_t, std::vector< record_t >, std::greater<> >
+        heap;
+    for( std::size_t i = 0; i < in.size(); ++i )
+    {
+        record_t r;
+        if( read_record( i, r ) )
+        {
+            heap.push( std::move( r ) );
+        }
+    }
+
+    while( !heap.empty() )
+    {
+        // Top is const, but it is popped right away.
+        auto r = std::move( const_cast< record_t & >( heap.top() ) );
+        heap.pop();
+        output << r.text << '\n';
+
+        const auto index = r.index;
+        if( read_record( index, r ) )
+        {
+            heap.push( std::move( r ) );
+        }
+    }
+}
+
+//! Get a number of a shard unique in the process.
+inline std::uint64_t next_shard_number() noexcept
+{
+    static std::atomic< std::uint64_t > number{ 0 };
+    return number.fetch_add( 1, std::memory_order_relaxed );
+}
+
+/**
+ * @brief Get the number of `fork()` calls the process is a child of
+ *        (counted once `track_forks()` is called).
+ */
+inline std::atomic< std::uint64_t > & fork_generation() noexcept
+{
+    static std::atomic< std::uint64_t > generation{ 0 };
+    return generation;
+}
+
+//! Make `fork()` calls counted by `fork_generation()`.
+inline void track_forks() noexcept
+{
+    static std::once_flag installed;
+    std::call_once( installed, [] {
+        ::pthread_atfork( nullptr, nullptr, [] {
+            fork_generation().fetch_add( 1, std::memory_order_relaxed );
+        } );
+    } );
+}
+
+} /* namespace sharded_file */
+
+//
+// sharded_file_logger_t
+//
+
+/**
+ * @brief A logger writing a file per thread.
+ *
+ * A thread writes to its own file `PREFIX.PID.TID.N.log`
+ * (N is a number of the shard in the process, as thread ids are reused)
+ * through its own buffer, so logging threads share nothing
+ * (the buffer is locked by other threads only on `flush()`).
+ *
+ * Each line starts with a monotonic timestamp (nanoseconds)
+ * and a sequence number of the line in the file:
+ * `"TS SEQ INFO : msg @ file(line)"`. A file starts with a header line
+ * (`"# logr shard ..."`) giving the process and thread ids
+ * and the realtime clock matching the monotonic one.
+ * Use `logr_merge` tool (or `sharded_file::merge()`) to get
+ * a single timeline.
+ *
+ * A child process created with `fork()` doesn't touch the shards
+ * of the parent (their buffered lines are written by the parent),
+ * its threads open new shards.
+ *
+ * Buffered lines are lost on a crash: the logger is not registered
+ * for `install_crash_drain()` and `crash_drain_registration_t` only
+ * flushes it before `fork()` (which it doesn't need, see above).
+ * Call `flush()` at points where losing lines is not acceptable.
+ */
+template < typename Logger_Traits =
+               basic_logger_traits_t< 1024,
+                                      char,
+                                      std::allocator< char >,
+                                      mt_log_level_driver_t<> > >
+class sharded_file_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "Sharded file logger supports only char messages" );
+
+    //! Default size of a thread's buffer to write it.
+    static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+    /**
+     * @brief Create a logger.
+     *
+     * Files are created by threads when they log the first message.
+     * Messages are dropped if a file cannot be created.
+     *
+     * @param prefix       A path prefix of files.
+     * @param level        Log level of the logger.
+     * @param buffer_size  Size of a thread's buffer to write it.
+     */
+    explicit sharded_file_logger_t(
+        std::string prefix,
+        log_message_level level = log_message_level::info,
+        std::size_t buffer_size = default_buffer_size )
+        : base_type_t{ level }
+        , m_prefix{ std::move( prefix ) }
+        , m_buffer_size{ buffer_size }
+    {
+        sharded_file::track_forks();
+        m_generation.store( sharded_file::fork_generation().load(),
+                            std::memory_order_relaxed );
+    }
+
+    ~sharded_file_logger_t() override
+    {
+        forget_parent_shards();
+
+        std::lock_guard lock{ m_shards_mutex };
+        for( auto & s : m_shards )
+        {
+            std::lock_guard shard_lock{ s->mutex };
+            write_shard( *s );
+            ::close( s->fd );
+            s->logger_alive.store( false, std::memory_order_release );
+        }
+    }
+
+    sharded_file_logger_t( const sharded_file_logger_t & ) = delete;
+    sharded_file_logger_t & operator=( const sharded_file_logger_t & ) = delete;
+
+    //! Paths of files created so far.
+    std::vector< std::string > shard_paths() const
+    {
+        std::lock_guard lock{ m_shards_mutex };
+        return m_paths;
+    }
+
+private:
+    /**
+     * @brief A file of a thread.
+     *
+     * The mutex is taken by other threads only for `flush()`.
+     */
+    struct shard_t
+    {
+        std::mutex mutex;
+        int fd{ -1 };
+        ::fmt::memory_buffer buf;
+        std::uint64_t seq{};
+        std::atomic< bool > logger_alive{ true };
+    };
+
+    /**
+     * @brief A reference to a shard kept by the thread.
+     */
+    struct shard_ref_t
+    {
+        const void * logger;
+        std::shared_ptr< shard_t > shard;
+    };
+
+    static std::uint64_t now() noexcept
+    {
+        return static_cast< std::uint64_t >(
+            std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now().time_since_epoch() )
+                .count() );
+    }
+
+    static std::uint64_t thread_id() noexcept
+    {
+#if defined( __linux__ )
+        return static_cast< std::uint64_t >( ::syscall( SYS_gettid ) );
+#else
+        return std::hash< std::thread::id >{}( std::this_thread::get_id() );
+#endif
+    }
+
+    static constexpr std::string_view level_prefix(
+        log_message_level level ) noexcept
+    {
+        switch( level )
+        {
+            case log_message_level::trace:
+                return "TRACE: ";
+            case log_message_level::debug:
+                return "DEBUG: ";
+            case log_message_level::info:
+                return "INFO : ";
+            case log_message_level::warn:
+                return "WARN : ";
+            case log_message_level::error:
+                return "ERR  : ";
+            default:
+                return "CRIT : ";
+        }
+    }
+
+    std::shared_ptr< shard_t > open_shard()
+    {
+        auto shard = std::make_shared< shard_t >();
+
+        const auto pid = static_cast< long >( ::getpid() );
+        const auto tid = thread_id();
+        std::string path;
+        do
+        {
+            path = ::fmt::format( "{}.{}.{}.{}.log",
+                                  m_prefix,
+                                  pid,
+                                  tid,
+                                  sharded_file::next_shard_number() );
+
+            // A shard never shares a file, not even with a file
+            // left by a process with the same pid.
+            shard->fd = ::open(
+                path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644 );
+        } while( -1 == shard->fd && EEXIST == errno );
+
+        const auto realtime =
+            std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::system_clock::now().time_since_epoch() )
+                .count();
+        ::fmt::format_to( ::fmt::appender( shard->buf ),
+                          "{}pid={} tid={} monotonic_ns={} realtime_ns={}\n",
+                          sharded_file::header_prefix,
+                          pid,
+                          tid,
+                          now(),
+                          realtime );
+
+        std::lock_guard lock{ m_shards_mutex };
+        m_shards.push_back( shard );
+        m_paths.push_back( path );
+        return shard;
+    }
+
+    /**
+     * @brief Drop the shards of the parent process in a forked child.
+     *
+     * The parent writes their buffered lines, and their mutexes
+     * might have been locked by the parent's threads.
+     */
+    void forget_parent_shards() noexcept
+    {
+        const auto generation =
+            sharded_file::fork_generation().load( std::memory_order_relaxed );
+        if( generation == m_generation.load( std::memory_order_relaxed ) )
+        {
+            return;
+        }
+
+        std::lock_guard lock{ m_shards_mutex };
+        if( generation == m_generation.load( std::memory_order_relaxed ) )
+        {
+            return;
+        }
+
+        // No shards are opened in the child yet.
+        for( auto & s : m_shards )
+        {
+            ::close( s->fd );
+            s->fd = -1;
+            s->logger_alive.store( false, std::memory_order_relaxed );
+        }
+        m_shards.clear();
+        m_paths.clear();
+        m_generation.store( generation, std::memory_order_relaxed );
+    }
+
+    shard_t & this_thread_shard()
+    {
+        static thread_local std::vector< shard_ref_t > thread_shards;
+
+        forget_parent_shards();
+
+        for( auto & ref : thread_shards )
+        {
+            if( this == ref.logger
+                && ref.shard->logger_alive.load( std::memory_order_relaxed ) )
+            {
+                return *ref.shard;
+            }
+        }
+
+        // Forget shards of destroyed loggers, as the address
+        // might be reused by this logger.
+        thread_shards.erase(
+            std::remove_if( begin( thread_shards ),
+                            end( thread_shards ),
+                            []( const auto & ref ) {
+                                return !ref.shard->logger_alive.load(
+                                    std::memory_order_relaxed );
+                            } ),
+            end( thread_shards ) );
+
+        thread_shards.push_back( shard_ref_t{ this, open_shard() } );
+        return *thread_shards.back().shard;
+    }
+
+    /**
+     * @brief Write the buffer of a shard (under its mutex).
+     *
+     * Errors (other than interruption) are ignored: data is dropped.
+     */
+    static void write_shard( shard_t & s ) noexcept
+    {
+        const char * data = s.buf.data();
+        auto size         = s.buf.size();
+        while( -1 != s.fd && 0 != size )
+        {
+            const auto n = ::write( s.fd, data, size );
+            if( n < 0 )
+            {
+                if( EINTR == errno )
+                {
+                    continue;
+                }
+                break;
+            }
+            data += n;
+            size -= static_cast< std::size_t >( n );
+        }
+        s.buf.clear();
+    }
+
+    void write_line( log_message_level level,
+                     const src_location_t * src_location,
+                     string_view_t message )
+    {
+        auto & s = this_thread_shard();
+        std::lock_guard lock{ s.mutex };
+
+        auto & buf = s.buf;
+        ::fmt::format_to( ::fmt::appender( buf ), "{} {} ", now(), s.seq++ );
+        const auto prefix = level_prefix( level );
+        buf.append( prefix.data(), prefix.data() + prefix.size() );
+        buf.append( message.data(), message.data() + message.size() );
+        if( nullptr != src_location )
+        {
+            ::fmt::format_to( ::fmt::appender( buf ),
+                              " @ {}({})",
+                              src_location->file,
+                              src_location->line );
+        }
+        buf.push_back( '\n' );
+
+        if( buf.size() >= m_buffer_size )
+        {
+            write_shard( s );
+        }
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_line( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_line( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_line( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_line( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_line( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_line( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_line( log_message_level::critical, &src_location, message );
+    }
+
+    /**
+     * @brief Write buffers of all threads.
+     *
+     * Files of finished threads are closed.
+     */
+    void log_flush() override
+    {
+        forget_parent_shards();
+
+        std::lock_guard lock{ m_shards_mutex };
+        m_shards.erase( std::remove_if( begin( m_shards ),
+                                        end( m_shards ),
+                                        []( const auto & s ) {
+                                            std::lock_guard lock{ s->mutex };
+                                            write_shard( *s );
+                                            if( 1 != s.use_count() )
+                                            {
+                                                return false;
+                                            }
+                                            ::close( s->fd );
+                                            return true;
+                                        } ),
+                        end( m_shards ) );
+    }
+
+    const std::string m_prefix;
+    const std::size_t m_buffer_size;
+
+    //! Shards of all threads.
+    mutable std::mutex m_shards_mutex;
+    std::vector< std::shared_ptr< shard_t > > m_shards;
+    std::vector< std::string > m_paths;
+
+    //! Fork generation of the process the shards belong to.
+    std::atomic< std::uint64_t > m_generation{ 0 };
+};
+
+} /* namespace logr */
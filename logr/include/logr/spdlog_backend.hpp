@@ -17,9 +17,14 @@ namespace logr
 // spdlog_logger_traits_t
 //
 
-template < std::size_t Inline_Size, typename Allocator = std::allocator< char > >
+template < std::size_t Inline_Size,
+           typename Allocator        = std::allocator< char >,
+           typename Log_Level_Driver = st_log_level_driver_t >
 struct spdlog_logger_traits_t
-    : public basic_logger_traits_t< Inline_Size, char, Allocator >
+    : public basic_logger_traits_t< Inline_Size,
+                                    char,
+                                    Allocator,
+                                    Log_Level_Driver >
 {
 };
 
@@ -37,14 +42,20 @@ struct spdlog_logger_traits_t
  * interface.
  * @c basic_spdlog_logger_t can be constructed the same way
  * as `spdlog::logger` does.
+ *
+ * Loggers of many components can share levels by using
+ * @c category_log_level_driver_t as @c Log_Level_Driver.
  */
-template < std::size_t Inline_Size, typename Allocator = std::allocator< char > >
+template < std::size_t Inline_Size,
+           typename Allocator        = std::allocator< char >,
+           typename Log_Level_Driver = st_log_level_driver_t >
 class basic_spdlog_logger_t
-    : public basic_logger_t< spdlog_logger_traits_t< Inline_Size, Allocator > >
+    : public basic_logger_t<
+          spdlog_logger_traits_t< Inline_Size, Allocator, Log_Level_Driver > >
 {
 public:
-    using base_type_t =
-        basic_logger_t< spdlog_logger_traits_t< Inline_Size, Allocator > >;
+    using base_type_t = basic_logger_t<
+        spdlog_logger_traits_t< Inline_Size, Allocator, Log_Level_Driver > >;
     using message_container_t = typename base_type_t::message_container_t;
     using string_view_t       = typename base_type_t::string_view_t;
 
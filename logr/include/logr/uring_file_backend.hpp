@@ -0,0 +1,804 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+/**
+ * @file
+ *
+ * A file backend submitting writes through io_uring (Linux only).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include <logr/group_commit.hpp>
+#include <logr/logr.hpp>
+
+namespace logr
+{
+
+namespace details
+{
+
+//
+// io_uring_t
+//
+
+/**
+ * @brief A minimal io_uring wrapper on raw syscalls.
+ *
+ * Not thread safe.
+ */
+class io_uring_t
+{
+public:
+    /**
+     * @brief Set up a ring.
+     *
+     * Throws `std::system_error` if io_uring is not available.
+     */
+    explicit io_uring_t( unsigned entries )
+    {
+        ::io_uring_params params;
+        std::memset( &params, 0, sizeof( params ) );
+
+        m_fd = static_cast< int >(
+            ::syscall( __NR_io_uring_setup, entries, &params ) );
+        if( m_fd < 0 )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "io_uring_setup() failed" };
+        }
+
+        m_sq_ring_size =
+            params.sq_off.array + params.sq_entries * sizeof( std::uint32_t );
+        m_cq_ring_size =
+            params.cq_off.cqes + params.cq_entries * sizeof( ::io_uring_cqe );
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if( single_mmap )
+        {
+            m_sq_ring_size = m_cq_ring_size =
+                std::max( m_sq_ring_size, m_cq_ring_size );
+        }
+
+        m_sq_ring = map( m_sq_ring_size, IORING_OFF_SQ_RING );
+        m_cq_ring = single_mmap ? m_sq_ring
+                                : map( m_cq_ring_size, IORING_OFF_CQ_RING );
+        m_sqes_size = params.sq_entries * sizeof( ::io_uring_sqe );
+        m_sqes      = static_cast< ::io_uring_sqe * >(
+            map( m_sqes_size, IORING_OFF_SQES ) );
+
+        auto * sq    = static_cast< char * >( m_sq_ring );
+        m_sq_head    = field( sq + params.sq_off.head );
+        m_sq_tail    = field( sq + params.sq_off.tail );
+        m_sq_mask    = *field( sq + params.sq_off.ring_mask );
+        m_sq_entries = params.sq_entries;
+        m_sq_array   = reinterpret_cast< unsigned * >( sq + params.sq_off.array );
+        m_sqe_tail   = m_sq_tail->load( std::memory_order_relaxed );
+
+        auto * cq = static_cast< char * >( m_cq_ring );
+        m_cq_head = field( cq + params.cq_off.head );
+        m_cq_tail = field( cq + params.cq_off.tail );
+        m_cq_mask = *field( cq + params.cq_off.ring_mask );
+        m_cqes =
+            reinterpret_cast< ::io_uring_cqe * >( cq + params.cq_off.cqes );
+    }
+
+    ~io_uring_t() { release(); }
+
+    io_uring_t( const io_uring_t & ) = delete;
+    io_uring_t & operator=( const io_uring_t & ) = delete;
+
+    /**
+     * @brief Register fixed buffers.
+     *
+     * Throws `std::system_error` on failure.
+     */
+    void register_buffers( const ::iovec * iov, unsigned count )
+    {
+        if( ::syscall( __NR_io_uring_register,
+                       m_fd,
+                       IORING_REGISTER_BUFFERS,
+                       iov,
+                       count )
+            < 0 )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "io_uring_register() failed" };
+        }
+    }
+
+    /**
+     * @brief Get a zeroed submission entry.
+     *
+     * @return Null if the submission queue is full.
+     */
+    ::io_uring_sqe * get_sqe() noexcept
+    {
+        if( m_sqe_tail - m_sq_head->load( std::memory_order_acquire )
+            >= m_sq_entries )
+        {
+            return nullptr;
+        }
+
+        const auto index    = m_sqe_tail & m_sq_mask;
+        m_sq_array[ index ] = index;
+        ++m_sqe_tail;
+
+        auto * sqe = &m_sqes[ index ];
+        std::memset( sqe, 0, sizeof( *sqe ) );
+        return sqe;
+    }
+
+    /**
+     * @brief Submit queued entries and wait for completions.
+     *
+     * @return Negative error code on failure.
+     */
+    int submit( unsigned wait_nr ) noexcept
+    {
+        m_sq_tail->store( m_sqe_tail, std::memory_order_release );
+
+        // Entries left by a failed call are counted as well.
+        const auto to_submit =
+            m_sqe_tail - m_sq_head->load( std::memory_order_acquire );
+
+        for( ;; )
+        {
+            const auto rc = ::syscall( __NR_io_uring_enter,
+                                       m_fd,
+                                       to_submit,
+                                       wait_nr,
+                                       0 != wait_nr ? IORING_ENTER_GETEVENTS : 0,
+                                       nullptr,
+                                       0 );
+            if( rc >= 0 )
+            {
+                return 0;
+            }
+            if( EINTR != errno )
+            {
+                return -errno;
+            }
+        }
+    }
+
+    /**
+     * @brief Handle all available completions.
+     *
+     * @param handle  A callback: `void(const io_uring_cqe&)`.
+     */
+    template < typename Handle >
+    void for_each_completion( Handle && handle )
+    {
+        auto head       = m_cq_head->load( std::memory_order_relaxed );
+        const auto tail = m_cq_tail->load( std::memory_order_acquire );
+        for( ; head != tail; ++head )
+        {
+            handle( m_cqes[ head & m_cq_mask ] );
+        }
+        m_cq_head->store( head, std::memory_order_release );
+    }
+
+private:
+    static std::atomic< unsigned > * field( char * p ) noexcept
+    {
+        static_assert( sizeof( std::atomic< unsigned > ) == sizeof( unsigned ) );
+        return reinterpret_cast< std::atomic< unsigned > * >( p );
+    }
+
+    void * map( std::size_t size, std::uint64_t offset )
+    {
+        void * p = ::mmap( nullptr,
+                           size,
+                           PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE,
+                           m_fd,
+                           static_cast< off_t >( offset ) );
+        if( MAP_FAILED == p )
+        {
+            const auto err = errno;
+            release();
+            throw std::system_error{ err,
+                                     std::system_category(),
+                                     "mmap() failed" };
+        }
+        return p;
+    }
+
+    void release() noexcept
+    {
+        if( nullptr != m_sqes )
+        {
+            ::munmap( m_sqes, m_sqes_size );
+        }
+        if( nullptr != m_cq_ring && m_cq_ring != m_sq_ring )
+        {
+            ::munmap( m_cq_ring, m_cq_ring_size );
+        }
+        if( nullptr != m_sq_ring )
+        {
+            ::munmap( m_sq_ring, m_sq_ring_size );
+        }
+        ::close( m_fd );
+    }
+
+    int m_fd{ -1 };
+
+    void * m_sq_ring{ nullptr };
+    std::size_t m_sq_ring_size{};
+    void * m_cq_ring{ nullptr };
+    std::size_t m_cq_ring_size{};
+    ::io_uring_sqe * m_sqes{ nullptr };
+    std::size_t m_sqes_size{};
+
+    std::atomic< unsigned > * m_sq_head{ nullptr };
+    std::atomic< unsigned > * m_sq_tail{ nullptr };
+    unsigned m_sq_mask{};
+    unsigned m_sq_entries{};
+    unsigned * m_sq_array{ nullptr };
+
+    //! Tail including entries not yet submitted.
+    unsigned m_sqe_tail{};
+
+    std::atomic< unsigned > * m_cq_head{ nullptr };
+    std::atomic< unsigned > * m_cq_tail{ nullptr };
+    unsigned m_cq_mask{};
+    ::io_uring_cqe * m_cqes{ nullptr };
+};
+
+} /* namespace details */
+
+//
+// uring_file_logger_t
+//
+
+/**
+ * @brief A logger writing text lines to a file with io_uring.
+ *
+ * Lines are collected in a set of buffers registered with the ring.
+ * A full buffer is submitted as a write and logging continues
+ * to the next buffer, so at most `buffers_count` writes are in flight
+ * and a caller waits only when all buffers are busy.
+ * Writes have explicit file offsets, so the file gets lines in order
+ * no matter in which order writes complete.
+ *
+ * `log_flush()` submits the current buffer and waits for all writes,
+ * optionally followed by fsync.
+ *
+ * A message at or above a durable level (if set) is written right away
+ * and a logging thread waits until it is on disk, concurrent durable
+ * messages share a single `fdatasync()` (see `group_commit_t`).
+ * With a durable level set `log_flush()` is a commit point as well.
+ *
+ * If io_uring is not available (old kernel, seccomp), buffers are
+ * written with `pwrite()`.
+ *
+ * The current buffer and writes in flight are lost on a crash
+ * (unless a durable level covers the line). The logger doesn't
+ * register itself for `install_crash_drain()`, wrap it in
+ * `crash_drain_registration_t` so that a child created with `fork()`
+ * doesn't inherit a half-filled buffer.
+ */
+template < typename Logger_Traits =
+               basic_logger_traits_t< 1024,
+                                      char,
+                                      std::allocator< char >,
+                                      mt_log_level_driver_t<> > >
+class uring_file_logger_t final : public basic_logger_t< Logger_Traits >
+{
+public:
+    using base_type_t   = basic_logger_t< Logger_Traits >;
+    using string_view_t = typename base_type_t::string_view_t;
+
+    static_assert( std::is_same_v< typename Logger_Traits::char_t, char >,
+                   "io_uring file logger supports only char messages" );
+
+    //! Default size of a buffer.
+    static constexpr std::size_t default_buffer_size = 256 * 1024;
+
+    //! Default number of buffers (max writes in flight).
+    static constexpr unsigned default_buffers_count = 4;
+
+    /**
+     * @brief Open (or create) a file to append to.
+     *
+     * @param path            A path to the file.
+     * @param level           Log level of the logger.
+     * @param fsync_on_flush  Whether `log_flush()` does fsync.
+     * @param buffer_size     Size of a buffer.
+     * @param buffers_count   Number of buffers.
+     * @param durable_level   Level of messages to wait to be on disk
+     *                        (`nolog` means none).
+     *
+     * Throws `std::system_error` if the file cannot be opened.
+     */
+    explicit uring_file_logger_t(
+        const std::string & path,
+        log_message_level level         = log_message_level::info,
+        bool fsync_on_flush             = false,
+        std::size_t buffer_size         = default_buffer_size,
+        unsigned buffers_count          = default_buffers_count,
+        log_message_level durable_level = log_message_level::nolog )
+        : base_type_t{ level }
+        , m_fsync_on_flush{ fsync_on_flush }
+        , m_durable_level{ durable_level }
+        , m_buffer_size{ std::max< std::size_t >( buffer_size, 64 ) }
+        , m_buffers( std::max( buffers_count, 2U ) )
+        , m_data{ new char[ m_buffer_size * m_buffers.size() ] }
+    {
+        m_fd = ::open( path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644 );
+        if( -1 == m_fd )
+        {
+            throw std::system_error{ errno,
+                                     std::system_category(),
+                                     "open() failed" };
+        }
+
+        struct stat st;
+        if( -1 == ::fstat( m_fd, &st ) )
+        {
+            const auto err = errno;
+            ::close( m_fd );
+            throw std::system_error{ err,
+                                     std::system_category(),
+                                     "fstat() failed" };
+        }
+        m_file_offset = static_cast< std::uint64_t >( st.st_size );
+
+        std::vector< ::iovec > iov;
+        for( std::size_t i = 0; i < m_buffers.size(); ++i )
+        {
+            m_buffers[ i ].data = m_data.get() + i * m_buffer_size;
+            iov.push_back( ::iovec{ m_buffers[ i ].data, m_buffer_size } );
+        }
+
+        try
+        {
+            // Room for all buffers and fsync.
+            m_ring.emplace( static_cast< unsigned >( m_buffers.size() + 1 ) );
+        }
+        catch( const std::system_error & )
+        {
+            // Fall back to pwrite().
+            return;
+        }
+
+        try
+        {
+            m_ring->register_buffers( iov.data(),
+                                      static_cast< unsigned >( iov.size() ) );
+            m_fixed_buffers = true;
+        }
+        catch( const std::system_error & )
+        {
+            // Might exceed locked memory limit, use plain writes.
+        }
+    }
+
+    ~uring_file_logger_t() override
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            submit_current();
+            wait_all();
+        }
+        m_ring.reset();
+        ::close( m_fd );
+    }
+
+    uring_file_logger_t( const uring_file_logger_t & ) = delete;
+    uring_file_logger_t & operator=( const uring_file_logger_t & ) = delete;
+
+    //! Whether writes go through io_uring (and not `pwrite()`).
+    bool uses_io_uring() const noexcept { return m_ring.has_value(); }
+
+private:
+    //! User data of fsync completion.
+    static constexpr std::uint64_t fsync_tag = ~std::uint64_t{ 0 };
+
+    struct buffer_t
+    {
+        char * data{ nullptr };
+
+        //! Filled size.
+        std::size_t size{};
+
+        //! A write of [done, size) is in flight at file_offset.
+        bool in_flight{ false };
+        std::size_t done{};
+        std::uint64_t file_offset{};
+    };
+
+    static constexpr std::string_view level_prefix(
+        log_message_level level ) noexcept
+    {
+        switch( level )
+        {
+            case log_message_level::trace:
+                return "TRACE: ";
+            case log_message_level::debug:
+                return "DEBUG: ";
+            case log_message_level::info:
+                return "INFO : ";
+            case log_message_level::warn:
+                return "WARN : ";
+            case log_message_level::error:
+                return "ERR  : ";
+            default:
+                return "CRIT : ";
+        }
+    }
+
+    /**
+     * @brief Write data at a given offset synchronously.
+     *
+     * Errors (other than interruption) are ignored: data is dropped.
+     */
+    void pwrite_data( const char * data,
+                      std::size_t size,
+                      std::uint64_t offset ) noexcept
+    {
+        while( 0 != size )
+        {
+            const auto n =
+                ::pwrite( m_fd, data, size, static_cast< off_t >( offset ) );
+            if( n < 0 )
+            {
+                if( EINTR == errno )
+                {
+                    continue;
+                }
+                return;
+            }
+            data += n;
+            size -= static_cast< std::size_t >( n );
+            offset += static_cast< std::uint64_t >( n );
+        }
+    }
+
+    //! Queue a write of the rest of a buffer.
+    void queue_write( std::size_t index ) noexcept
+    {
+        auto & b = m_buffers[ index ];
+
+        auto * sqe = m_ring->get_sqe();
+        // There is room for every buffer.
+        sqe->opcode    = m_fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd        = m_fd;
+        sqe->addr      = reinterpret_cast< std::uintptr_t >( b.data + b.done );
+        sqe->len       = static_cast< std::uint32_t >( b.size - b.done );
+        sqe->off       = b.file_offset + b.done;
+        sqe->buf_index = static_cast< std::uint16_t >( index );
+        sqe->user_data = index;
+        b.in_flight    = true;
+    }
+
+    //! Submit the current buffer if it has data and switch to the next one.
+    void submit_current() noexcept
+    {
+        auto & b = m_buffers[ m_current ];
+        if( 0 == b.size || b.in_flight )
+        {
+            // Nothing was written to it since it was submitted.
+            return;
+        }
+
+        b.file_offset = m_file_offset;
+        b.done        = 0;
+        m_file_offset += b.size;
+
+        if( m_ring )
+        {
+            queue_write( m_current );
+            m_ring->submit( 0 );
+        }
+        else
+        {
+            pwrite_data( b.data, b.size, b.file_offset );
+            b.size = 0;
+        }
+
+        m_current = ( m_current + 1 ) % m_buffers.size();
+    }
+
+    //! Handle completions, resubmitting short writes.
+    void reap() noexcept
+    {
+        bool resubmit = false;
+        m_ring->for_each_completion( [ & ]( const ::io_uring_cqe & cqe ) {
+            if( fsync_tag == cqe.user_data )
+            {
+                m_fsync_in_flight = false;
+                return;
+            }
+
+            auto & b = m_buffers[ cqe.user_data ];
+            if( -EAGAIN == cqe.res || -EINTR == cqe.res )
+            {
+                queue_write( cqe.user_data );
+                resubmit = true;
+                return;
+            }
+            if( cqe.res > 0 && b.done + cqe.res < b.size )
+            {
+                b.done += static_cast< std::size_t >( cqe.res );
+                queue_write( cqe.user_data );
+                resubmit = true;
+                return;
+            }
+
+            // Written (or failed: data is dropped).
+            b.in_flight = false;
+            b.size      = 0;
+        } );
+
+        if( resubmit )
+        {
+            m_ring->submit( 0 );
+        }
+    }
+
+    //! Wait for a completion.
+    void wait_completion() noexcept
+    {
+        if( 0 != m_ring->submit( 1 ) )
+        {
+            // Nothing to do but spin on completions.
+            std::this_thread::yield();
+        }
+        reap();
+    }
+
+    //! Wait until the current buffer can be filled.
+    void wait_current() noexcept
+    {
+        if( !m_buffers[ m_current ].in_flight )
+        {
+            return;
+        }
+
+        reap();
+        while( m_buffers[ m_current ].in_flight )
+        {
+            wait_completion();
+        }
+    }
+
+    void wait_all() noexcept
+    {
+        if( !m_ring )
+        {
+            return;
+        }
+
+        reap();
+        for( std::size_t i = 0; i < m_buffers.size(); ++i )
+        {
+            while( m_buffers[ i ].in_flight )
+            {
+                wait_completion();
+            }
+        }
+        while( m_fsync_in_flight )
+        {
+            wait_completion();
+        }
+    }
+
+    void write_line( log_message_level level,
+                     const src_location_t * src_location,
+                     string_view_t message )
+    {
+        ::fmt::basic_memory_buffer< char, 512 > line;
+        const auto prefix = level_prefix( level );
+        line.append( prefix.data(), prefix.data() + prefix.size() );
+        line.append( message.data(), message.data() + message.size() );
+        if( nullptr != src_location )
+        {
+            ::fmt::format_to( ::fmt::appender( line ),
+                              " @ {}({})",
+                              src_location->file,
+                              src_location->line );
+        }
+        line.push_back( '\n' );
+
+        {
+            std::lock_guard lock{ m_mutex };
+            append_line( line.data(), line.size() );
+            if( level < m_durable_level )
+            {
+                return;
+            }
+
+            // Write it now, don't wait for the buffer to fill.
+            const auto index = m_current;
+            submit_current();
+            while( m_ring && m_buffers[ index ].in_flight )
+            {
+                wait_completion();
+            }
+        }
+
+        m_commit.commit( m_fd );
+    }
+
+    //! Add a line to the current buffer (under the mutex).
+    void append_line( const char * data, std::size_t size )
+    {
+        // Current buffer might be the one submitted before.
+        wait_current();
+        if( m_buffers[ m_current ].size + size > m_buffer_size )
+        {
+            submit_current();
+        }
+
+        if( size > m_buffer_size )
+        {
+            // Doesn't fit a buffer, write it directly at its offset.
+            pwrite_data( data, size, m_file_offset );
+            m_file_offset += size;
+            return;
+        }
+
+        wait_current();
+        auto & b = m_buffers[ m_current ];
+        std::memcpy( b.data + b.size, data, size );
+        b.size += size;
+    }
+
+    void log_message_trace( string_view_t message ) override
+    {
+        write_line( log_message_level::trace, nullptr, message );
+    }
+
+    void log_message_trace( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::trace, &src_location, message );
+    }
+
+    void log_message_debug( string_view_t message ) override
+    {
+        write_line( log_message_level::debug, nullptr, message );
+    }
+
+    void log_message_debug( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::debug, &src_location, message );
+    }
+
+    void log_message_info( string_view_t message ) override
+    {
+        write_line( log_message_level::info, nullptr, message );
+    }
+
+    void log_message_info( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::info, &src_location, message );
+    }
+
+    void log_message_warn( string_view_t message ) override
+    {
+        write_line( log_message_level::warn, nullptr, message );
+    }
+
+    void log_message_warn( src_location_t src_location,
+                           string_view_t message ) override
+    {
+        write_line( log_message_level::warn, &src_location, message );
+    }
+
+    void log_message_error( string_view_t message ) override
+    {
+        write_line( log_message_level::error, nullptr, message );
+    }
+
+    void log_message_error( src_location_t src_location,
+                            string_view_t message ) override
+    {
+        write_line( log_message_level::error, &src_location, message );
+    }
+
+    void log_message_critical( string_view_t message ) override
+    {
+        write_line( log_message_level::critical, nullptr, message );
+    }
+
+    void log_message_critical( src_location_t src_location,
+                               string_view_t message ) override
+    {
+        write_line( log_message_level::critical, &src_location, message );
+    }
+
+    /**
+     * @brief Write the current buffer and wait for all writes.
+     *
+     * With fsync enabled, fsync is submitted with `IOSQE_IO_DRAIN`,
+     * so it starts after all previously submitted writes complete.
+     */
+    void log_flush() override
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            submit_current();
+
+            if( m_fsync_on_flush )
+            {
+                if( m_ring )
+                {
+                    auto * sqe        = m_ring->get_sqe();
+                    sqe->opcode       = IORING_OP_FSYNC;
+                    sqe->fd           = m_fd;
+                    sqe->flags        = IOSQE_IO_DRAIN;
+                    sqe->user_data    = fsync_tag;
+                    m_fsync_in_flight = true;
+                    m_ring->submit( 0 );
+                }
+                else
+                {
+                    ::fsync( m_fd );
+                }
+            }
+
+            wait_all();
+        }
+
+        if( !m_fsync_on_flush && log_message_level::nolog != m_durable_level )
+        {
+            m_commit.commit( m_fd );
+        }
+    }
+
+    const bool m_fsync_on_flush;
+    const log_message_level m_durable_level;
+    const std::size_t m_buffer_size;
+
+    int m_fd{ -1 };
+    group_commit_t m_commit;
+
+    std::mutex m_mutex;
+
+    std::vector< buffer_t > m_buffers;
+    std::unique_ptr< char[] > m_data;
+
+    //! A buffer being filled.
+    std::size_t m_current{};
+
+    //! File offset for the next write.
+    std::uint64_t m_file_offset{};
+
+    std::optional< details::io_uring_t > m_ring;
+    bool m_fixed_buffers{ false };
+    bool m_fsync_in_flight{ false };
+};
+
+} /* namespace logr */
@@ -0,0 +1,589 @@
+// Check async logger adapter delivers messages to its backend.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined( __linux__ )
+#    include <poll.h>
+#endif
+
+#include <logr/async_backend.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using mock_logger_t  = StrictMock< logr_test::logger_mock_t<> >;
+using async_logger_t = logr::async_logger_t< mock_logger_t >;
+
+TEST( LogrAsyncBackend, MessagesAreDeliveredInOrder )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+    {
+        // Error and critical messages go through the priority lane.
+        Sequence normal, priority;
+
+        EXPECT_CALL( backend, log_message_trace( std::string_view{ "msg 1" } ) )
+            .InSequence( normal );
+        EXPECT_CALL( backend, log_message_debug( _, std::string_view{ "msg 2" } ) )
+            .InSequence( normal );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "msg 3" } ) )
+            .InSequence( normal );
+        EXPECT_CALL( backend, log_message_warn( std::string_view{ "msg 4 42" } ) )
+            .InSequence( normal );
+        EXPECT_CALL( backend, log_message_error( _, std::string_view{ "msg 5" } ) )
+            .InSequence( priority );
+        EXPECT_CALL( backend, log_message_critical( std::string_view{ "msg 6" } ) )
+            .InSequence( priority );
+        EXPECT_CALL( backend, log_flush() ).InSequence( normal, priority );
+    }
+
+    logger.trace( "msg 1" );
+    logger.debug( LOGR_SRC_LOCATION, "msg 2" );
+    logger.info( []() { return "msg 3"; } );
+    logger.warn( []( auto out ) { format_to( out, "msg 4 {}", 42 ); } );
+    logger.error( LOGR_SRC_LOCATION, "msg 5" );
+    logger.critical( "msg 6" );
+    logger.flush();
+
+    Mock::VerifyAndClearExpectations( &backend );
+
+    // Final flush on destruction.
+    EXPECT_CALL( backend, log_flush() ).Times( AtMost( 1 ) );
+}
+
+TEST( LogrAsyncBackend, SrcLocationIsPreserved )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    const logr::src_location_t src_location{ "file.cpp", 42 };
+
+    EXPECT_CALL( backend,
+                 log_message_info( AllOf( Field( &logr::src_location_t::file,
+                                                 StrEq( "file.cpp" ) ),
+                                          Field( &logr::src_location_t::line, 42 ) ),
+                                   std::string_view{ "msg" } ) );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    logger.info( src_location, "msg" );
+    logger.flush();
+}
+
+TEST( LogrAsyncBackend, LevelIsCheckedOnProducerSide )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::warn,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    bool cb_was_called = false;
+
+    EXPECT_CALL( backend, log_message_warn( std::string_view{ "warn" } ) );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    logger.info( [ & ]() {
+        cb_was_called = true;
+        return "info";
+    } );
+    logger.warn( "warn" );
+    logger.flush();
+
+    ASSERT_FALSE( cb_was_called );
+}
+
+//
+// check_many_producers()
+//
+
+/**
+ * @brief Log from several threads and check every thread's messages
+ *        are delivered in order.
+ */
+template < typename Async_Logger >
+void check_many_producers()
+{
+    constexpr int threads_count       = 4;
+    constexpr int messages_per_thread = 10000;
+
+    // A small queue makes producers wait for the consumer.
+    Async_Logger logger{ logr::log_message_level::trace,
+                         64,
+                         logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    std::vector< int > last_seen( threads_count, -1 );
+    bool order_is_ok = true;
+
+    EXPECT_CALL( backend, log_message_info( An< std::string_view >() ) )
+        .Times( threads_count * messages_per_thread )
+        .WillRepeatedly( [ & ]( std::string_view msg ) {
+            // Message is "<thread> <n>".
+            const auto space = msg.find( ' ' );
+            const int t      = std::stoi( std::string{ msg.substr( 0, space ) } );
+            const int n      = std::stoi( std::string{ msg.substr( space + 1 ) } );
+            order_is_ok      = order_is_ok && last_seen[ t ] + 1 == n;
+            last_seen[ t ]   = n;
+        } );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    std::vector< std::thread > producers;
+    for( int t = 0; t < threads_count; ++t )
+    {
+        producers.emplace_back( [ &logger, t ] {
+            for( int n = 0; n < messages_per_thread; ++n )
+            {
+                logger.info( [ & ]( auto out ) { format_to( out, "{} {}", t, n ); } );
+            }
+        } );
+    }
+
+    for( auto & p : producers )
+    {
+        p.join();
+    }
+
+    logger.flush();
+
+    ASSERT_TRUE( order_is_ok );
+    for( const auto n : last_seen )
+    {
+        ASSERT_EQ( n, messages_per_thread - 1 );
+    }
+}
+
+using per_thread_async_logger_t =
+    logr::async_logger_t< mock_logger_t, logr::per_thread_async_logger_traits_t >;
+
+TEST( LogrAsyncBackend, ManyProducers )  // NOLINT
+{
+    check_many_producers< async_logger_t >();
+}
+
+TEST( LogrAsyncBackend, ManyProducersPerThreadQueues )  // NOLINT
+{
+    check_many_producers< per_thread_async_logger_t >();
+}
+
+//
+// check_flush_is_barrier()
+//
+
+/**
+ * @brief Log and flush from several threads and check
+ *        that flush delivers all messages logged before it.
+ */
+template < typename Async_Logger >
+void check_flush_is_barrier()
+{
+    constexpr int threads_count      = 4;
+    constexpr int rounds_count       = 200;
+    constexpr int messages_per_round = 20;
+
+    Async_Logger logger{ logr::log_message_level::trace,
+                         1024,
+                         logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    std::vector< std::atomic< int > > delivered( threads_count );
+
+    EXPECT_CALL( backend, log_message_info( An< std::string_view >() ) )
+        .Times( threads_count * rounds_count * messages_per_round )
+        .WillRepeatedly( [ & ]( std::string_view msg ) {
+            // Message is "<thread> <n>".
+            const auto space = msg.find( ' ' );
+            const int t      = std::stoi( std::string{ msg.substr( 0, space ) } );
+            delivered[ t ].fetch_add( 1, std::memory_order_relaxed );
+        } );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    std::atomic< int > lost{ 0 };
+    std::vector< std::thread > producers;
+    for( int t = 0; t < threads_count; ++t )
+    {
+        producers.emplace_back( [ &, t ] {
+            int n = 0;
+            for( int r = 0; r < rounds_count; ++r )
+            {
+                for( int i = 0; i < messages_per_round; ++i, ++n )
+                {
+                    logger.info(
+                        [ & ]( auto out ) { format_to( out, "{} {}", t, n ); } );
+                }
+
+                logger.flush();
+                if( delivered[ t ].load( std::memory_order_relaxed ) != n )
+                {
+                    lost.fetch_add( 1, std::memory_order_relaxed );
+                }
+            }
+        } );
+    }
+
+    for( auto & p : producers )
+    {
+        p.join();
+    }
+
+    ASSERT_EQ( lost.load(), 0 );
+}
+
+TEST( LogrAsyncBackend, FlushIsBarrier )  // NOLINT
+{
+    check_flush_is_barrier< async_logger_t >();
+}
+
+TEST( LogrAsyncBackend, FlushIsBarrierPerThreadQueues )  // NOLINT
+{
+    check_flush_is_barrier< per_thread_async_logger_t >();
+}
+
+template < typename Wait_Strategy >
+struct wait_traits_t : public logr::async_logger_traits_t
+{
+    using wait_strategy_t = Wait_Strategy;
+};
+
+TEST( LogrAsyncBackend, ManyProducersBusySpin )  // NOLINT
+{
+    check_many_producers< logr::async_logger_t<
+        mock_logger_t,
+        wait_traits_t< logr::busy_spin_wait_strategy_t > > >();
+}
+
+TEST( LogrAsyncBackend, ManyProducersYielding )  // NOLINT
+{
+    check_many_producers< logr::async_logger_t<
+        mock_logger_t,
+        wait_traits_t< logr::yielding_wait_strategy_t<> > > >();
+}
+
+TEST( LogrAsyncBackend, ConsumerAffinity )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    EXPECT_CALL( logger.backend(), log_flush() ).Times( AnyNumber() );
+
+    ASSERT_FALSE( logger.set_consumer_affinity( {} ) );
+    ASSERT_FALSE( logger.set_consumer_affinity( { -1 } ) );
+#if defined( __linux__ )
+    cpu_set_t allowed;
+    ASSERT_EQ( 0, sched_getaffinity( 0, sizeof( allowed ), &allowed ) );
+    int pinned_cpu = -1;
+    for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+    {
+        if( CPU_ISSET( cpu, &allowed ) )
+        {
+            ASSERT_TRUE( logger.set_consumer_affinity( { cpu } ) );
+            pinned_cpu = cpu;
+            break;
+        }
+    }
+    ASSERT_NE( pinned_cpu, -1 );
+
+    // The consumer restarted after fork() keeps the affinity.
+    logger.fork_prepare();
+    logger.fork_parent();
+
+    cpu_set_t consumer_cpus;
+    CPU_ZERO( &consumer_cpus );
+    EXPECT_CALL( logger.backend(), log_message_info( An< std::string_view >() ) )
+        .WillOnce( [ & ]( std::string_view ) {
+            sched_getaffinity( 0, sizeof( consumer_cpus ), &consumer_cpus );
+        } );
+    logger.info( "test [raw message]" );
+    logger.flush();
+
+    EXPECT_EQ( CPU_COUNT( &consumer_cpus ), 1 );
+    EXPECT_TRUE( CPU_ISSET( pinned_cpu, &consumer_cpus ) );
+#endif
+}
+
+TEST( LogrAsyncBackend, PerThreadQueuesKeepGlobalOrder )  // NOLINT
+{
+    per_thread_async_logger_t logger{ logr::log_message_level::trace,
+                                      16,
+                                      logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "1" } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "2" } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "3" } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "4" } ) );
+        EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+    }
+
+    // Each message comes from a different thread,
+    // so it lands in a different ring.
+    for( const auto * msg : { "1", "2", "3", "4" } )
+    {
+        std::thread{ [ & ] { logger.info( std::string_view{ msg } ); } }.join();
+    }
+
+    logger.flush();
+}
+
+//
+// check_overflow()
+//
+
+template < logr::async_overflow_policy Policy >
+struct overflow_traits_t : public logr::async_logger_traits_t
+{
+    using overflow_policy_t = logr::uniform_async_overflow_policy_t< Policy >;
+};
+
+/**
+ * @brief Overflow a queue of 2 records while the consumer is busy
+ *        and check which messages reach the backend.
+ */
+template < logr::async_overflow_policy Policy >
+void check_overflow( std::vector< std::string > expected )
+{
+    logr::async_logger_t< mock_logger_t, overflow_traits_t< Policy > > logger{
+        logr::log_message_level::trace, 2, logr::log_message_level::trace
+    };
+
+    auto & backend = logger.backend();
+
+    std::promise< void > consumer_busy;
+    std::promise< void > release_consumer;
+    auto released = release_consumer.get_future().share();
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "busy" } ) )
+            .WillOnce( [ & ]( auto ) {
+                consumer_busy.set_value();
+                released.wait();
+            } );
+
+        for( const auto & msg : expected )
+        {
+            EXPECT_CALL( backend, log_message_info( std::string_view{ msg } ) );
+        }
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "3 messages dropped" } ) );
+        EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+    }
+
+    logger.info( "busy" );
+    consumer_busy.get_future().wait();
+
+    for( const auto * msg : { "1", "2", "3", "4", "5" } )
+    {
+        logger.info( std::string_view{ msg } );
+    }
+
+    ASSERT_EQ( logger.dropped_messages( logr::log_message_level::info ), 3 );
+    ASSERT_EQ( logger.dropped_messages( logr::log_message_level::warn ), 0 );
+
+    release_consumer.set_value();
+    logger.flush();
+}
+
+TEST( LogrAsyncBackend, OverflowDropNewest )  // NOLINT
+{
+    check_overflow< logr::async_overflow_policy::drop_newest >( { "1", "2" } );
+}
+
+TEST( LogrAsyncBackend, OverflowOverwriteOldest )  // NOLINT
+{
+    check_overflow< logr::async_overflow_policy::overwrite_oldest >(
+        { "4", "5" } );
+}
+
+TEST( LogrAsyncBackend, LeveledOverflowPolicy )  // NOLINT
+{
+    using policy_t = logr::leveled_async_overflow_policy_t<
+        logr::log_message_level::warn >;
+
+    static_assert( policy_t::for_level( logr::log_message_level::info )
+                   == logr::async_overflow_policy::drop_newest );
+    static_assert( policy_t::for_level( logr::log_message_level::warn )
+                   == logr::async_overflow_policy::block );
+    static_assert( policy_t::for_level( logr::log_message_level::critical )
+                   == logr::async_overflow_policy::block );
+}
+
+using polled_async_logger_t =
+    logr::async_logger_t< mock_logger_t, logr::polled_async_logger_traits_t >;
+
+/**
+ * @brief Check if notify fd of polled logger is readable.
+ */
+[[maybe_unused]] bool is_notified( const polled_async_logger_t & logger )
+{
+#if defined( __linux__ )
+    pollfd pfd{ logger.notify_fd(), POLLIN, 0 };
+    return 1 == ::poll( &pfd, 1, 0 );
+#else
+    return false;
+#endif
+}
+
+TEST( LogrAsyncBackend, PollDrain )  // NOLINT
+{
+    polled_async_logger_t logger{ logr::log_message_level::trace,
+                                  16,
+                                  logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+#if defined( __linux__ )
+    ASSERT_NE( logger.notify_fd(), -1 );
+    ASSERT_FALSE( is_notified( logger ) );
+#endif
+
+    logger.info( "1" );
+    logger.info( "2" );
+    logger.info( "3" );
+
+    // Nothing is delivered without polling.
+    Mock::VerifyAndClearExpectations( &backend );
+
+#if defined( __linux__ )
+    ASSERT_TRUE( is_notified( logger ) );
+#endif
+
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "1" } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "2" } ) );
+    }
+    ASSERT_EQ( logger.poll_drain( 2 ), 2 );
+    Mock::VerifyAndClearExpectations( &backend );
+
+#if defined( __linux__ )
+    // There is one more message.
+    ASSERT_TRUE( is_notified( logger ) );
+#endif
+
+    EXPECT_CALL( backend, log_message_info( std::string_view{ "3" } ) );
+    ASSERT_EQ( logger.poll_drain( 100, std::chrono::milliseconds{ 10 } ), 1 );
+    Mock::VerifyAndClearExpectations( &backend );
+
+#if defined( __linux__ )
+    ASSERT_FALSE( is_notified( logger ) );
+#endif
+
+    ASSERT_EQ( logger.poll_drain( 100 ), 0 );
+
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_warn( std::string_view{ "4" } ) );
+        EXPECT_CALL( backend, log_flush() );
+    }
+
+    // Flush drains on the calling thread.
+    logger.warn( "4" );
+    logger.flush();
+    Mock::VerifyAndClearExpectations( &backend );
+
+    EXPECT_CALL( backend, log_flush() ).Times( AtMost( 1 ) );
+}
+
+TEST( LogrAsyncBackend, PolledProducerHelpsWhenQueueIsFull )  // NOLINT
+{
+    polled_async_logger_t logger{ logr::log_message_level::trace,
+                                  4,
+                                  logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    EXPECT_CALL( backend, log_message_info( An< std::string_view >() ) )
+        .Times( 100 );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    // Blocking policy: there is no consumer thread to wait for.
+    for( int i = 0; i < 100; ++i )
+    {
+        logger.info( [ & ]( auto out ) { format_to( out, "{}", i ); } );
+    }
+    logger.flush();
+}
+
+TEST( LogrAsyncBackend, PolledDestructorSurvivesThrowingFlush )  // NOLINT
+{
+    polled_async_logger_t logger{ logr::log_message_level::trace,
+                                  16,
+                                  logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "last" } ) );
+        EXPECT_CALL( backend, log_flush() )
+            .WillOnce( Throw( std::runtime_error{ "disk is gone" } ) );
+    }
+
+    // Destructor delivers the message and swallows the exception.
+    logger.info( "last" );
+}
+
+TEST( LogrAsyncBackend, PriorityLaneGoesFirst )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    std::promise< void > consumer_busy;
+    std::promise< void > release_consumer;
+    auto released = release_consumer.get_future().share();
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend,
+                     log_message_critical( std::string_view{ "busy" } ) )
+            .WillOnce( [ & ]( auto ) {
+                consumer_busy.set_value();
+                released.wait();
+            } );
+        EXPECT_CALL( backend, log_message_critical( std::string_view{ "c" } ) );
+        EXPECT_CALL( backend, log_message_error( std::string_view{ "e" } ) );
+        EXPECT_CALL( backend, log_message_debug( std::string_view{ "1" } ) );
+        EXPECT_CALL( backend, log_message_warn( std::string_view{ "2" } ) );
+        EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+    }
+
+    logger.critical( "busy" );
+    consumer_busy.get_future().wait();
+
+    logger.debug( "1" );
+    logger.warn( "2" );
+    logger.critical( "c" );
+    logger.error( "e" );
+
+    release_consumer.set_value();
+    logger.flush();
+}
+
+} /* anonymous namespace */
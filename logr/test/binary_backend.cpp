@@ -0,0 +1,209 @@
+// Check binary logger writes messages the decoder can render back.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <logr/async_backend.hpp>
+#include <logr/binary_backend.hpp>
+
+namespace /* anonymous */
+{
+
+struct point_t
+{
+    int x;
+    int y;
+};
+
+}  // anonymous namespace
+
+template <>
+struct fmt::formatter< point_t > : fmt::formatter< std::string_view >
+{
+    template < typename Format_Context >
+    auto format( const point_t & p, Format_Context & ctx ) const
+    {
+        return fmt::format_to( ctx.out(), "({}, {})", p.x, p.y );
+    }
+};
+
+namespace /* anonymous */
+{
+
+using binary_logger_t = logr::binary_logger_t<>;
+
+std::vector< logr::binary_log::decoded_message_t > decode_all(
+    const std::string & data )
+{
+    std::istringstream in{ data };
+    logr::binary_log::decoder_t decoder{ in };
+
+    std::vector< logr::binary_log::decoded_message_t > res;
+    logr::binary_log::decoded_message_t msg;
+    while( decoder.next( msg ) )
+    {
+        res.push_back( msg );
+    }
+    return res;
+}
+
+TEST( LogrBinaryBackend, MessagesAreDecoded )  // NOLINT
+{
+    std::ostringstream out;
+    {
+        binary_logger_t logger{ out, logr::log_message_level::trace };
+
+        logger.info( logr::deferred_format(
+            "i={} u={} d={:.2f} b={} c={}", -42, 42u, 2.5, true, 'x' ) );
+        logger.warn( logr::src_location_t{ "file.cpp", 7 },
+                     logr::deferred_format( "p={} {:>4}", point_t{ 1, 2 }, 5L ) );
+        logger.error( "literal {}" );
+        logger.debug( [] { return "built"; } );
+        logger.trace( logr::deferred_format( "filtered {}", 1 ) );
+        logger.flush();
+    }
+
+    const auto messages = decode_all( out.str() );
+    ASSERT_EQ( messages.size(), 5 );
+
+    EXPECT_EQ( messages[ 0 ].level, logr::log_message_level::info );
+    EXPECT_EQ( messages[ 0 ].text, "i=-42 u=42 d=2.50 b=true c=x" );
+    EXPECT_EQ( messages[ 0 ].file, "" );
+
+    EXPECT_EQ( messages[ 1 ].level, logr::log_message_level::warn );
+    EXPECT_EQ( messages[ 1 ].text, "p=(1, 2)    5" );
+    EXPECT_EQ( messages[ 1 ].file, "file.cpp" );
+    EXPECT_EQ( messages[ 1 ].line, 7 );
+
+    // A literal is not a format string.
+    EXPECT_EQ( messages[ 2 ].level, logr::log_message_level::error );
+    EXPECT_EQ( messages[ 2 ].text, "literal {}" );
+
+    EXPECT_EQ( messages[ 3 ].level, logr::log_message_level::debug );
+    EXPECT_EQ( messages[ 3 ].text, "built" );
+
+    EXPECT_EQ( messages[ 4 ].text, "filtered 1" );
+
+    const auto now = std::chrono::system_clock::now();
+    for( const auto & msg : messages )
+    {
+        EXPECT_LE( msg.timestamp, now );
+        EXPECT_GT( msg.timestamp, now - std::chrono::minutes{ 1 } );
+    }
+}
+
+TEST( LogrBinaryBackend, CallSiteIsWrittenOnce )  // NOLINT
+{
+    std::ostringstream out;
+    binary_logger_t logger{ out, logr::log_message_level::trace };
+
+    const std::string_view format{ "A long format string of message number {}" };
+    for( int i = 0; i < 100; ++i )
+    {
+        logger.info( logr::deferred_format(
+            "A long format string of message number {}", i ) );
+    }
+
+    const auto data = out.str();
+    const auto first = data.find( format );
+    ASSERT_NE( first, std::string::npos );
+    EXPECT_EQ( data.find( format, first + 1 ), std::string::npos );
+
+    // Far less than the rendered text.
+    EXPECT_LT( data.size(), 100 * format.size() / 2 );
+
+    const auto messages = decode_all( data );
+    ASSERT_EQ( messages.size(), 100 );
+    EXPECT_EQ( messages[ 99 ].text, "A long format string of message number 99" );
+}
+
+TEST( LogrBinaryBackend, BehindAsyncLogger )  // NOLINT
+{
+    std::ostringstream out;
+    {
+        logr::async_logger_t< binary_logger_t > logger{
+            logr::log_message_level::trace, 16, out, logr::log_message_level::trace
+        };
+
+        for( int i = 0; i < 3; ++i )
+        {
+            logger.info( logr::deferred_format( "async {}", i ) );
+        }
+    }
+
+    const auto messages = decode_all( out.str() );
+    ASSERT_EQ( messages.size(), 3 );
+    EXPECT_EQ( messages[ 2 ].text, "async 2" );
+
+    // A single call site.
+    EXPECT_EQ( out.str().find( "async {}" ), out.str().rfind( "async {}" ) );
+}
+
+TEST( LogrBinaryBackend, BadInputIsRejected )  // NOLINT
+{
+    std::istringstream in{ "not a log" };
+    EXPECT_THROW( logr::binary_log::decoder_t{ in }, std::runtime_error );
+
+    std::ostringstream out;
+    {
+        binary_logger_t logger{ out };
+        logger.info( logr::deferred_format( "{}", 1 ) );
+    }
+
+    // Truncated message.
+    auto data = out.str();
+    data.pop_back();
+    EXPECT_THROW( decode_all( data ), std::runtime_error );
+
+    using logr::binary_log::put_string;
+    using logr::binary_log::put_varint;
+
+    std::string header{ logr::binary_log::magic };
+    header.push_back( static_cast< char >( logr::binary_log::version ) );
+
+    std::string call_site = header;
+    call_site.push_back(
+        static_cast< char >( logr::binary_log::record_type::call_site ) );
+    put_varint( call_site, 1 );
+    call_site.push_back( static_cast< char >( logr::log_message_level::info ) );
+    call_site.push_back( 0 );
+
+    // Huge string size.
+    data = call_site;
+    put_varint( data, std::uint64_t{ 1 } << 62 );
+    EXPECT_THROW( decode_all( data ), std::runtime_error );
+
+    // String size beyond the end of data.
+    data = call_site;
+    put_varint( data, 1000000 );
+    data.append( 10, 'x' );
+    EXPECT_THROW( decode_all( data ), std::runtime_error );
+
+    // Huge number of arguments.
+    data = call_site;
+    put_string( data, "{}" );
+    put_string( data, "file.cpp" );
+    put_varint( data, 0 );
+    put_varint( data, std::uint64_t{ 1 } << 40 );
+    EXPECT_THROW( decode_all( data ), std::runtime_error );
+}
+
+TEST( LogrBinaryBackend, FloatIsExact )  // NOLINT
+{
+    std::ostringstream out;
+    {
+        binary_logger_t logger{ out, logr::log_message_level::trace };
+        logger.info( logr::deferred_format( "f={} d={}", 0.1f, 0.1 ) );
+    }
+
+    const auto messages = decode_all( out.str() );
+    ASSERT_EQ( messages.size(), 1 );
+    EXPECT_EQ( messages[ 0 ].text, fmt::format( "f={} d={}", 0.1f, 0.1 ) );
+    EXPECT_EQ( messages[ 0 ].text, "f=0.1 d=0.1" );
+}
+
+}  // anonymous namespace
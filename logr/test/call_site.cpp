@@ -0,0 +1,102 @@
+// Check per call site runtime enable switches.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <logr/logr.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+int debug_site_line{ 0 };
+
+template < typename Logger >
+void log_debug( Logger & logger, int i )
+{
+    debug_site_line = __LINE__ + 1;
+    logger.debug( LOGR_CALL_SITE, [ & ]( auto & out ) {
+        format_to( out, "{} [{}]", "test", i );
+    } );
+}
+
+TEST( LogrCallSite, SiteIsRegistered )  // NOLINT
+{
+    auto & site = LOGR_CALL_SITE;
+    EXPECT_EQ( site.location().line, __LINE__ - 1 );
+    EXPECT_FALSE( site.enabled() );
+
+    // The same site is given for a given place.
+    std::vector< logr::call_site_t * > sites;
+    for( int i = 0; i < 2; ++i )
+    {
+        sites.push_back( &LOGR_CALL_SITE );
+    }
+    EXPECT_EQ( sites[ 0 ], sites[ 1 ] );
+    EXPECT_NE( sites[ 0 ], &site );
+
+    int found{ 0 };
+    logr::call_site_registry_t::instance().for_each(
+        [ & ]( logr::call_site_t & s ) {
+            if( &s == &site || &s == sites[ 0 ] )
+            {
+                EXPECT_EQ( std::string{ s.location().file }, __FILE__ );
+                ++found;
+            }
+        } );
+    EXPECT_EQ( found, 2 );
+}
+
+TEST( LogrCallSite, EnableSite )  // NOLINT
+{
+    logr_test::logger_mock_t<> logger( logr::log_message_level::info );
+    auto & registry = logr::call_site_registry_t::instance();
+
+    EXPECT_CALL( logger, log_message_debug( _, An< std::string_view >() ) )
+        .Times( 0 );
+    log_debug( logger, 0 );
+    Mock::VerifyAndClearExpectations( &logger );
+
+    // Site is registered on start, even before it was first called.
+    EXPECT_EQ( registry.enable( "no_such_file.cpp", debug_site_line ), 0 );
+    EXPECT_EQ( registry.enable( "ll_site.cpp", debug_site_line ), 0 );
+    EXPECT_EQ( registry.enable( "call_site.cpp", debug_site_line ), 1 );
+
+    EXPECT_CALL( logger,
+                 log_message_debug(
+                     Field( &logr::src_location_t::line, debug_site_line ),
+                     std::string_view{ "test [1]" } ) );
+    log_debug( logger, 1 );
+    Mock::VerifyAndClearExpectations( &logger );
+
+    // Other sites are not affected.
+    EXPECT_CALL( logger, log_message_debug( _, An< std::string_view >() ) )
+        .Times( 0 );
+    logger.debug( LOGR_CALL_SITE, "test [raw message]" );
+    Mock::VerifyAndClearExpectations( &logger );
+
+    registry.disable_all();
+    EXPECT_CALL( logger, log_message_debug( _, An< std::string_view >() ) )
+        .Times( 0 );
+    log_debug( logger, 2 );
+}
+
+TEST( LogrCallSite, LoggerLevelStillApplies )  // NOLINT
+{
+    logr_test::logger_mock_t<> logger( logr::log_message_level::info );
+
+    EXPECT_CALL( logger, log_message_info( _, An< std::string_view >() ) )
+        .Times( 2 );
+    EXPECT_CALL( logger, log_message_warn( _, An< std::string_view >() ) );
+
+    logger.info( LOGR_CALL_SITE, "test [raw message]" );
+    logger.info( LOGR_CALL_SITE, []() { return "test [cb]"; } );
+    logger.warn( LOGR_CALL_SITE, std::string_view{ "test [string view]" } );
+}
+
+}  // anonymous namespace
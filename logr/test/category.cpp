@@ -0,0 +1,135 @@
+// Check categories registry and category log level driver.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <logr/category.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using logr::log_message_level;
+
+using category_traits_t =
+    logr::basic_logger_traits_t< 1024,
+                                 char,
+                                 std::allocator< char >,
+                                 logr::category_log_level_driver_t >;
+
+using category_logger_mock_t =
+    logr_test::basic_logger_mock_t< category_traits_t >;
+
+TEST( LogrCategory, InheritedLevels )  // NOLINT
+{
+    logr::category_registry_t registry{ log_message_level::warn };
+
+    auto & http   = registry.category( "net.http" );
+    auto & client = registry.category( "net.http.client" );
+    auto & db     = registry.category( "db" );
+
+    ASSERT_NE( http.parent(), nullptr );
+    EXPECT_EQ( http.parent()->name(), "net" );
+    EXPECT_EQ( &registry.category( "net.http" ), &http );
+    EXPECT_EQ( client.log_level(), log_message_level::warn );
+
+    registry.log_level( "net.*", log_message_level::debug );
+    EXPECT_EQ( registry.category( "net" ).log_level(), log_message_level::debug );
+    EXPECT_EQ( http.log_level(), log_message_level::debug );
+    EXPECT_EQ( client.log_level(), log_message_level::debug );
+    EXPECT_EQ( db.log_level(), log_message_level::warn );
+
+    // Own level is not overridden by parent.
+    registry.log_level( http, log_message_level::error );
+    registry.log_level( "net", log_message_level::trace );
+    EXPECT_EQ( http.log_level(), log_message_level::error );
+    EXPECT_EQ( client.log_level(), log_message_level::error );
+
+    // New categories inherit level.
+    EXPECT_EQ( registry.category( "net.http.server" ).log_level(),
+               log_message_level::error );
+    EXPECT_EQ( registry.category( "net.tcp" ).log_level(),
+               log_message_level::trace );
+
+    registry.reset_log_level( "net.http" );
+    EXPECT_FALSE( http.has_own_level() );
+    EXPECT_EQ( client.log_level(), log_message_level::trace );
+
+    registry.log_level( "", log_message_level::critical );
+    EXPECT_EQ( db.log_level(), log_message_level::critical );
+    EXPECT_EQ( client.log_level(), log_message_level::trace );
+
+    std::vector< std::string > names;
+    registry.for_each(
+        [ & ]( const logr::category_t & c ) { names.push_back( c.name() ); } );
+    EXPECT_EQ( names,
+               ( std::vector< std::string >{ "",
+                                             "db",
+                                             "net",
+                                             "net.http",
+                                             "net.http.client",
+                                             "net.http.server",
+                                             "net.tcp" } ) );
+}
+
+TEST( LogrCategory, LevelCellIsCacheLine )  // NOLINT
+{
+    logr::category_registry_t registry;
+
+    auto & a = registry.category( "a" );
+    auto & b = registry.category( "b" );
+
+    const auto addr_a = reinterpret_cast< std::uintptr_t >( &a.level_cell() );
+    const auto addr_b = reinterpret_cast< std::uintptr_t >( &b.level_cell() );
+    EXPECT_EQ( addr_a % 64, 0 );
+    EXPECT_EQ( addr_b % 64, 0 );
+}
+
+TEST( LogrCategory, LoggerBoundToCategory )  // NOLINT
+{
+    logr::category_registry_t registry{ log_message_level::info };
+
+    category_logger_mock_t logger_1{ log_message_level::error };
+    category_logger_mock_t logger_2{ log_message_level::error };
+    category_logger_mock_t unbound{ log_message_level::error };
+
+    logger_1.log_level_driver().bind( registry.category( "net.http" ) );
+    logger_2.log_level_driver().bind( registry.category( "net.tcp" ) );
+    EXPECT_EQ( logger_1.log_level(), log_message_level::info );
+    EXPECT_EQ( logger_1.log_level_driver().category()->name(), "net.http" );
+
+    EXPECT_CALL( logger_1, log_message_debug( An< std::string_view >() ) );
+    EXPECT_CALL( logger_2, log_message_debug( An< std::string_view >() ) );
+    EXPECT_CALL( unbound, log_message_debug( An< std::string_view >() ) )
+        .Times( 0 );
+
+    registry.log_level( "net", log_message_level::debug );
+    logger_1.debug( "test [raw message]" );
+    logger_2.debug( "test [raw message]" );
+    unbound.debug( "test [raw message]" );
+    Mock::VerifyAndClearExpectations( &logger_1 );
+    Mock::VerifyAndClearExpectations( &logger_2 );
+
+    // Setting logger level sets level of its category
+    // (it locks registry, so it is not noexcept).
+    static_assert( !noexcept( logger_1.log_level( log_message_level::warn ) ) );
+    static_assert( noexcept( std::declval< logr_test::logger_mock_t<> & >()
+                                 .log_level( log_message_level::warn ) ) );
+    logger_1.log_level( log_message_level::warn );
+    EXPECT_EQ( registry.category( "net.http" ).log_level(),
+               log_message_level::warn );
+    EXPECT_EQ( logger_2.log_level(), log_message_level::debug );
+
+    unbound.log_level( log_message_level::trace );
+    EXPECT_EQ( unbound.log_level(), log_message_level::trace );
+    EXPECT_EQ( registry.root().log_level(), log_message_level::info );
+}
+
+}  // anonymous namespace
@@ -0,0 +1,110 @@
+// Check that messages below compiled min level are eliminated
+// regardless of runtime log level.
+
+#include <gtest/gtest.h>
+
+#include <logr/logr.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using info_traits_t = logr::basic_logger_traits_t< 1024,
+                                                   char,
+                                                   std::allocator< char >,
+                                                   logr::st_log_level_driver_t,
+                                                   logr::log_message_level::info >;
+
+using info_logger_mock_t = logr_test::basic_logger_mock_t< info_traits_t >;
+
+//
+// custom_traits_t
+//
+
+// Traits without compiled min level.
+struct custom_traits_t
+{
+    static constexpr std::size_t inline_size = 1024;
+    using char_t                             = char;
+    using allocator_t                        = std::allocator< char >;
+    using log_level_driver_t                 = logr::st_log_level_driver_t;
+};
+
+TEST( LogrCompiledMinLevel, RootLoggerType )  // NOLINT
+{
+    EXPECT_EQ( info_logger_mock_t::compiled_min_level,
+               logr::log_message_level::info );
+    EXPECT_EQ( logr_test::logger_mock_t<>::compiled_min_level,
+               logr::log_message_level::trace );
+
+    // Different compiled floors give different root loggers.
+    auto check_result =
+        std::is_same_v< info_logger_mock_t::root_logger_type_t,
+                        logr_test::logger_mock_t<>::root_logger_type_t >;
+    EXPECT_FALSE( check_result );
+
+    // Traits not stating compiled min level have all levels compiled.
+    check_result =
+        std::is_same_v< logr::basic_logger_t< custom_traits_t >,
+                        logr::basic_logger_type_t< 1024, char > >;
+    EXPECT_TRUE( check_result );
+
+    static_assert( !info_logger_mock_t::is_compiled_in(
+        logr::log_message_level::debug ) );
+    static_assert(
+        info_logger_mock_t::is_compiled_in( logr::log_message_level::info ) );
+}
+
+TEST( LogrCompiledMinLevel, LowLevelsEliminated )  // NOLINT
+{
+    info_logger_mock_t logger( logr::log_message_level::trace );
+
+    bool cb_was_called{ false };
+
+    InSequence seq;
+    EXPECT_CALL( logger, log_message_trace( An< std::string_view >() ) )
+        .Times( 0 );
+    EXPECT_CALL( logger, log_message_debug( _, An< std::string_view >() ) )
+        .Times( 0 );
+    EXPECT_CALL( logger, log_message_info( An< std::string_view >() ) );
+    EXPECT_CALL( logger, log_message_warn( _, An< std::string_view >() ) );
+
+    logger.trace( "test [raw message]" );
+    logger.trace( [ & ]() {
+        cb_was_called = true;
+        return "test [cb]";
+    } );
+    logger.debug( LOGR_SRC_LOCATION, [ & ]( auto & out ) {
+        cb_was_called = true;
+        format_to( out, "{} [{}]", "test", "cb with explicit out" );
+    } );
+    logger.message_level_x( logr::log_message_level::debug, "test [runtime]" );
+
+    EXPECT_FALSE( cb_was_called );
+
+    logger.info( "test [raw message]" );
+    logger.warn( LOGR_SRC_LOCATION, [ & ]( auto & out ) {
+        cb_was_called = true;
+        format_to( out, "{} [{}]", "test", "cb with explicit out" );
+    } );
+
+    EXPECT_TRUE( cb_was_called );
+}
+
+TEST( LogrCompiledMinLevel, RuntimeLevelStillApplies )  // NOLINT
+{
+    info_logger_mock_t logger( logr::log_message_level::error );
+
+    EXPECT_CALL( logger, log_message_info( An< std::string_view >() ) ).Times( 0 );
+    EXPECT_CALL( logger, log_message_warn( An< std::string_view >() ) ).Times( 0 );
+    EXPECT_CALL( logger, log_message_error( An< std::string_view >() ) );
+
+    logger.info( "test [raw message]" );
+    logger.warn( "test [raw message]" );
+    logger.error( "test [raw message]" );
+}
+
+}  // anonymous namespace
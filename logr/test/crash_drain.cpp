@@ -0,0 +1,408 @@
+// Check queued messages survive crashes and forks.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#    include <pthread.h>
+#    include <signal.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+#include <logr/async_backend.hpp>
+#include <logr/crash_drain.hpp>
+
+#include "logger_mock.hpp"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using mock_logger_t = StrictMock< logr_test::logger_mock_t<> >;
+using async_logger_t = logr::async_logger_t< mock_logger_t >;
+using polled_async_logger_t =
+    logr::async_logger_t< mock_logger_t, logr::polled_async_logger_traits_t >;
+
+struct polled_per_thread_traits_t : public logr::polled_async_logger_traits_t
+{
+    template < typename Record >
+    using queue_t = logr::details::per_thread_spsc_queue_t< Record >;
+};
+
+using polled_per_thread_async_logger_t =
+    logr::async_logger_t< mock_logger_t, polled_per_thread_traits_t >;
+
+/**
+ * @brief Read everything written to a pipe.
+ */
+std::string read_all( int fd )
+{
+    std::string res;
+    char buf[ 256 ];
+    for( ;; )
+    {
+        const auto n = ::read( fd, buf, sizeof( buf ) );
+        if( n <= 0 )
+        {
+            return res;
+        }
+        res.append( buf, static_cast< std::size_t >( n ) );
+    }
+}
+
+TEST( LogrCrashDrain, QueuedMessagesAreWritten )  // NOLINT
+{
+    int fds[ 2 ];
+    ASSERT_EQ( ::pipe( fds ), 0 );
+
+    {
+        polled_async_logger_t logger{ logr::log_message_level::trace,
+                                      16,
+                                      logr::log_message_level::trace };
+
+        logger.info( "static" );
+        logger.warn( []() { return std::string{ "owned" }; } );
+        logger.info( logr::deferred_format( "deferred {}", 42 ) );
+        logger.critical( "priority" );
+
+        logger.crash_drain( fds[ 1 ] );
+        ::close( fds[ 1 ] );
+
+        // Nothing is left for the backend.
+        ASSERT_EQ( logger.poll_drain( 100 ), 0 );
+        EXPECT_CALL( logger.backend(), log_flush() ).Times( AtMost( 1 ) );
+    }
+
+    EXPECT_EQ( read_all( fds[ 0 ] ),
+               "[critical] priority\n"
+               "[info] static\n"
+               "[warn] owned\n"
+               "[info] <deferred message is not formatted>\n" );
+    ::close( fds[ 0 ] );
+}
+
+TEST( LogrCrashDrain, PerThreadRingsAreScanned )  // NOLINT
+{
+    int fds[ 2 ];
+    ASSERT_EQ( ::pipe( fds ), 0 );
+
+    polled_per_thread_async_logger_t logger{ logr::log_message_level::trace,
+                                             16,
+                                             logr::log_message_level::trace };
+
+    logger.info( "static" );
+    logger.warn( []() { return std::string{ "owned" }; } );
+    std::thread{ [ & ] { logger.error( "other thread" ); } }.join();
+    logger.critical( "priority" );
+
+    logger.crash_drain( fds[ 1 ] );
+    ::close( fds[ 1 ] );
+
+    EXPECT_EQ( read_all( fds[ 0 ] ),
+               "[error] other thread\n"
+               "[critical] priority\n"
+               "[info] static\n"
+               "[warn] owned\n" );
+    ::close( fds[ 0 ] );
+
+    // Rings are scanned, not consumed.
+    EXPECT_CALL( logger.backend(), log_message_critical( "priority" ) );
+    EXPECT_CALL( logger.backend(), log_message_info( "static" ) );
+    EXPECT_CALL( logger.backend(), log_message_warn( "owned" ) );
+    EXPECT_CALL( logger.backend(), log_message_error( "other thread" ) );
+    EXPECT_CALL( logger.backend(), log_flush() ).Times( AtMost( 1 ) );
+    EXPECT_EQ( logger.poll_drain( 100 ), 4 );
+}
+
+TEST( LogrCrashDrain, SignalHandlerWritesQueuedMessages )  // NOLINT
+{
+    int fds[ 2 ];
+    ASSERT_EQ( ::pipe( fds ), 0 );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+
+    if( 0 == pid )
+    {
+        ::close( fds[ 0 ] );
+        if( !logr::install_crash_drain( fds[ 1 ] ) )
+        {
+            ::_exit( 1 );
+        }
+
+        // Never drained: the messages are in the queue on abort().
+        auto * logger = new polled_async_logger_t{ logr::log_message_level::trace,
+                                                   16,
+                                                   logr::log_message_level::trace };
+        logger->info( "last words" );
+        logger->error( "what happened" );
+        ::abort();
+    }
+
+    ::close( fds[ 1 ] );
+    const auto output = read_all( fds[ 0 ] );
+    ::close( fds[ 0 ] );
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFSIGNALED( status ) );
+    EXPECT_EQ( WTERMSIG( status ), SIGABRT );
+
+    EXPECT_EQ( output, "[error] what happened\n[info] last words\n" );
+}
+
+TEST( LogrCrashDrain, InstalledTwice )  // NOLINT
+{
+    int fds[ 2 ];
+    ASSERT_EQ( ::pipe( fds ), 0 );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+
+    if( 0 == pid )
+    {
+        ::close( fds[ 0 ] );
+        if( !logr::install_crash_drain()
+            || !logr::install_crash_drain( fds[ 1 ] ) )
+        {
+            ::_exit( 1 );
+        }
+
+        // The handler must not pass the signal on to itself.
+        ::alarm( 10 );
+
+        auto * logger = new polled_async_logger_t{ logr::log_message_level::trace,
+                                                   16,
+                                                   logr::log_message_level::trace };
+        logger->info( "last words" );
+        ::abort();
+    }
+
+    ::close( fds[ 1 ] );
+    const auto output = read_all( fds[ 0 ] );
+    ::close( fds[ 0 ] );
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFSIGNALED( status ) );
+    EXPECT_EQ( WTERMSIG( status ), SIGABRT );
+
+    // The last call sets the file descriptor.
+    EXPECT_EQ( output, "[info] last words\n" );
+}
+
+TEST( LogrCrashDrain, ConsumerRunsAfterFork )  // NOLINT
+{
+    ASSERT_TRUE( logr::install_crash_drain() );
+
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    {
+        InSequence seq;
+        // Delivered before fork, so the child doesn't get it.
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "before" } ) );
+        EXPECT_CALL( backend, log_flush() );
+    }
+    logger.info( "before" );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+    Mock::VerifyAndClearExpectations( &backend );
+
+    const auto * expected = 0 == pid ? "child" : "parent";
+    EXPECT_CALL( backend, log_message_info( std::string_view{ expected } ) );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    logger.info( expected );
+    logger.flush();
+
+    if( 0 == pid )
+    {
+        ::_exit( Mock::VerifyAndClearExpectations( &backend ) ? 0 : 1 );
+    }
+
+    Mock::VerifyAndClearExpectations( &backend );
+    EXPECT_CALL( backend, log_flush() ).Times( AtMost( 1 ) );
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFEXITED( status ) );
+    EXPECT_EQ( WEXITSTATUS( status ), 0 );
+}
+
+#    if defined( __linux__ )
+TEST( LogrCrashDrain, FlushWorksIfConsumerFailsToRestart )  // NOLINT
+{
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+
+    if( 0 == pid )
+    {
+        ::alarm( 10 );
+
+        async_logger_t logger{ logr::log_message_level::trace,
+                               16,
+                               logr::log_message_level::trace };
+        auto & backend = logger.backend();
+
+        EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+        logger.fork_prepare();
+
+        // No thread can get such a stack.
+        ::pthread_attr_t attr;
+        ::pthread_attr_init( &attr );
+        ::pthread_attr_setstacksize( &attr, std::size_t{ 1 } << 46 );
+        ::pthread_setattr_default_np( &attr );
+
+        logger.fork_parent();
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "queued" } ) );
+        logger.info( "queued" );
+        logger.flush();
+
+        ::_exit( Mock::VerifyAndClearExpectations( &backend ) ? 0 : 1 );
+    }
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFEXITED( status ) );
+    EXPECT_EQ( WEXITSTATUS( status ), 0 );
+}
+#    endif
+
+TEST( LogrCrashDrain, ForkWhileFlushing )  // NOLINT
+{
+    ASSERT_TRUE( logr::install_crash_drain() );
+
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    std::promise< void > go;
+    std::thread flusher{ [ &, go_future = go.get_future() ] {
+        go_future.wait();
+        logger.flush();
+    } };
+
+    std::atomic< bool > forking{ false };
+    EXPECT_CALL( logger.backend(), log_flush() ).WillRepeatedly( [ & ] {
+        if( forking.exchange( false ) )
+        {
+            // The last flush of the consumer stopping for fork():
+            // the next request stays waiting till fork() is over.
+            go.set_value();
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+        }
+    } );
+
+    forking = true;
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+
+    if( 0 == pid )
+    {
+        ::_exit( 0 );
+    }
+
+    flusher.join();
+
+    // The child hangs if it waits for the parent's waiters.
+    int status = 0;
+    for( int i = 0; i < 1000 && 0 == ::waitpid( pid, &status, WNOHANG ); ++i )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 10 } );
+    }
+    if( 0 == ::waitpid( pid, &status, WNOHANG ) )
+    {
+        ::kill( pid, SIGKILL );
+        ::waitpid( pid, &status, 0 );
+        FAIL() << "child hangs";
+    }
+    ASSERT_TRUE( WIFEXITED( status ) );
+    EXPECT_EQ( WEXITSTATUS( status ), 0 );
+}
+
+TEST( LogrCrashDrain, ManyLoggersRunAfterFork )  // NOLINT
+{
+    ASSERT_TRUE( logr::install_crash_drain() );
+
+    // More loggers than a chunk of registry holds.
+    constexpr std::size_t loggers_count =
+        logr::details::crash_drain_registry_t::chunk_size * 2 + 1;
+
+    std::vector< std::unique_ptr< async_logger_t > > loggers;
+    for( std::size_t i = 0; i < loggers_count; ++i )
+    {
+        loggers.push_back(
+            std::make_unique< async_logger_t >( logr::log_message_level::trace,
+                                                16,
+                                                logr::log_message_level::trace ) );
+        EXPECT_CALL( loggers.back()->backend(), log_flush() )
+            .Times( AnyNumber() );
+    }
+
+    auto & last = *loggers.back();
+    EXPECT_CALL( last.backend(), log_message_info( std::string_view{ "msg" } ) );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+
+    if( 0 == pid )
+    {
+        // Flush blocks forever if the consumer isn't restarted.
+        ::alarm( 10 );
+    }
+
+    last.info( "msg" );
+    last.flush();
+
+    if( 0 == pid )
+    {
+        ::_exit( Mock::VerifyAndClearExpectations( &last.backend() ) ? 0 : 1 );
+    }
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFEXITED( status ) );
+    EXPECT_EQ( WEXITSTATUS( status ), 0 );
+}
+
+TEST( LogrCrashDrain, RegisteredLoggerIsFlushedBeforeFork )  // NOLINT
+{
+    ASSERT_TRUE( logr::install_crash_drain() );
+
+    mock_logger_t logger{ logr::log_message_level::trace };
+    logr::crash_drain_registration_t registration{ logger };
+
+    EXPECT_CALL( logger, log_flush() );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+
+    if( 0 == pid )
+    {
+        ::_exit( 0 );
+    }
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+}
+
+}  // anonymous namespace
+
+#endif
@@ -0,0 +1,184 @@
+// Check deferred messages are formatted the same as ordinary ones.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <logr/async_backend.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using mock_logger_t = StrictMock< logr_test::logger_mock_t<> >;
+
+struct point_t
+{
+    int x;
+    int y;
+};
+
+struct big_t
+{
+    std::array< std::uint64_t, 64 > v;
+};
+
+} /* anonymous namespace */
+
+template <>
+struct fmt::formatter< big_t > : fmt::formatter< std::uint64_t >
+{
+    template < typename Format_Context >
+    auto format( const big_t & big, Format_Context & ctx ) const
+    {
+        return fmt::formatter< std::uint64_t >::format( big.v[ 0 ], ctx );
+    }
+};
+
+namespace /* anonymous */
+{
+
+TEST( LogrDeferredFormat, IsCapturable )  // NOLINT
+{
+    ASSERT_TRUE( logr::details::is_deferred_capturable_v< int > );
+    ASSERT_TRUE( logr::details::is_deferred_capturable_v< const double & > );
+    ASSERT_TRUE( logr::details::is_deferred_capturable_v< point_t > );
+
+    ASSERT_FALSE( logr::details::is_deferred_capturable_v< const char * > );
+    ASSERT_FALSE( logr::details::is_deferred_capturable_v< std::string_view > );
+    ASSERT_FALSE( logr::details::is_deferred_capturable_v< std::string > );
+}
+
+template < typename Format, typename = void >
+struct accepts_format_t : std::false_type
+{
+};
+
+template < typename Format >
+struct accepts_format_t< Format,
+                         std::void_t< decltype( logr::deferred_format(
+                             std::declval< Format >(), 1 ) ) > >
+    : std::true_type
+{
+};
+
+TEST( LogrDeferredFormat, OnlyLiteralFormat )  // NOLINT
+{
+    // Only a pointer to the format string is captured.
+    ASSERT_TRUE( ( accepts_format_t< const char( & )[ 3 ] >::value ) );
+    ASSERT_TRUE( ( accepts_format_t< const wchar_t( & )[ 3 ] >::value ) );
+    ASSERT_FALSE( ( accepts_format_t< std::string >::value ) );
+    ASSERT_FALSE( ( accepts_format_t< const std::string & >::value ) );
+    ASSERT_FALSE( ( accepts_format_t< std::string_view >::value ) );
+    ASSERT_FALSE( ( accepts_format_t< const char * >::value ) );
+    ASSERT_FALSE(
+        ( accepts_format_t< decltype( ::fmt::runtime( "{}" ) ) >::value ) );
+}
+
+TEST( LogrDeferredFormat, IsFormattedByDefault )  // NOLINT
+{
+    mock_logger_t logger( logr::log_message_level::trace );
+
+    InSequence seq;
+
+    EXPECT_CALL( logger, log_message_trace( std::string_view{ "no args" } ) );
+    EXPECT_CALL( logger,
+                 log_message_debug( std::string_view{ "42 3.5 c true" } ) );
+    EXPECT_CALL( logger, log_message_info( _, std::string_view{ "[0042]" } ) );
+    EXPECT_CALL( logger, log_message_warn( std::string_view{ "1-2" } ) );
+    EXPECT_CALL( logger, log_message_error( _, std::string_view{ "1 2 3" } ) );
+    EXPECT_CALL( logger, log_message_critical( std::string_view{ "-1" } ) );
+
+    const int x = 42;
+
+    logger.trace( logr::deferred_format( "no args" ) );
+    logger.debug( logr::deferred_format( "{} {} {} {}", x, 3.5, 'c', true ) );
+    logger.info( LOGR_SRC_LOCATION, logr::deferred_format( "[{:04}]", x ) );
+    logger.warn( logr::deferred_format( "{}-{}", 1U, std::int64_t{ 2 } ) );
+    logger.error( LOGR_SRC_LOCATION, logr::deferred_format( "{} {} {}", 1, 2, 3 ) );
+    logger.critical( logr::deferred_format( "{}", -1 ) );
+}
+
+TEST( LogrDeferredFormat, ArgsAreCaptured )  // NOLINT
+{
+    mock_logger_t logger( logr::log_message_level::trace );
+
+    int x    = 1;
+    auto msg = logr::deferred_format( "x={}", x );
+    x        = 2;
+
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "x=1" } ) );
+    logger.info( msg );
+}
+
+using async_logger_t = logr::async_logger_t< mock_logger_t >;
+
+TEST( LogrDeferredFormat, FormattedByAsyncConsumer )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::info,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "msg 1" } ) );
+        EXPECT_CALL( backend,
+                     log_message_warn( _, std::string_view{ "msg 2 2.5" } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "msg 3" } ) );
+        EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+    }
+
+    int n = 1;
+    logger.info( logr::deferred_format( "msg {}", n ) );
+    n = 2;
+    logger.warn( LOGR_SRC_LOCATION, logr::deferred_format( "msg {} {}", n, 2.5 ) );
+    logger.info( "msg 3" );
+    logger.debug( logr::deferred_format( "filtered {}", n ) );
+
+    logger.flush();
+    Mock::VerifyAndClearExpectations( &backend );
+
+    // Loop over all slots to make sure text and deferred records
+    // don't interfere when a slot is reused.
+
+    EXPECT_CALL( backend, log_message_info( An< std::string_view >() ) )
+        .Times( 32 );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    for( int i = 0; i < 16; ++i )
+    {
+        logger.info( "text" );
+        logger.info( logr::deferred_format( "deferred {}", i ) );
+    }
+    logger.flush();
+}
+
+TEST( LogrDeferredFormat, TooBigForAsyncQueue )  // NOLINT
+{
+    async_logger_t logger{ logr::log_message_level::trace,
+                           16,
+                           logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    big_t big{};
+    big.v[ 0 ] = 7;
+    static_assert( sizeof( big ) > logr::async_logger_traits_t::deferred_capacity );
+
+    EXPECT_CALL( backend, log_message_error( std::string_view{ "7 42" } ) );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    logger.error( logr::deferred_format( "{} {}", big, 42 ) );
+    logger.flush();
+}
+
+} /* anonymous namespace */
@@ -0,0 +1,298 @@
+// Check file logger batches lines and writes all of them.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <logr/file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+using file_logger_t = logr::file_logger_t<>;
+
+std::string temp_file( const char * name )
+{
+    auto path = ::testing::TempDir() + name;
+    std::remove( path.c_str() );
+    return path;
+}
+
+std::string read_file( const std::string & path )
+{
+    std::ifstream in{ path, std::ios::binary };
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+TEST( LogrFileBackend, LinesAreBatched )  // NOLINT
+{
+    const auto path = temp_file( "logr_file_batched.log" );
+    {
+        file_logger_t logger{
+            path, logr::log_message_level::trace, 1024, std::chrono::hours{ 1 }
+        };
+
+        logger.info( "msg 1" );
+        logger.debug( logr::src_location_t{ "file.cpp", 7 },
+                      []( auto out ) { format_to( out, "msg {}", 2 ); } );
+
+        // Not written yet.
+        EXPECT_EQ( read_file( path ), "" );
+
+        logger.flush();
+        const std::string head = "INFO : msg 1\nDEBUG: msg 2 @ file.cpp(7)\n";
+        EXPECT_EQ( read_file( path ), head );
+
+        // Over the batch size.
+        const std::string long_message( 1024, 'x' );
+        logger.error( long_message );
+        EXPECT_EQ( read_file( path ), head + "ERR  : " + long_message + "\n" );
+
+        logger.critical( "msg 4" );
+    }
+
+    // Destructor writes the rest.
+    const auto data = read_file( path );
+    EXPECT_EQ( data.substr( data.size() - 13 ), "CRIT : msg 4\n" );
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFileBackend, MaxDelay )  // NOLINT
+{
+    const auto path = temp_file( "logr_file_delay.log" );
+    file_logger_t logger{
+        path, logr::log_message_level::trace, 1024, std::chrono::milliseconds{ 1 }
+    };
+
+    logger.info( "msg 1" );
+    std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+
+    // The buffer of the other thread is old, so it is written too.
+    std::thread{ [ & ] { logger.info( "msg 2" ); } }.join();
+    EXPECT_EQ( read_file( path ), "INFO : msg 1\nINFO : msg 2\n" );
+
+    logger.info( "msg 3" );
+    std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+    logger.info( "msg 4" );
+    EXPECT_EQ( read_file( path ),
+               "INFO : msg 1\nINFO : msg 2\nINFO : msg 3\nINFO : msg 4\n" );
+
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFileBackend, ConcurrentWriters )  // NOLINT
+{
+    const auto path = temp_file( "logr_file_concurrent.log" );
+
+    constexpr int threads_count  = 4;
+    constexpr int messages_count = 5000;
+    {
+        // Two loggers appending to the same file.
+        file_logger_t logger1{ path, logr::log_message_level::info, 512 };
+        file_logger_t logger2{ path, logr::log_message_level::info, 512 };
+
+        std::vector< std::thread > threads;
+        for( int t = 0; t < threads_count; ++t )
+        {
+            threads.emplace_back( [ &, t ] {
+                auto & logger = t % 2 ? logger1 : logger2;
+                for( int i = 0; i < messages_count; ++i )
+                {
+                    logger.info( [ & ]( auto out ) {
+                        format_to( out, "thread {} msg {}", t, i );
+                    } );
+                    if( 0 == i % 1000 )
+                    {
+                        logger.flush();
+                    }
+                }
+            } );
+        }
+
+        for( auto & t : threads )
+        {
+            t.join();
+        }
+    }
+
+    std::ifstream in{ path };
+    std::vector< int > next( threads_count, 0 );
+    std::string line;
+    while( std::getline( in, line ) )
+    {
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(
+            std::sscanf( line.c_str(), "INFO : thread %d msg %d", &t, &i ), 2 )
+            << line;
+        ASSERT_TRUE( 0 <= t && t < threads_count ) << line;
+        // Messages of a thread keep their order.
+        ASSERT_EQ( i, next[ t ] ) << line;
+        ++next[ t ];
+    }
+
+    for( int t = 0; t < threads_count; ++t )
+    {
+        EXPECT_EQ( next[ t ], messages_count );
+    }
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFileBackend, SidecarIndex )  // NOLINT
+{
+    using logr::file_index::find_range;
+
+    const auto path = temp_file( "logr_file_index.log" );
+    std::remove( ( path + ".idx" ).c_str() );
+    {
+        file_logger_t logger{ path,
+                              logr::log_message_level::trace,
+                              64,
+                              std::chrono::hours{ 1 },
+                              logr::log_message_level::nolog,
+                              256 };
+
+        for( int i = 0; i < 100; ++i )
+        {
+            if( 50 == i )
+            {
+                logger.error( "msg 50" );
+                continue;
+            }
+            logger.info( [ & ]( auto out ) { format_to( out, "msg {}", i ); } );
+        }
+    }
+
+    const auto data = read_file( path );
+    std::ifstream in{ path + ".idx", std::ios::binary };
+    const auto index = logr::file_index::read_index( in );
+
+    EXPECT_EQ( index.header.interval, 256 );
+    EXPECT_EQ( index.header.max_delay_ns, 3600LL * 1000000000 );
+    ASSERT_GE( index.entries.size(), 3 );
+
+    std::uint64_t prev = 0;
+    for( const auto & e : index.entries )
+    {
+        if( &e != &index.entries.back() )
+        {
+            EXPECT_GE( e.offset, prev + 256 );
+        }
+        EXPECT_GT( e.offset, prev );
+        // Entries are at line boundaries.
+        EXPECT_EQ( data[ e.offset - 1 ], '\n' );
+
+        const auto chunk = data.substr( prev, e.offset - prev );
+        const auto level = chunk.find( "ERR  : msg 50" ) != std::string::npos
+                               ? logr::log_message_level::error
+                               : logr::log_message_level::info;
+        EXPECT_EQ( e.level, static_cast< std::int32_t >( level ) );
+        prev = e.offset;
+    }
+    // The tail is covered on close.
+    EXPECT_EQ( index.entries.back().offset, data.size() );
+
+    constexpr auto min_time = std::numeric_limits< std::int64_t >::min();
+    constexpr auto max_time = std::numeric_limits< std::int64_t >::max();
+    const auto & first      = index.entries.front();
+    const auto & last       = index.entries.back();
+
+    EXPECT_EQ( find_range( index, min_time, max_time, data.size() ),
+               std::make_pair( std::uint64_t{ 0 }, data.size() ) );
+    EXPECT_EQ( find_range( index, last.timestamp + 1, max_time, data.size() ),
+               std::make_pair( last.offset, data.size() ) );
+    EXPECT_EQ( find_range( index,
+                           min_time,
+                           first.timestamp - index.header.max_delay_ns - 1,
+                           data.size() ),
+               std::make_pair( std::uint64_t{ 0 }, first.offset ) );
+
+    std::remove( path.c_str() );
+    std::remove( ( path + ".idx" ).c_str() );
+}
+
+TEST( LogrFileBackend, SidecarIndexStaleBuffer )  // NOLINT
+{
+    using logr::file_index::find_range;
+
+    const auto path = temp_file( "logr_file_index_stale.log" );
+    std::remove( ( path + ".idx" ).c_str() );
+    std::int64_t logged_before = 0;
+    {
+        file_logger_t logger{ path,
+                              logr::log_message_level::trace,
+                              64,
+                              std::chrono::milliseconds{ 10 },
+                              logr::log_message_level::nolog,
+                              64 };
+
+        // A thread logs a message and goes idle.
+        std::thread{ [ & ] { logger.info( "stale message" ); } }.join();
+        logged_before =
+            std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::system_clock::now().time_since_epoch() )
+                .count();
+
+        // The message is written long after the max delay.
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 50 } );
+        for( int i = 0; i < 100; ++i )
+        {
+            logger.info( [ & ]( auto out ) { format_to( out, "msg {}", i ); } );
+        }
+    }
+
+    const auto data = read_file( path );
+    std::ifstream in{ path + ".idx", std::ios::binary };
+    const auto index = logr::file_index::read_index( in );
+    ASSERT_GE( index.entries.size(), 3 );
+
+    constexpr auto min_time   = std::numeric_limits< std::int64_t >::min();
+    const auto [ begin, end ] =
+        find_range( index, min_time, logged_before, data.size() );
+    const auto range = data.substr( begin, end - begin );
+    EXPECT_NE( range.find( "stale message" ), std::string::npos );
+    EXPECT_EQ( range.find( "msg 99" ), std::string::npos );
+
+    std::remove( path.c_str() );
+    std::remove( ( path + ".idx" ).c_str() );
+}
+
+TEST( LogrFileBackend, SidecarIndexVersion1 )  // NOLINT
+{
+    logr::file_index::header_t header{};
+    std::memcpy(
+        header.magic, logr::file_index::magic.data(), sizeof( header.magic ) );
+    header.version      = 1;
+    header.interval     = 256;
+    header.max_delay_ns = 100;
+
+    logr::file_index::entry_t e{};
+    e.timestamp = 1000;
+    e.offset    = 300;
+    e.level     = static_cast< std::int32_t >( logr::log_message_level::info );
+
+    std::string data( reinterpret_cast< const char * >( &header ),
+                      sizeof( header ) );
+    data.append( reinterpret_cast< const char * >( &e ),
+                 logr::file_index::entry_v1_size );
+    std::istringstream in{ data };
+    const auto index = logr::file_index::read_index( in );
+
+    ASSERT_EQ( index.entries.size(), 1 );
+    EXPECT_EQ( index.entries[ 0 ].offset, 300 );
+    EXPECT_EQ( index.entries[ 0 ].first_logged, 900 );
+}
+
+}  // anonymous namespace
@@ -0,0 +1,188 @@
+// Check flight recorder keeps the latest messages in a ring file.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <logr/flight_recorder.hpp>
+
+namespace /* anonymous */
+{
+
+using flight_recorder_logger_t = logr::flight_recorder_logger_t<>;
+
+std::string temp_file( const char * name )
+{
+    auto path = ::testing::TempDir() + name;
+    std::remove( path.c_str() );
+    return path;
+}
+
+std::vector< logr::flight_recorder::record_t > read_all( const std::string & path )
+{
+    std::ifstream in{ path, std::ios::binary };
+    return logr::flight_recorder::read_records( in );
+}
+
+TEST( LogrFlightRecorder, LatestMessagesAreKept )  // NOLINT
+{
+    const auto path = temp_file( "logr_ring_latest.bin" );
+    {
+        flight_recorder_logger_t logger{ path, logr::log_message_level::trace, 8 };
+
+        for( int i = 0; i < 20; ++i )
+        {
+            logger.trace( [ & ]( auto out ) { format_to( out, "msg {}", i ); } );
+        }
+        logger.error( logr::src_location_t{ "dir/file.cpp", 7 }, "last" );
+    }
+
+    const auto records = read_all( path );
+    ASSERT_EQ( records.size(), 8 );
+    for( int i = 0; i < 7; ++i )
+    {
+        EXPECT_EQ( records[ i ].ticket, 13 + i );
+        EXPECT_EQ( records[ i ].level, logr::log_message_level::trace );
+        EXPECT_EQ( records[ i ].text, "msg " + std::to_string( 13 + i ) );
+        EXPECT_EQ( records[ i ].file, "" );
+    }
+
+    EXPECT_EQ( records[ 7 ].level, logr::log_message_level::error );
+    EXPECT_EQ( records[ 7 ].text, "last" );
+    EXPECT_EQ( records[ 7 ].file, "dir/file.cpp" );
+    EXPECT_EQ( records[ 7 ].line, 7 );
+    EXPECT_LE( records[ 6 ].timestamp, records[ 7 ].timestamp );
+
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFlightRecorder, LongMessagesAreTruncated )  // NOLINT
+{
+    const auto path = temp_file( "logr_ring_truncated.bin" );
+
+    // 64 bytes of payload.
+    constexpr std::uint32_t slot_size = 96;
+    const std::string file( 100, 'f' );
+    const std::string text( 100, 't' );
+    {
+        flight_recorder_logger_t logger{
+            path, logr::log_message_level::trace, 4, slot_size
+        };
+        logger.info( text );
+        logger.info( logr::src_location_t{ file.c_str(), 1 }, text );
+    }
+
+    const auto records = read_all( path );
+    ASSERT_EQ( records.size(), 2 );
+    EXPECT_EQ( records[ 0 ].text, text.substr( 0, 64 ) );
+    EXPECT_EQ( records[ 1 ].file, file.substr( 0, 32 ) );
+    EXPECT_EQ( records[ 1 ].text, text.substr( 0, 32 ) );
+
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFlightRecorder, RingIsContinuedAndTornSlotsSkipped )  // NOLINT
+{
+    const auto path = temp_file( "logr_ring_continued.bin" );
+    {
+        flight_recorder_logger_t logger{ path, logr::log_message_level::trace, 4 };
+        logger.info( "msg 0" );
+        logger.info( "msg 1" );
+    }
+    {
+        flight_recorder_logger_t logger{ path, logr::log_message_level::trace, 4 };
+        logger.info( "msg 2" );
+    }
+
+    auto records = read_all( path );
+    ASSERT_EQ( records.size(), 3 );
+    EXPECT_EQ( records[ 2 ].ticket, 2 );
+    EXPECT_EQ( records[ 2 ].text, "msg 2" );
+
+    {
+        // Damage the text of the second message.
+        std::fstream f{ path, std::ios::binary | std::ios::in | std::ios::out };
+        f.seekp( logr::flight_recorder::header_size
+                 + logr::flight_recorder::default_slot_size
+                 + sizeof( logr::flight_recorder::slot_header_t ) );
+        f.put( 'X' );
+    }
+
+    records = read_all( path );
+    ASSERT_EQ( records.size(), 2 );
+    EXPECT_EQ( records[ 0 ].text, "msg 0" );
+    EXPECT_EQ( records[ 1 ].text, "msg 2" );
+
+    {
+        // Different geometry: the ring starts over.
+        flight_recorder_logger_t logger{ path, logr::log_message_level::trace, 2 };
+        logger.info( "msg" );
+    }
+
+    records = read_all( path );
+    ASSERT_EQ( records.size(), 1 );
+    EXPECT_EQ( records[ 0 ].ticket, 0 );
+
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFlightRecorder, ConcurrentWriters )  // NOLINT
+{
+    const auto path = temp_file( "logr_ring_concurrent.bin" );
+
+    constexpr int threads_count  = 4;
+    constexpr int messages_count = 1000;
+    {
+        flight_recorder_logger_t logger{
+            path, logr::log_message_level::trace, threads_count * messages_count
+        };
+
+        std::vector< std::thread > threads;
+        for( int t = 0; t < threads_count; ++t )
+        {
+            threads.emplace_back( [ &, t ] {
+                for( int i = 0; i < messages_count; ++i )
+                {
+                    logger.info( [ & ]( auto out ) {
+                        format_to( out, "thread {} msg {}", t, i );
+                    } );
+                }
+            } );
+        }
+
+        for( auto & t : threads )
+        {
+            t.join();
+        }
+    }
+
+    const auto records = read_all( path );
+    ASSERT_EQ( records.size(), threads_count * messages_count );
+
+    std::vector< int > next( threads_count, 0 );
+    for( const auto & r : records )
+    {
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ( std::sscanf( r.text.c_str(), "thread %d msg %d", &t, &i ), 2 );
+        ASSERT_TRUE( 0 <= t && t < threads_count );
+        // Tickets keep the order of messages of a thread.
+        ASSERT_EQ( i, next[ t ] );
+        ++next[ t ];
+    }
+
+    std::remove( path.c_str() );
+}
+
+TEST( LogrFlightRecorder, NotARingFile )  // NOLINT
+{
+    std::istringstream in{ std::string( 100, 'x' ) };
+    EXPECT_THROW( logr::flight_recorder::read_records( in ), std::runtime_error );
+}
+
+}  // anonymous namespace
@@ -0,0 +1,136 @@
+// Check group commit shares syncs and durable messages are written at once.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <logr/file_backend.hpp>
+#include <logr/group_commit.hpp>
+#include <logr/mmap_file_backend.hpp>
+#include <logr/rotating_file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+std::string temp_file( const char * name )
+{
+    auto path = ::testing::TempDir() + name;
+    std::remove( path.c_str() );
+    return path;
+}
+
+std::string read_file( const std::string & path )
+{
+    std::ifstream in{ path, std::ios::binary };
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+TEST( LogrGroupCommit, ConcurrentCommits )  // NOLINT
+{
+    const auto path = temp_file( "logr_group_commit.log" );
+    const int fd    = ::open( path.c_str(), O_WRONLY | O_CREAT, 0644 );
+    ASSERT_NE( fd, -1 );
+
+    constexpr int threads_count = 8;
+    constexpr int commits_count = 50;
+
+    logr::group_commit_t commit;
+    std::vector< std::thread > threads;
+    for( int t = 0; t < threads_count; ++t )
+    {
+        threads.emplace_back( [ & ] {
+            for( int i = 0; i < commits_count; ++i )
+            {
+                EXPECT_EQ( ::write( fd, "x\n", 2 ), 2 );
+                commit.commit( fd );
+            }
+        } );
+    }
+
+    for( auto & t : threads )
+    {
+        t.join();
+    }
+
+    EXPECT_EQ( commit.commits_count(), threads_count * commits_count );
+    EXPECT_GE( commit.syncs_count(), 1 );
+    EXPECT_LE( commit.syncs_count(), commit.commits_count() );
+
+    ::close( fd );
+    std::remove( path.c_str() );
+}
+
+TEST( LogrGroupCommit, FileBackendDurableMessages )  // NOLINT
+{
+    const auto path = temp_file( "logr_group_commit_file.log" );
+    {
+        logr::file_logger_t<> logger{ path,
+                                      logr::log_message_level::info,
+                                      1024,
+                                      std::chrono::hours{ 1 },
+                                      logr::log_message_level::error };
+
+        logger.info( "msg 1" );
+        EXPECT_EQ( read_file( path ), "" );
+        EXPECT_EQ( logger.group_commit().commits_count(), 0 );
+
+        // Written with the buffered line and committed.
+        logger.error( "msg 2" );
+        EXPECT_EQ( read_file( path ), "INFO : msg 1\nERR  : msg 2\n" );
+        EXPECT_EQ( logger.group_commit().commits_count(), 1 );
+
+        logger.warn( "msg 3" );
+        logger.flush();
+        EXPECT_EQ( read_file( path ),
+                   "INFO : msg 1\nERR  : msg 2\nWARN : msg 3\n" );
+        EXPECT_EQ( logger.group_commit().commits_count(), 2 );
+    }
+    std::remove( path.c_str() );
+}
+
+TEST( LogrGroupCommit, OtherBackends )  // NOLINT
+{
+    const auto path = temp_file( "logr_group_commit_other.log" );
+    {
+        logr::mmap_file_logger_t<> logger{ path,
+                                           logr::log_message_level::info,
+                                           4096,
+                                           logr::log_message_level::error };
+        logger.info( "msg 1" );
+        logger.critical( "msg 2" );
+    }
+    {
+        logr::rotating_file_logger_t<> logger{
+            path,
+            logr::log_message_level::info,
+            39,
+            1,
+            std::chrono::milliseconds::zero(),
+            logr::rotating_file_logger_t<>::retire_handler_t{},
+            logr::log_message_level::error
+        };
+        // Makes the file full.
+        logger.error( "msg 3" );
+        logger.flush();
+        logger.info( "msg 4" );
+        logger.flush();
+    }
+
+    EXPECT_EQ( read_file( path + ".1" ),
+               "INFO : msg 1\nCRIT : msg 2\nERR  : msg 3\n" );
+    EXPECT_EQ( read_file( path ), "INFO : msg 4\n" );
+    std::remove( path.c_str() );
+    std::remove( ( path + ".1" ).c_str() );
+}
+
+}  // anonymous namespace
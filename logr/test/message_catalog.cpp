@@ -0,0 +1,119 @@
+// Check functions generated from a message catalog.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <logr/async_backend.hpp>
+#include <logr/binary_backend.hpp>
+#include <logr/logr.hpp>
+
+// Generated from test_catalog.json.
+#include "test_catalog.hpp"
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+namespace catalog = logr_test::catalog;
+
+TEST( LogrMessageCatalog, MessagesAreFormatted )  // NOLINT
+{
+    StrictMock< logr_test::logger_mock_t<> > logger{
+        logr::log_message_level::trace
+    };
+
+    EXPECT_CALL( logger,
+                 log_message_info( std::string_view{ "Order 42 filled at 2.50" } ) );
+    EXPECT_CALL( logger,
+                 log_message_warn( Field( &logr::src_location_t::line, 7 ),
+                                         std::string_view{ "User \"bob\" logged in" } ) );
+    EXPECT_CALL( logger,
+                 log_message_debug( std::string_view{ "Started {no params}" } ) );
+
+    catalog::log_order_filled( logger, 42, 2.5 );
+    catalog::log_user_logged_in(
+        logger, logr::src_location_t{ "file.cpp", 7 }, std::string{ "bob" } );
+    catalog::log_started( logger );
+}
+
+TEST( LogrMessageCatalog, LevelIsChecked )  // NOLINT
+{
+    StrictMock< logr_test::logger_mock_t<> > logger{ logr::log_message_level::warn };
+
+    EXPECT_CALL( logger,
+                 log_message_warn( _, std::string_view{ "User \"x\" logged in" } ) );
+
+    // Filtered out: nothing is formatted.
+    catalog::log_order_filled( logger, 42, 2.5 );
+    catalog::log_started( logger );
+
+    catalog::log_user_logged_in( logger, LOGR_SRC_LOCATION, std::string{ "x" } );
+}
+
+TEST( LogrMessageCatalog, Schema )  // NOLINT
+{
+    static_assert( catalog::order_filled_msg_t::id == 1001 );
+    static_assert( catalog::order_filled_msg_t::level
+                   == logr::log_message_level::info );
+    static_assert( catalog::order_filled_msg_t::params.size() == 2 );
+    static_assert( catalog::started_msg_t::params.size() == 0 );
+
+    // Default ids are stable hashes of names.
+    static_assert( catalog::user_logged_in_msg_t::id == 1104642325U );
+
+    ASSERT_EQ( std::size( catalog::catalog_entries ), 3 );
+
+    const auto * e = logr::find_catalog_entry( catalog::catalog_entries, 1001 );
+    ASSERT_NE( e, nullptr );
+    EXPECT_EQ( e->name, "order_filled" );
+    EXPECT_EQ( e->format, "Order {} filled at {:.2f}" );
+    ASSERT_EQ( e->params_count, 2 );
+    EXPECT_EQ( e->params[ 1 ].name, "price" );
+    EXPECT_EQ( e->params[ 1 ].type, "double" );
+
+    EXPECT_EQ( logr::find_catalog_entry( catalog::catalog_entries, 1 ), nullptr );
+}
+
+TEST( LogrMessageCatalog, IdReachesBackend )  // NOLINT
+{
+    std::ostringstream out;
+    {
+        logr::async_logger_t< logr::binary_logger_t<> > logger{
+            logr::log_message_level::trace, 16, out, logr::log_message_level::trace
+        };
+
+        catalog::log_order_filled( logger, 42, 2.5 );
+        catalog::log_user_logged_in(
+            logger, LOGR_SRC_LOCATION, std::string{ "bob" } );
+        catalog::log_started( logger );
+    }
+
+    std::istringstream in{ out.str() };
+    logr::binary_log::decoder_t decoder{ in };
+    std::vector< logr::binary_log::decoded_message_t > messages;
+    logr::binary_log::decoded_message_t msg;
+    while( decoder.next( msg ) )
+    {
+        messages.push_back( msg );
+    }
+
+    ASSERT_EQ( messages.size(), 3 );
+
+    EXPECT_EQ( messages[ 0 ].text, "Order 42 filled at 2.50" );
+    EXPECT_EQ( messages[ 0 ].catalog_id, catalog::order_filled_msg_t::id );
+
+    // A string param can't be captured, so the message is rendered.
+    EXPECT_EQ( messages[ 1 ].text, "User \"bob\" logged in" );
+    EXPECT_FALSE( messages[ 1 ].catalog_id );
+
+    EXPECT_EQ( messages[ 2 ].text, "Started {no params}" );
+    EXPECT_EQ( messages[ 2 ].catalog_id, catalog::started_msg_t::id );
+}
+
+}  // anonymous namespace
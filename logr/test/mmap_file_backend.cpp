@@ -0,0 +1,175 @@
+// Check mmap file logger writes all lines and truncates the file.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <logr/mmap_file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+using mmap_file_logger_t = logr::mmap_file_logger_t<>;
+
+std::string temp_file( const char * name )
+{
+    auto path = ::testing::TempDir() + name;
+    std::remove( path.c_str() );
+    return path;
+}
+
+std::string read_file( const std::string & path )
+{
+    std::ifstream in{ path, std::ios::binary };
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+TEST( LogrMmapFileBackend, LinesAreWritten )  // NOLINT
+{
+    const auto path = temp_file( "logr_mmap_lines.log" );
+    {
+        mmap_file_logger_t logger{ path, logr::log_message_level::trace };
+
+        logger.info( "msg 1" );
+        logger.debug( logr::src_location_t{ "file.cpp", 7 },
+                      []( auto out ) { format_to( out, "msg {}", 2 ); } );
+        logger.error( "msg 3" );
+        logger.trace( []( auto out ) { format_to( out, "msg {}", 4 ); } );
+    }
+
+    EXPECT_EQ( read_file( path ),
+               "INFO : msg 1\n"
+               "DEBUG: msg 2 @ file.cpp(7)\n"
+               "ERR  : msg 3\n"
+               "TRACE: msg 4\n" );
+    std::remove( path.c_str() );
+}
+
+TEST( LogrMmapFileBackend, FlushTruncatesAndAppends )  // NOLINT
+{
+    const auto path = temp_file( "logr_mmap_flush.log" );
+    {
+        mmap_file_logger_t logger{ path };
+
+        logger.info( "msg 1" );
+        logger.flush();
+        EXPECT_EQ( read_file( path ), "INFO : msg 1\n" );
+
+        // Written to a window mapped after flush.
+        logger.warn( "msg 2" );
+        logger.flush();
+        EXPECT_EQ( read_file( path ), "INFO : msg 1\nWARN : msg 2\n" );
+    }
+    {
+        // Reopened file is appended.
+        mmap_file_logger_t logger{ path };
+        logger.critical( "msg 3" );
+    }
+
+    EXPECT_EQ( read_file( path ), "INFO : msg 1\nWARN : msg 2\nCRIT : msg 3\n" );
+    std::remove( path.c_str() );
+}
+
+TEST( LogrMmapFileBackend, ZeroTailIsCutAfterCrash )  // NOLINT
+{
+    const auto path = temp_file( "logr_mmap_crash.log" );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+    if( 0 == pid )
+    {
+        // Crashes with a preallocated window.
+        auto * logger =
+            new mmap_file_logger_t{ path, logr::log_message_level::info, 4096 };
+        logger->info( "before crash" );
+        ::_exit( 0 );
+    }
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFEXITED( status ) );
+    ASSERT_EQ( read_file( path ).size(), 4096 );
+
+    {
+        mmap_file_logger_t logger{ path, logr::log_message_level::info, 4096 };
+        logger.info( "after crash" );
+    }
+
+    EXPECT_EQ( read_file( path ), "INFO : before crash\nINFO : after crash\n" );
+    std::remove( path.c_str() );
+}
+
+TEST( LogrMmapFileBackend, WindowsRollOver )  // NOLINT
+{
+    const auto path = temp_file( "logr_mmap_rollover.log" );
+
+    // Smallest windows (a page) to roll over often,
+    // and a message longer than a window.
+    const std::string long_message( 10000, 'x' );
+    constexpr int threads_count  = 4;
+    constexpr int messages_count   = 5000;
+    {
+        mmap_file_logger_t logger{ path, logr::log_message_level::info, 1 };
+
+        std::vector< std::thread > threads;
+        for( int t = 0; t < threads_count; ++t )
+        {
+            threads.emplace_back( [ &, t ] {
+                for( int i = 0; i < messages_count; ++i )
+                {
+                    logger.info( [ & ]( auto out ) {
+                        format_to( out, "thread {} msg {}", t, i );
+                    } );
+                }
+            } );
+        }
+        logger.warn( long_message );
+
+        for( auto & t : threads )
+        {
+            t.join();
+        }
+    }
+
+    std::ifstream in{ path };
+    std::vector< int > next( threads_count, 0 );
+    int long_messages = 0;
+    std::string line;
+    while( std::getline( in, line ) )
+    {
+        if( line == "WARN : " + long_message )
+        {
+            ++long_messages;
+            continue;
+        }
+
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(
+            std::sscanf( line.c_str(), "INFO : thread %d msg %d", &t, &i ), 2 )
+            << line;
+        ASSERT_TRUE( 0 <= t && t < threads_count ) << line;
+        // Messages of a thread keep their order.
+        ASSERT_EQ( i, next[ t ] ) << line;
+        ++next[ t ];
+    }
+
+    EXPECT_EQ( long_messages, 1 );
+    for( int t = 0; t < threads_count; ++t )
+    {
+        EXPECT_EQ( next[ t ], messages_count );
+    }
+    std::remove( path.c_str() );
+}
+
+}  // anonymous namespace
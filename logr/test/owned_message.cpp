@@ -0,0 +1,159 @@
+// Check messages can be passed to backend by rvalue.
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <logr/async_backend.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using mock_logger_t = StrictMock< logr_test::logger_mock_t< 64 > >;
+
+/**
+ * @brief A logger keeping messages it receives by rvalue.
+ */
+class keeping_logger_t : public logr_test::logger_mock_t< 64 >
+{
+public:
+    using base_type_t = logr_test::logger_mock_t< 64 >;
+
+    keeping_logger_t()
+        : base_type_t{ logr::log_message_level::trace }
+    {
+    }
+
+    std::vector< message_container_t > kept;
+
+private:
+    void log_owned_message_info( message_container_t && message ) override
+    {
+        kept.push_back( std::move( message ) );
+    }
+
+    void log_owned_message_info( logr::src_location_t,
+                                 message_container_t && message ) override
+    {
+        kept.push_back( std::move( message ) );
+    }
+};
+
+TEST( LogrOwnedMessage, DefaultIsStringView )  // NOLINT
+{
+    mock_logger_t logger( logr::log_message_level::trace );
+
+    InSequence seq;
+
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "abc" } ) );
+    EXPECT_CALL( logger, log_message_info( _, std::string_view{ "def" } ) );
+    EXPECT_CALL( logger, log_message_warn( std::string_view{ "42" } ) );
+
+    logger.info( [] { return std::string{ "abc" }; } );
+    logger.info( LOGR_SRC_LOCATION, [] { return std::string{ "def" }; } );
+    logger.warn( []( auto out ) { format_to( out, "{}", 42 ); } );
+}
+
+TEST( LogrOwnedMessage, HeapBufferIsTakenOver )  // NOLINT
+{
+    keeping_logger_t logger;
+
+    const std::string long_text( 1000, 'x' );
+    const void * data = nullptr;
+
+    logger.info( [ & ]( auto out ) {
+        format_to( out, "{}", long_text );
+        data = out.buf().data();
+    } );
+
+    ASSERT_EQ( logger.kept.size(), 1 );
+    ASSERT_EQ( logger.kept[ 0 ].make_view(), long_text );
+    ASSERT_EQ( logger.kept[ 0 ].make_view().data(), data );
+}
+
+TEST( LogrOwnedMessage, ShortTextIsStringView )  // NOLINT
+{
+    keeping_logger_t logger;
+
+    // Nothing to take over: inline buffer and a short string.
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "42" } ) );
+    EXPECT_CALL( logger, log_message_info( _, std::string_view{ "abc" } ) );
+
+    logger.info( []( auto out ) { format_to( out, "{}", 42 ); } );
+    logger.info( LOGR_SRC_LOCATION, [] { return std::string{ "abc" }; } );
+
+    ASSERT_TRUE( logger.kept.empty() );
+}
+
+TEST( LogrOwnedMessage, ReturnedStringIsMoved )  // NOLINT
+{
+    keeping_logger_t logger;
+
+    const std::string long_text( 1000, 'y' );
+    const void * data = nullptr;
+
+    logger.info( LOGR_SRC_LOCATION, [ & ] {
+        std::string res = long_text;
+        data            = res.data();
+        return res;
+    } );
+
+    ASSERT_EQ( logger.kept.size(), 1 );
+    ASSERT_TRUE( logger.kept[ 0 ].holds_string() );
+    ASSERT_EQ( logger.kept[ 0 ].make_view(), long_text );
+    ASSERT_EQ( logger.kept[ 0 ].make_view().data(), data );
+
+    // Writing to the buffer resets the string.
+    logger.kept[ 0 ].msg_buffer().push_back( 'z' );
+    ASSERT_FALSE( logger.kept[ 0 ].holds_string() );
+    ASSERT_EQ( logger.kept[ 0 ].make_view(), "z" );
+}
+
+TEST( LogrOwnedMessage, StringIsInPlaceOfBuffer )  // NOLINT
+{
+    using container_t = logr::details::basic_small_message_container_t< 1024 >;
+
+    static_assert( sizeof( container_t )
+                   < sizeof( container_t::message_buffer_t )
+                         + sizeof( container_t::string_t ) );
+
+    container_t container{ container_t::string_t( 100, 'x' ) };
+    ASSERT_TRUE( container.holds_string() );
+    ASSERT_EQ( container.str(), std::string( 100, 'x' ) );
+
+    container.msg_buffer().push_back( 'y' );
+    ASSERT_FALSE( container.holds_string() );
+    ASSERT_EQ( container.make_view(), "y" );
+}
+
+TEST( LogrOwnedMessage, AsyncLogger )  // NOLINT
+{
+    logr::async_logger_t< mock_logger_t > logger{ logr::log_message_level::trace,
+                                                  16,
+                                                  logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    const std::string long_text( 1000, 'z' );
+    {
+        InSequence seq;
+
+        EXPECT_CALL( backend, log_message_info( std::string_view{ long_text } ) );
+        EXPECT_CALL( backend, log_message_info( _, std::string_view{ "short" } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ long_text } ) );
+        EXPECT_CALL( backend, log_message_info( std::string_view{ "text" } ) );
+        EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+    }
+
+    logger.info( [ & ]( auto out ) { format_to( out, "{}", long_text ); } );
+    logger.info( LOGR_SRC_LOCATION, [] { return std::string{ "short" }; } );
+    logger.info( [ & ] { return long_text; } );
+    logger.info( "text" );
+    logger.flush();
+}
+
+} /* anonymous namespace */
@@ -0,0 +1,169 @@
+// Check per call site rate limiting of messages.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include <logr/logr.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using namespace std::chrono_literals;
+
+TEST( LogrRateLimit, TokenBucket )  // NOLINT
+{
+    logr::rate_limit_t limit;
+    const auto t0 = std::chrono::steady_clock::time_point{ 1h };
+
+    // 10 messages per second with a burst of 3.
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t0 ) );
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t0 ) );
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t0 ) );
+    EXPECT_FALSE( limit.try_acquire( 10.0, 3, t0 ) );
+    EXPECT_FALSE( limit.try_acquire( 10.0, 3, t0 + 99ms ) );
+    EXPECT_EQ( limit.take_suppressed(), 2 );
+    EXPECT_EQ( limit.take_suppressed(), 0 );
+
+    // A token per 100ms.
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t0 + 100ms ) );
+    EXPECT_FALSE( limit.try_acquire( 10.0, 3, t0 + 150ms ) );
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t0 + 200ms ) );
+
+    // Bucket is refilled up to burst.
+    const auto t1 = t0 + 10s;
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t1 ) );
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t1 ) );
+    EXPECT_TRUE( limit.try_acquire( 10.0, 3, t1 ) );
+    EXPECT_FALSE( limit.try_acquire( 10.0, 3, t1 ) );
+
+    // Zero rate passes only a burst.
+    logr::rate_limit_t zero_limit;
+    EXPECT_TRUE( zero_limit.try_acquire( 0.0, 1, t0 ) );
+    EXPECT_FALSE( zero_limit.try_acquire( 0.0, 1, t0 + 1000h ) );
+}
+
+TEST( LogrRateLimit, ExtremeRates )  // NOLINT
+{
+    const auto t0 = std::chrono::steady_clock::time_point{ 1h };
+
+    // Zero rate passes only a burst.
+    for( double rate : { 0.0, -1.0, 1e-12, 1e-300 } )
+    {
+        for( std::size_t burst : { 2, 3, 1000 } )
+        {
+            logr::rate_limit_t limit;
+            for( std::size_t i = 0; i < burst; ++i )
+            {
+                ASSERT_TRUE( limit.try_acquire( rate, burst, t0 ) )
+                    << rate << " " << burst << " " << i;
+            }
+            EXPECT_FALSE( limit.try_acquire( rate, burst, t0 ) );
+            EXPECT_FALSE( limit.try_acquire( rate, burst, t0 + 1000h ) );
+            EXPECT_EQ( limit.take_suppressed(), 2 );
+        }
+    }
+
+    // Huge burst with a normal rate.
+    logr::rate_limit_t limit;
+    const auto huge_burst = std::numeric_limits< std::size_t >::max();
+    for( int i = 0; i < 1000; ++i )
+    {
+        ASSERT_TRUE( limit.try_acquire( 10.0, huge_burst, t0 ) );
+    }
+
+    // Huge rate passes everything.
+    logr::rate_limit_t fast_limit;
+    for( int i = 0; i < 1000; ++i )
+    {
+        ASSERT_TRUE( fast_limit.try_acquire( 1e300, 1, t0 ) );
+    }
+}
+
+TEST( LogrRateLimit, SuppressedMessages )  // NOLINT
+{
+    logr_test::logger_mock_t<> logger( logr::log_message_level::info );
+
+    // Disabled level is not counted as suppressed.
+    EXPECT_CALL( logger, log_message_debug( _, An< std::string_view >() ) )
+        .Times( 0 );
+
+    InSequence seq;
+    EXPECT_CALL( logger,
+                 log_message_warn( _, std::string_view{ "storm 0" } ) );
+    EXPECT_CALL( logger,
+                 log_message_warn( _, std::string_view{ "storm 1" } ) );
+    EXPECT_CALL( logger,
+                 log_message_warn(
+                     _,
+                     std::string_view{ "storm 100 [suppressed 98 similar]" } ) );
+
+    int builder_calls{ 0 };
+    auto & site = LOGR_CALL_SITE;
+    const auto log_storm = [ & ]( int i ) {
+        logger.warn_limited( site, 5.0, 2, [ & ]( auto & out ) {
+            ++builder_calls;
+            format_to( out, "storm {}", i );
+        } );
+    };
+
+    for( int i = 0; i < 100; ++i )
+    {
+        log_storm( i );
+        logger.debug_limited( site, 5.0, 2, "test [raw message]" );
+    }
+    EXPECT_EQ( builder_calls, 2 );
+
+    std::this_thread::sleep_for( 250ms );
+    log_storm( 100 );
+    EXPECT_EQ( builder_calls, 3 );
+}
+
+TEST( LogrRateLimit, MessageKinds )  // NOLINT
+{
+    logr_test::logger_mock_t<> logger( logr::log_message_level::info );
+
+    InSequence seq;
+    EXPECT_CALL( logger,
+                 log_message_error( _, std::string_view{ "raw message" } ) );
+    EXPECT_CALL(
+        logger,
+        log_message_error(
+            _, std::string_view{ "raw message [suppressed 1 similar]" } ) );
+    EXPECT_CALL( logger,
+                 log_message_info( _, std::string_view{ "cb message" } ) );
+    EXPECT_CALL(
+        logger,
+        log_message_info(
+            _, std::string_view{ "cb message [suppressed 1 similar]" } ) );
+
+    for( int i = 0; i < 2; ++i )
+    {
+        auto & site = LOGR_CALL_SITE;
+        for( int j = 0; j < 2; ++j )
+        {
+            logger.error_limited( site, 1000.0, 1, "raw message" );
+        }
+        std::this_thread::sleep_for( 10ms );
+    }
+
+    for( int i = 0; i < 2; ++i )
+    {
+        auto & site = LOGR_CALL_SITE;
+        for( int j = 0; j < 2; ++j )
+        {
+            logger.info_limited(
+                site, 1000.0, 1, [] { return std::string{ "cb message" }; } );
+        }
+        std::this_thread::sleep_for( 10ms );
+    }
+}
+
+}  // anonymous namespace
@@ -0,0 +1,212 @@
+// Check rotating file logger rotates files and keeps all lines.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <logr/rotating_file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+using rotating_file_logger_t = logr::rotating_file_logger_t<>;
+
+std::string temp_file( const char * name )
+{
+    return ::testing::TempDir() + name;
+}
+
+void remove_files( const std::string & path, int max_files )
+{
+    std::remove( path.c_str() );
+    for( int i = 1; i <= max_files; ++i )
+    {
+        std::remove( ( path + "." + std::to_string( i ) ).c_str() );
+    }
+}
+
+bool file_exists( const std::string & path )
+{
+    return std::ifstream{ path }.good();
+}
+
+std::string read_file( const std::string & path )
+{
+    std::ifstream in{ path, std::ios::binary };
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+std::string lines( int first, int last )
+{
+    std::string res;
+    for( int i = first; i < last; ++i )
+    {
+        res += "INFO : msg " + std::to_string( 10 + i ) + "\n";
+    }
+    return res;
+}
+
+TEST( LogrRotatingFileBackend, RotateBySize )  // NOLINT
+{
+    const auto path = temp_file( "logr_rotating_size.log" );
+    remove_files( path, 3 );
+    {
+        // Lines are 14 bytes: 8 lines make a file over 100 bytes.
+        rotating_file_logger_t logger{
+            path, logr::log_message_level::info, 100, 2
+        };
+
+        for( int i = 0; i < 20; ++i )
+        {
+            logger.info(
+                [ & ]( auto out ) { format_to( out, "msg {}", 10 + i ); } );
+            logger.flush();
+        }
+
+        EXPECT_EQ( read_file( path + ".2" ), lines( 0, 8 ) );
+        EXPECT_EQ( read_file( path + ".1" ), lines( 8, 16 ) );
+        EXPECT_EQ( read_file( path ), lines( 16, 20 ) );
+
+        for( int i = 20; i < 28; ++i )
+        {
+            logger.info(
+                [ & ]( auto out ) { format_to( out, "msg {}", 10 + i ); } );
+            logger.flush();
+        }
+
+        // The oldest file is dropped.
+        EXPECT_EQ( read_file( path + ".2" ), lines( 8, 16 ) );
+        EXPECT_EQ( read_file( path + ".1" ), lines( 16, 24 ) );
+        EXPECT_EQ( read_file( path ), lines( 24, 28 ) );
+        EXPECT_FALSE( file_exists( path + ".3" ) );
+    }
+
+    // The next file prepared ahead is removed.
+    EXPECT_FALSE( file_exists( path + ".next" ) );
+    {
+        // A full file is rotated right away.
+        rotating_file_logger_t logger{
+            path, logr::log_message_level::info, 50, 2
+        };
+        logger.flush();
+        logger.info( "msg 38" );
+    }
+    EXPECT_EQ( read_file( path + ".1" ), lines( 24, 28 ) );
+    EXPECT_EQ( read_file( path ), lines( 28, 29 ) );
+
+    remove_files( path, 3 );
+}
+
+TEST( LogrRotatingFileBackend, RotateByAge )  // NOLINT
+{
+    const auto path = temp_file( "logr_rotating_age.log" );
+    remove_files( path, 2 );
+
+    std::vector< std::string > retired;
+    {
+        rotating_file_logger_t logger{ path,
+                                       logr::log_message_level::info,
+                                       rotating_file_logger_t::default_max_size,
+                                       2,
+                                       std::chrono::milliseconds{ 20 },
+                                       [ & ]( const std::string & p ) {
+                                           retired.push_back( read_file( p ) );
+                                       } };
+
+        logger.info( "msg 10" );
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 200 } );
+        logger.flush();
+
+        EXPECT_EQ( read_file( path + ".1" ), lines( 0, 1 ) );
+        EXPECT_EQ( read_file( path ), "" );
+
+        // Empty file is not rotated.
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+        logger.flush();
+        EXPECT_FALSE( file_exists( path + ".2" ) );
+    }
+
+    ASSERT_EQ( retired.size(), 1 );
+    EXPECT_EQ( retired[ 0 ], lines( 0, 1 ) );
+
+    remove_files( path, 2 );
+}
+
+TEST( LogrRotatingFileBackend, ConcurrentWriters )  // NOLINT
+{
+    const auto path = temp_file( "logr_rotating_concurrent.log" );
+
+    constexpr int threads_count  = 4;
+    constexpr int messages_count = 5000;
+    constexpr int max_files      = 1000;
+    remove_files( path, max_files );
+    {
+        rotating_file_logger_t logger{
+            path, logr::log_message_level::info, 4096, max_files
+        };
+
+        std::vector< std::thread > threads;
+        for( int t = 0; t < threads_count; ++t )
+        {
+            threads.emplace_back( [ &, t ] {
+                for( int i = 0; i < messages_count; ++i )
+                {
+                    logger.info( [ & ]( auto out ) {
+                        format_to( out, "thread {} msg {}", t, i );
+                    } );
+                }
+            } );
+        }
+
+        for( auto & t : threads )
+        {
+            t.join();
+        }
+    }
+
+    // Read files from the oldest one.
+    int files_count = 0;
+    while( file_exists( path + "." + std::to_string( files_count + 1 ) ) )
+    {
+        ++files_count;
+    }
+    ASSERT_LT( files_count, max_files );
+    EXPECT_GT( files_count, 0 );
+
+    std::vector< int > next( threads_count, 0 );
+    for( int n = files_count; n >= 0; --n )
+    {
+        const auto file = 0 == n ? path : path + "." + std::to_string( n );
+        std::ifstream in{ file };
+        std::string line;
+        while( std::getline( in, line ) )
+        {
+            int t = -1;
+            int i = -1;
+            ASSERT_EQ(
+                std::sscanf( line.c_str(), "INFO : thread %d msg %d", &t, &i ),
+                2 )
+                << line;
+            ASSERT_TRUE( 0 <= t && t < threads_count ) << line;
+            // Messages of a thread keep their order.
+            ASSERT_EQ( i, next[ t ] ) << line;
+            ++next[ t ];
+        }
+    }
+
+    for( int t = 0; t < threads_count; ++t )
+    {
+        EXPECT_EQ( next[ t ], messages_count );
+    }
+    remove_files( path, max_files );
+}
+
+}  // anonymous namespace
@@ -0,0 +1,276 @@
+// Check sharded file logger writes a file per thread
+// and files are merged into a single timeline.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <logr/sharded_file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+using sharded_file_logger_t = logr::sharded_file_logger_t<>;
+
+std::string merge( const std::vector< std::string > & texts )
+{
+    std::vector< std::istringstream > streams;
+    streams.reserve( texts.size() );
+    std::vector< std::istream * > inputs;
+    for( const auto & t : texts )
+    {
+        streams.emplace_back( t );
+        inputs.push_back( &streams.back() );
+    }
+
+    std::ostringstream out;
+    logr::sharded_file::merge( inputs, out );
+    return out.str();
+}
+
+TEST( LogrShardedFileBackend, ParseRecordKey )  // NOLINT
+{
+    std::uint64_t ts  = 0;
+    std::uint64_t seq = 0;
+    EXPECT_TRUE(
+        logr::sharded_file::parse_record_key( "123 4 INFO : msg", ts, seq ) );
+    EXPECT_EQ( ts, 123 );
+    EXPECT_EQ( seq, 4 );
+
+    EXPECT_FALSE( logr::sharded_file::parse_record_key( "123 4", ts, seq ) );
+    EXPECT_FALSE( logr::sharded_file::parse_record_key( "123 x y", ts, seq ) );
+    EXPECT_FALSE( logr::sharded_file::parse_record_key( " 1 2 msg", ts, seq ) );
+    EXPECT_FALSE( logr::sharded_file::parse_record_key( "", ts, seq ) );
+}
+
+TEST( LogrShardedFileBackend, MergeOrdersByTimestamp )  // NOLINT
+{
+    const auto merged = merge( {
+        "# logr shard pid=1 tid=1\n"
+        "10 0 INFO : a1\n"
+        "30 1 INFO : a2\n"
+        "line 2 of a2\n"
+        "50 2 INFO : a3\n",
+        "# logr shard pid=1 tid=2\n"
+        "20 0 INFO : b1\n"
+        "30 1 INFO : b2\n",
+        "",
+        // Torn head.
+        "continuation\n"
+        "5 7 INFO : c1\n",
+    } );
+
+    EXPECT_EQ( merged,
+               "5 7 INFO : c1\n"
+               "10 0 INFO : a1\n"
+               "20 0 INFO : b1\n"
+               "30 1 INFO : a2\n"
+               "line 2 of a2\n"
+               "30 1 INFO : b2\n"
+               "50 2 INFO : a3\n" );
+}
+
+TEST( LogrShardedFileBackend, FilePerThread )  // NOLINT
+{
+    const auto prefix = ::testing::TempDir() + "logr_sharded";
+
+    constexpr int threads_count  = 4;
+    constexpr int messages_count = 5000;
+
+    std::vector< std::string > paths;
+    {
+        // Small buffers to have many writes.
+        sharded_file_logger_t logger{
+            prefix, logr::log_message_level::info, 1024
+        };
+
+        std::vector< std::thread > threads;
+        for( int t = 0; t < threads_count; ++t )
+        {
+            threads.emplace_back( [ &, t ] {
+                for( int i = 0; i < messages_count; ++i )
+                {
+                    logger.info( [ & ]( auto out ) {
+                        format_to( out, "thread {} msg {}", t, i );
+                    } );
+                }
+            } );
+        }
+
+        for( auto & t : threads )
+        {
+            t.join();
+        }
+        logger.flush();
+
+        // Files of finished threads are closed, but are still listed.
+        logger.info( "last" );
+        paths = logger.shard_paths();
+    }
+    ASSERT_EQ( paths.size(), threads_count + 1 );
+
+    std::vector< std::unique_ptr< std::ifstream > > files;
+    std::vector< std::istream * > inputs;
+    for( const auto & p : paths )
+    {
+        files.push_back( std::make_unique< std::ifstream >( p ) );
+        ASSERT_TRUE( *files.back() ) << p;
+        inputs.push_back( files.back().get() );
+    }
+
+    std::ostringstream out;
+    logr::sharded_file::merge( inputs, out );
+
+    std::istringstream merged{ out.str() };
+    std::vector< int > next( threads_count, 0 );
+    std::uint64_t prev_ts = 0;
+    std::string line;
+    std::string last_line;
+    while( std::getline( merged, line ) )
+    {
+        std::uint64_t ts  = 0;
+        std::uint64_t seq = 0;
+        ASSERT_TRUE( logr::sharded_file::parse_record_key( line, ts, seq ) )
+            << line;
+        ASSERT_LE( prev_ts, ts );
+        prev_ts   = ts;
+        last_line = line;
+
+        int t = -1;
+        int i = -1;
+        if( 2
+            == std::sscanf( line.c_str(),
+                            "%*u %*u INFO : thread %d msg %d",
+                            &t,
+                            &i ) )
+        {
+            ASSERT_TRUE( 0 <= t && t < threads_count ) << line;
+            // Messages of a thread keep their order.
+            ASSERT_EQ( i, next[ t ] ) << line;
+            ASSERT_EQ( seq, static_cast< std::uint64_t >( i ) ) << line;
+            ++next[ t ];
+        }
+    }
+
+    for( int t = 0; t < threads_count; ++t )
+    {
+        EXPECT_EQ( next[ t ], messages_count );
+    }
+    EXPECT_NE( last_line.find( " 0 INFO : last" ), std::string::npos );
+
+    for( const auto & p : paths )
+    {
+        std::remove( p.c_str() );
+    }
+}
+
+TEST( LogrShardedFileBackend, ShardsDoNotShareFiles )  // NOLINT
+{
+    const auto prefix = ::testing::TempDir() + "logr_sharded_reuse";
+
+    // Same process and thread.
+    std::vector< std::string > paths;
+    for( int i = 0; i < 2; ++i )
+    {
+        sharded_file_logger_t logger{ prefix, logr::log_message_level::info };
+        logger.info( [ & ]( auto out ) { format_to( out, "logger {}", i ); } );
+        logger.flush();
+        paths.push_back( logger.shard_paths().at( 0 ) );
+    }
+    ASSERT_NE( paths[ 0 ], paths[ 1 ] );
+
+    for( int i = 0; i < 2; ++i )
+    {
+        std::ifstream in{ paths[ i ] };
+        std::ostringstream s;
+        s << in.rdbuf();
+        const auto data = s.str();
+        EXPECT_NE( data.find( "logger " + std::to_string( i ) ),
+                   std::string::npos );
+        EXPECT_EQ( data.find( "logger " + std::to_string( 1 - i ) ),
+                   std::string::npos );
+        std::remove( paths[ i ].c_str() );
+    }
+}
+
+std::size_t count( const std::string & text, const std::string & what )
+{
+    std::size_t n = 0;
+    for( auto pos = text.find( what ); std::string::npos != pos;
+         pos      = text.find( what, pos + 1 ) )
+    {
+        ++n;
+    }
+    return n;
+}
+
+TEST( LogrShardedFileBackend, ChildDoesNotShareFiles )  // NOLINT
+{
+    const auto prefix = ::testing::TempDir() + "logr_sharded_fork";
+
+    sharded_file_logger_t logger{ prefix, logr::log_message_level::info };
+    // Buffered at fork().
+    logger.info( "parent line" );
+
+    int fds[ 2 ];
+    ASSERT_EQ( ::pipe( fds ), 0 );
+
+    const auto pid = ::fork();
+    ASSERT_NE( pid, -1 );
+    if( 0 == pid )
+    {
+        logger.info( "child line" );
+        logger.flush();
+        const auto paths = logger.shard_paths();
+        const auto path  = 1 == paths.size() ? paths[ 0 ] : std::string{};
+        const auto rc    = ::write( fds[ 1 ], path.data(), path.size() );
+        ::_exit( rc == static_cast< ssize_t >( path.size() ) ? 0 : 1 );
+    }
+
+    ::close( fds[ 1 ] );
+    std::string child_path;
+    char buf[ 256 ];
+    for( ssize_t n; 0 < ( n = ::read( fds[ 0 ], buf, sizeof( buf ) ) ); )
+    {
+        child_path.append( buf, static_cast< std::size_t >( n ) );
+    }
+    ::close( fds[ 0 ] );
+
+    int status = 0;
+    ASSERT_EQ( ::waitpid( pid, &status, 0 ), pid );
+    ASSERT_TRUE( WIFEXITED( status ) );
+    ASSERT_EQ( WEXITSTATUS( status ), 0 );
+
+    logger.flush();
+    const auto paths = logger.shard_paths();
+    ASSERT_EQ( paths.size(), 1 );
+    ASSERT_FALSE( child_path.empty() );
+    ASSERT_NE( paths[ 0 ], child_path );
+
+    for( const auto & [ path, mine, other ] :
+         { std::tuple{ paths[ 0 ], "parent line", "child line" },
+           std::tuple{ child_path, "child line", "parent line" } } )
+    {
+        std::ifstream in{ path };
+        std::ostringstream s;
+        s << in.rdbuf();
+        const auto data = s.str();
+        EXPECT_EQ( count( data, "# logr shard" ), 1 ) << data;
+        EXPECT_EQ( count( data, mine ), 1 ) << data;
+        EXPECT_EQ( count( data, other ), 0 ) << data;
+        EXPECT_NE( data.find( " 0 INFO : " ), std::string::npos ) << data;
+        std::remove( path.c_str() );
+    }
+}
+
+}  // anonymous namespace
@@ -0,0 +1,67 @@
+// Check that loggers with shared log level driver follow the same level.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <logr/logr.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using logr::log_message_level;
+
+logr::shared_log_level_t shared_level{ log_message_level::warn };
+
+using shared_traits_t = logr::basic_logger_traits_t<
+    1024,
+    char,
+    std::allocator< char >,
+    logr::shared_log_level_driver_t< shared_level > >;
+
+using shared_logger_mock_t = logr_test::basic_logger_mock_t< shared_traits_t >;
+
+TEST( LogrSharedLogLevel, CacheLineIsolated )  // NOLINT
+{
+    EXPECT_EQ( alignof( logr::shared_log_level_t ), 64 );
+    EXPECT_EQ( sizeof( logr::shared_log_level_t ), 64 );
+    EXPECT_EQ( reinterpret_cast< std::uintptr_t >( &shared_level ) % 64, 0 );
+}
+
+TEST( LogrSharedLogLevel, LoggersSwitchTogether )  // NOLINT
+{
+    // Level passed to constructor doesn't change the shared one.
+    shared_logger_mock_t logger_1{ log_message_level::trace };
+    shared_logger_mock_t logger_2{ log_message_level::critical };
+    EXPECT_EQ( logger_1.log_level(), log_message_level::warn );
+    EXPECT_EQ( logger_2.log_level(), log_message_level::warn );
+
+    EXPECT_CALL( logger_1, log_message_info( An< std::string_view >() ) )
+        .Times( 0 );
+    EXPECT_CALL( logger_2, log_message_info( An< std::string_view >() ) )
+        .Times( 0 );
+    logger_1.info( "test [raw message]" );
+    logger_2.info( "test [raw message]" );
+    Mock::VerifyAndClearExpectations( &logger_1 );
+    Mock::VerifyAndClearExpectations( &logger_2 );
+
+    shared_level.log_level( log_message_level::info );
+
+    EXPECT_CALL( logger_1, log_message_info( An< std::string_view >() ) );
+    EXPECT_CALL( logger_2, log_message_info( An< std::string_view >() ) );
+    logger_1.info( "test [raw message]" );
+    logger_2.info( "test [raw message]" );
+    Mock::VerifyAndClearExpectations( &logger_1 );
+    Mock::VerifyAndClearExpectations( &logger_2 );
+
+    // Setting level of a logger sets it for all.
+    logger_2.log_level( log_message_level::error );
+    EXPECT_EQ( shared_level.log_level(), log_message_level::error );
+    EXPECT_EQ( logger_1.log_level(), log_message_level::error );
+}
+
+}  // anonymous namespace
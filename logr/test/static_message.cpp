@@ -0,0 +1,167 @@
+// Check literals marked as static are passed to backend as static messages.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+#include <logr/async_backend.hpp>
+
+#include "logger_mock.hpp"
+
+namespace /* anonymous */
+{
+
+using namespace ::testing;  // NOLINT
+
+using namespace logr::literals;  // NOLINT
+
+using mock_logger_t = StrictMock< logr_test::logger_mock_t<> >;
+
+/**
+ * @brief A logger remembering static messages it receives.
+ */
+class static_logger_t : public logr_test::logger_mock_t<>
+{
+public:
+    using base_type_t = logr_test::logger_mock_t<>;
+
+    static_logger_t()
+        : base_type_t{ logr::log_message_level::trace }
+    {
+    }
+
+    std::vector< std::string_view > kept;
+
+private:
+    void log_static_message_info( static_message_t message ) override
+    {
+        kept.push_back( message.view() );
+    }
+
+    void log_static_message_error( logr::src_location_t,
+                                   static_message_t message ) override
+    {
+        kept.push_back( message.view() );
+    }
+};
+
+constexpr auto static_text = "static text"_static;
+
+TEST( LogrStaticMessage, MarkedLiteralIsPassedByPointer )  // NOLINT
+{
+    static_logger_t logger;
+
+    logger.info( "literal"_static );
+    logger.error( LOGR_SRC_LOCATION, static_text );
+
+    ASSERT_EQ( logger.kept.size(), 2 );
+    ASSERT_EQ( logger.kept[ 0 ], "literal" );
+    ASSERT_EQ( logger.kept[ 1 ], "static text" );
+    ASSERT_EQ( logger.kept[ 1 ].data(), static_text.data() );
+}
+
+TEST( LogrStaticMessage, OtherTextIsStringView )  // NOLINT
+{
+    static_logger_t logger;
+
+    char buf[ 16 ] = "mutable";
+    const char local[] = "local";
+    const std::string str{ "string" };
+    const char * ptr = "pointer";
+
+    InSequence seq;
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "literal" } ) );
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "mutable" } ) );
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "local" } ) );
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "string" } ) );
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "pointer" } ) );
+
+    logger.info( "literal" );
+    logger.info( buf );
+    logger.info( local );
+    logger.info( str );
+    logger.info( ptr );
+
+    ASSERT_TRUE( logger.kept.empty() );
+}
+
+TEST( LogrStaticMessage, ArrayTextEndsWithNull )  // NOLINT
+{
+    mock_logger_t logger( logr::log_message_level::trace );
+
+    EXPECT_CALL( logger, log_message_info( std::string_view{ "abc" } ) );
+    EXPECT_CALL( logger, log_message_warn( _, std::string_view{ "abc" } ) );
+
+    logger.info( "abc\0def" );
+    logger.warn( LOGR_SRC_LOCATION, "abc\0def" );
+}
+
+TEST( LogrStaticMessage, DefaultIsStringView )  // NOLINT
+{
+    mock_logger_t logger( logr::log_message_level::trace );
+
+    InSequence seq;
+
+    EXPECT_CALL( logger, log_message_trace( std::string_view{ "1" } ) );
+    EXPECT_CALL( logger, log_message_debug( _, std::string_view{ "2" } ) );
+    EXPECT_CALL( logger, log_message_critical( std::string_view{ "3" } ) );
+
+    logger.trace( "1"_static );
+    logger.debug( LOGR_SRC_LOCATION, "2"_static );
+    logger.critical( logr::no_src_location_t{}, "3"_static );
+}
+
+TEST( LogrStaticMessage, Literals )  // NOLINT
+{
+    constexpr auto msg  = "abc"_static;
+    constexpr auto wmsg = L"abcd"_static;
+
+    static_assert( msg.size() == 3 );
+    static_assert( wmsg.size() == 4 );
+    ASSERT_EQ( msg.view(), "abc" );
+    ASSERT_EQ( wmsg.view(), L"abcd" );
+}
+
+TEST( LogrStaticMessage, AsyncLoggerKeepsPointer )  // NOLINT
+{
+    logr::async_logger_t< mock_logger_t > logger{ logr::log_message_level::trace,
+                                                  16,
+                                                  logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    const char * received = nullptr;
+    EXPECT_CALL( backend, log_message_info( _, static_text.view() ) )
+        .WillOnce(
+            [ & ]( auto, std::string_view msg ) { received = msg.data(); } );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    logger.info( LOGR_SRC_LOCATION, static_text );
+    logger.flush();
+
+    ASSERT_EQ( received, static_text.data() );
+}
+
+TEST( LogrStaticMessage, AsyncLoggerCopiesArrays )  // NOLINT
+{
+    logr::async_logger_t< mock_logger_t > logger{ logr::log_message_level::trace,
+                                                  16,
+                                                  logr::log_message_level::trace };
+
+    auto & backend = logger.backend();
+
+    EXPECT_CALL( backend, log_message_info( std::string_view{ "from stack" } ) );
+    EXPECT_CALL( backend, log_flush() ).Times( AtLeast( 1 ) );
+
+    {
+        char msg[] = "from stack";
+        const char( &const_msg )[ sizeof( msg ) ] = msg;
+        logger.info( const_msg );
+        std::fill( std::begin( msg ), std::end( msg ), 'X' );
+    }
+    logger.flush();
+}
+
+} /* anonymous namespace */
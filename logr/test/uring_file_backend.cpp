@@ -0,0 +1,153 @@
+// Check io_uring file logger writes all lines in order.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <logr/uring_file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+using uring_file_logger_t = logr::uring_file_logger_t<>;
+
+std::string temp_file( const char * name )
+{
+    auto path = ::testing::TempDir() + name;
+    std::remove( path.c_str() );
+    return path;
+}
+
+std::string read_file( const std::string & path )
+{
+    std::ifstream in{ path, std::ios::binary };
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+TEST( LogrUringFileBackend, LinesAreWritten )  // NOLINT
+{
+    const auto path = temp_file( "logr_uring_lines.log" );
+    {
+        uring_file_logger_t logger{ path, logr::log_message_level::trace, true };
+
+        logger.info( "msg 1" );
+        logger.debug( logr::src_location_t{ "file.cpp", 7 },
+                      []( auto out ) { format_to( out, "msg {}", 2 ); } );
+
+        // Not written yet.
+        EXPECT_EQ( read_file( path ), "" );
+
+        logger.flush();
+        EXPECT_EQ( read_file( path ),
+                   "INFO : msg 1\nDEBUG: msg 2 @ file.cpp(7)\n" );
+
+        logger.critical( "msg 3" );
+    }
+    {
+        // Reopened file is appended.
+        uring_file_logger_t logger{ path };
+        logger.warn( "msg 4" );
+    }
+
+    EXPECT_EQ( read_file( path ),
+               "INFO : msg 1\nDEBUG: msg 2 @ file.cpp(7)\nCRIT : msg 3\n"
+               "WARN : msg 4\n" );
+    std::remove( path.c_str() );
+}
+
+TEST( LogrUringFileBackend, DurableMessages )  // NOLINT
+{
+    const auto path = temp_file( "logr_uring_durable.log" );
+    {
+        uring_file_logger_t logger{ path,
+                                    logr::log_message_level::info,
+                                    false,
+                                    uring_file_logger_t::default_buffer_size,
+                                    uring_file_logger_t::default_buffers_count,
+                                    logr::log_message_level::error };
+
+        logger.info( "msg 1" );
+        EXPECT_EQ( read_file( path ), "" );
+
+        // Written with the buffered line.
+        logger.error( "msg 2" );
+        EXPECT_EQ( read_file( path ), "INFO : msg 1\nERR  : msg 2\n" );
+    }
+    std::remove( path.c_str() );
+}
+
+TEST( LogrUringFileBackend, ManyWritesInFlight )  // NOLINT
+{
+    const auto path = temp_file( "logr_uring_concurrent.log" );
+
+    constexpr int threads_count  = 4;
+    constexpr int messages_count = 5000;
+
+    // Small buffers to have many writes,
+    // and a message longer than a buffer.
+    const std::string long_message( 300, 'x' );
+    {
+        uring_file_logger_t logger{
+            path, logr::log_message_level::info, false, 256, 3
+        };
+
+        std::vector< std::thread > threads;
+        for( int t = 0; t < threads_count; ++t )
+        {
+            threads.emplace_back( [ &, t ] {
+                for( int i = 0; i < messages_count; ++i )
+                {
+                    logger.info( [ & ]( auto out ) {
+                        format_to( out, "thread {} msg {}", t, i );
+                    } );
+                }
+            } );
+        }
+        logger.warn( long_message );
+        logger.flush();
+
+        for( auto & t : threads )
+        {
+            t.join();
+        }
+    }
+
+    std::ifstream in{ path };
+    std::vector< int > next( threads_count, 0 );
+    int long_messages = 0;
+    std::string line;
+    while( std::getline( in, line ) )
+    {
+        if( line == "WARN : " + long_message )
+        {
+            ++long_messages;
+            continue;
+        }
+
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(
+            std::sscanf( line.c_str(), "INFO : thread %d msg %d", &t, &i ), 2 )
+            << line;
+        ASSERT_TRUE( 0 <= t && t < threads_count ) << line;
+        // Messages of a thread keep their order.
+        ASSERT_EQ( i, next[ t ] ) << line;
+        ++next[ t ];
+    }
+
+    EXPECT_EQ( long_messages, 1 );
+    for( int t = 0; t < threads_count; ++t )
+    {
+        EXPECT_EQ( next[ t ], messages_count );
+    }
+    std::remove( path.c_str() );
+}
+
+}  // anonymous namespace
@@ -0,0 +1,113 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+// Render a binary log written by logr::binary_logger_t as text.
+//
+// Usage: logr_binlog_decode [FILE]
+// Reads stdin if FILE is not given.
+
+#include <fstream>
+#include <iostream>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <logr/binary_backend.hpp>
+
+namespace /* anonymous */
+{
+
+std::string_view level_name( logr::log_message_level level )
+{
+    switch( level )
+    {
+        case logr::log_message_level::trace:
+            return "trace";
+        case logr::log_message_level::debug:
+            return "debug";
+        case logr::log_message_level::info:
+            return "info";
+        case logr::log_message_level::warn:
+            return "warn";
+        case logr::log_message_level::error:
+            return "error";
+        case logr::log_message_level::critical:
+            return "critical";
+        case logr::log_message_level::nolog:
+            break;
+    }
+    return "";
+}
+
+void decode( std::istream & input )
+{
+    logr::binary_log::decoder_t decoder{ input };
+    logr::binary_log::decoded_message_t msg;
+
+    fmt::memory_buffer line;
+    while( decoder.next( msg ) )
+    {
+        line.clear();
+
+        const auto since_epoch = msg.timestamp.time_since_epoch();
+        const auto seconds =
+            std::chrono::duration_cast< std::chrono::seconds >( since_epoch );
+        const auto nanoseconds =
+            std::chrono::duration_cast< std::chrono::nanoseconds >( since_epoch
+                                                                    - seconds );
+
+        fmt::format_to( fmt::appender( line ),
+                        "{:%Y-%m-%d %H:%M:%S}.{:09} [{}] {}",
+                        fmt::gmtime( static_cast< std::time_t >( seconds.count() ) ),
+                        nanoseconds.count(),
+                        level_name( msg.level ),
+                        msg.text );
+
+        if( !msg.file.empty() )
+        {
+            fmt::format_to( fmt::appender( line ), " @ {}({})", msg.file, msg.line );
+        }
+        line.push_back( '\n' );
+
+        std::cout.write( line.data(), static_cast< std::streamsize >( line.size() ) );
+    }
+}
+
+}  // anonymous namespace
+
+int main( int argc, char ** argv )
+{
+    if( argc > 2 )
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " [FILE]\n";
+        return 2;
+    }
+
+    try
+    {
+        if( 2 == argc )
+        {
+            std::ifstream input{ argv[ 1 ], std::ios::binary };
+            if( !input )
+            {
+                std::cerr << "Cannot open " << argv[ 1 ] << '\n';
+                return 1;
+            }
+            decode( input );
+        }
+        else
+        {
+            decode( std::cin );
+        }
+    }
+    catch( const std::exception & ex )
+    {
+        std::cout.flush();
+        std::cerr << "Failed to decode: " << ex.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+// Print messages kept by logr::flight_recorder_logger_t in a ring file
+// (e.g. after the process has crashed).
+//
+// Usage: logr_dump [-n COUNT] FILE
+// Prints the latest COUNT messages (all by default), the oldest first.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <logr/flight_recorder.hpp>
+
+namespace /* anonymous */
+{
+
+std::string_view level_name( logr::log_message_level level )
+{
+    switch( level )
+    {
+        case logr::log_message_level::trace:
+            return "trace";
+        case logr::log_message_level::debug:
+            return "debug";
+        case logr::log_message_level::info:
+            return "info";
+        case logr::log_message_level::warn:
+            return "warn";
+        case logr::log_message_level::error:
+            return "error";
+        case logr::log_message_level::critical:
+            return "critical";
+        case logr::log_message_level::nolog:
+            break;
+    }
+    return "";
+}
+
+void dump( std::istream & input, std::size_t count )
+{
+    const auto records = logr::flight_recorder::read_records( input );
+    const auto first   = records.size() > count ? records.size() - count : 0;
+
+    fmt::memory_buffer line;
+    for( auto i = first; i < records.size(); ++i )
+    {
+        const auto & r = records[ i ];
+        line.clear();
+
+        const auto since_epoch = r.timestamp.time_since_epoch();
+        const auto seconds =
+            std::chrono::duration_cast< std::chrono::seconds >( since_epoch );
+        const auto nanoseconds =
+            std::chrono::duration_cast< std::chrono::nanoseconds >( since_epoch
+                                                                    - seconds );
+
+        const auto time = static_cast< std::time_t >( seconds.count() );
+        fmt::format_to( fmt::appender( line ),
+                        "{:%Y-%m-%d %H:%M:%S}.{:09} [{}] {}",
+                        fmt::gmtime( time ),
+                        nanoseconds.count(),
+                        level_name( r.level ),
+                        r.text );
+
+        if( !r.file.empty() )
+        {
+            fmt::format_to( fmt::appender( line ), " @ {}({})", r.file, r.line );
+        }
+        line.push_back( '\n' );
+
+        std::cout.write( line.data(),
+                         static_cast< std::streamsize >( line.size() ) );
+    }
+}
+
+}  // anonymous namespace
+
+int main( int argc, char ** argv )
+{
+    std::size_t count = static_cast< std::size_t >( -1 );
+    const char * path = nullptr;
+
+    if( 4 == argc && std::string_view{ argv[ 1 ] } == "-n" )
+    {
+        char * end = nullptr;
+        count      = std::strtoull( argv[ 2 ], &end, 10 );
+        if( *end != '\0' )
+        {
+            std::cerr << "Bad count: " << argv[ 2 ] << '\n';
+            return 2;
+        }
+        path = argv[ 3 ];
+    }
+    else if( 2 == argc )
+    {
+        path = argv[ 1 ];
+    }
+    else
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " [-n COUNT] FILE\n";
+        return 2;
+    }
+
+    std::ifstream input{ path, std::ios::binary };
+    if( !input )
+    {
+        std::cerr << "Cannot open " << path << '\n';
+        return 1;
+    }
+
+    try
+    {
+        dump( input, count );
+    }
+    catch( const std::exception & ex )
+    {
+        std::cout.flush();
+        std::cerr << "Failed to read: " << ex.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+// Merge files written by logr::sharded_file_logger_t (a file per thread)
+// into a single timeline ordered by timestamps.
+//
+// Usage: logr_merge FILE...
+// Prints merged records to the standard output.
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <logr/sharded_file_backend.hpp>
+
+int main( int argc, char ** argv )
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[ 0 ] << " FILE...\n";
+        return 2;
+    }
+
+    std::vector< std::unique_ptr< std::ifstream > > files;
+    std::vector< std::istream * > inputs;
+    for( int i = 1; i < argc; ++i )
+    {
+        files.push_back( std::make_unique< std::ifstream >( argv[ i ] ) );
+        if( !*files.back() )
+        {
+            std::cerr << "Cannot open " << argv[ i ] << '\n';
+            return 1;
+        }
+        inputs.push_back( files.back().get() );
+    }
+
+    std::ios::sync_with_stdio( false );
+    logr::sharded_file::merge( inputs, std::cout );
+    return 0;
+}
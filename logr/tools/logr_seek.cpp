@@ -0,0 +1,335 @@
+// Logger frontend library for C++.
+//
+// Copyright (c) 2020 - present,  Nicolai Grodzitski
+// See LICENSE file in the root of the project.
+
+// Print messages of a time range from a file written by
+// logr::file_logger_t with a sidecar index (FILE.idx),
+// jumping to the range instead of scanning the file.
+//
+// Usage: logr_seek [--from TIME] [--to TIME] [--level LEVEL] FILE
+// TIME is UTC: "YYYY-MM-DD HH:MM:SS", "YYYY-MM-DDTHH:MM:SS",
+// "HH:MM:SS" (the day of the first index entry) or "@SECONDS"
+// (since the epoch). LEVEL is the lowest level to print
+// (trace, debug, info, warn, error, critical).
+//
+// The range is as precise as the index is: a few lines around it
+// might be printed as well.
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <logr/file_backend.hpp>
+
+namespace /* anonymous */
+{
+
+constexpr std::int64_t ns_in_second   = 1000000000;
+constexpr std::int64_t seconds_in_day = 24 * 60 * 60;
+
+/**
+ * @brief Parse a time to nanoseconds since the epoch.
+ *
+ * @param day  Start of a day for a time without date
+ *             (seconds since the epoch).
+ */
+std::optional< std::int64_t > parse_time( const std::string & s,
+                                          std::int64_t day )
+{
+    char tail = 0;
+    if( !s.empty() && '@' == s[ 0 ] )
+    {
+        long long seconds = 0;
+        if( 1 != std::sscanf( s.c_str() + 1, "%lld%c", &seconds, &tail ) )
+        {
+            return std::nullopt;
+        }
+        return seconds * ns_in_second;
+    }
+
+    std::tm tm{};
+    if( 6
+        == std::sscanf( s.c_str(),
+                        "%d-%d-%d%*1[ T]%d:%d:%d%c",
+                        &tm.tm_year,
+                        &tm.tm_mon,
+                        &tm.tm_mday,
+                        &tm.tm_hour,
+                        &tm.tm_min,
+                        &tm.tm_sec,
+                        &tail ) )
+    {
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        return std::int64_t{ ::timegm( &tm ) } * ns_in_second;
+    }
+
+    int h   = 0;
+    int m   = 0;
+    int sec = 0;
+    if( 3 == std::sscanf( s.c_str(), "%d:%d:%d%c", &h, &m, &sec, &tail ) )
+    {
+        return ( day + h * 3600 + m * 60 + sec ) * ns_in_second;
+    }
+    return std::nullopt;
+}
+
+std::optional< logr::log_message_level > parse_level( std::string_view s )
+{
+    using logr::log_message_level;
+    for( auto level : { log_message_level::trace,
+                        log_message_level::debug,
+                        log_message_level::info,
+                        log_message_level::warn,
+                        log_message_level::error,
+                        log_message_level::critical } )
+    {
+        static constexpr std::string_view names[] = {
+            "trace", "debug", "info", "warn", "error", "critical"
+        };
+        if( names[ static_cast< int >( level ) ] == s )
+        {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Get a level of a line by its prefix.
+ *
+ * @return Negative value if the line has no level prefix
+ *         (a continuation of a multi-line message).
+ */
+int line_level( std::string_view line )
+{
+    static constexpr std::string_view prefixes[] = {
+        "TRACE: ", "DEBUG: ", "INFO : ", "WARN : ", "ERR  : ", "CRIT : "
+    };
+    for( int i = 0; i < 6; ++i )
+    {
+        if( 0 == line.compare( 0, prefixes[ i ].size(), prefixes[ i ] ) )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//! Offset after the end of a line containing a given position.
+std::uint64_t line_end( std::string_view data, std::uint64_t pos )
+{
+    if( 0 == pos || '\n' == data[ pos - 1 ] )
+    {
+        return pos;
+    }
+    const auto nl = data.find( '\n', pos );
+    return std::string_view::npos == nl ? data.size() : nl + 1;
+}
+
+/**
+ * @brief Print lines of a given level (and higher).
+ *
+ * @param keep  Whether the previous line was printed
+ *              (for continuation lines).
+ */
+void print_lines( std::string_view data, int min_level, bool & keep )
+{
+    while( !data.empty() )
+    {
+        const auto nl = data.find( '\n' );
+        const auto size = std::string_view::npos == nl ? data.size() : nl + 1;
+        const auto line = data.substr( 0, size );
+
+        const auto level = line_level( line );
+        if( level >= 0 )
+        {
+            keep = level >= min_level;
+        }
+        if( keep )
+        {
+            std::fwrite( line.data(), 1, line.size(), stdout );
+        }
+        data.remove_prefix( size );
+    }
+}
+
+}  // anonymous namespace
+
+int main( int argc, char ** argv )
+{
+    std::string from_arg;
+    std::string to_arg;
+    int min_level     = 0;
+    const char * path = nullptr;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string_view arg{ argv[ i ] };
+        if( i + 1 < argc && arg == "--from" )
+        {
+            from_arg = argv[ ++i ];
+        }
+        else if( i + 1 < argc && arg == "--to" )
+        {
+            to_arg = argv[ ++i ];
+        }
+        else if( i + 1 < argc && arg == "--level" )
+        {
+            const auto level = parse_level( argv[ ++i ] );
+            if( !level )
+            {
+                std::cerr << "Bad level: " << argv[ i ] << '\n';
+                return 2;
+            }
+            min_level = static_cast< int >( *level );
+        }
+        else if( nullptr == path && !arg.empty() && '-' != arg[ 0 ] )
+        {
+            path = argv[ i ];
+        }
+        else
+        {
+            path = nullptr;
+            break;
+        }
+    }
+
+    if( nullptr == path )
+    {
+        std::cerr << "Usage: " << argv[ 0 ]
+                  << " [--from TIME] [--to TIME] [--level LEVEL] FILE\n";
+        return 2;
+    }
+
+    logr::file_index::index_t index;
+    {
+        const auto index_path = std::string{ path } + ".idx";
+        std::ifstream input{ index_path, std::ios::binary };
+        if( !input )
+        {
+            std::cerr << "Cannot open " << index_path << '\n';
+            return 1;
+        }
+
+        try
+        {
+            index = logr::file_index::read_index( input );
+        }
+        catch( const std::exception & ex )
+        {
+            std::cerr << "Failed to read index: " << ex.what() << '\n';
+            return 1;
+        }
+    }
+
+    const std::int64_t day =
+        index.entries.empty()
+            ? 0
+            : index.entries.front().timestamp / ns_in_second / seconds_in_day
+                  * seconds_in_day;
+
+    auto from = std::numeric_limits< std::int64_t >::min();
+    auto to   = std::numeric_limits< std::int64_t >::max();
+    for( auto [ arg, value ] :
+         { std::pair{ &from_arg, &from }, std::pair{ &to_arg, &to } } )
+    {
+        if( arg->empty() )
+        {
+            continue;
+        }
+        const auto t = parse_time( *arg, day );
+        if( !t )
+        {
+            std::cerr << "Bad time: " << *arg << '\n';
+            return 2;
+        }
+        *value = *t;
+    }
+
+    const int fd = ::open( path, O_RDONLY | O_CLOEXEC );
+    struct stat st;
+    if( -1 == fd || -1 == ::fstat( fd, &st ) )
+    {
+        std::cerr << "Cannot open " << path << '\n';
+        return 1;
+    }
+
+    const auto size = static_cast< std::uint64_t >( st.st_size );
+    if( 0 == size )
+    {
+        return 0;
+    }
+
+    void * p = ::mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+    if( MAP_FAILED == p )
+    {
+        std::cerr << "Cannot map " << path << '\n';
+        return 1;
+    }
+    const std::string_view data{ static_cast< const char * >( p ), size };
+
+    const auto [ begin, end ] =
+        logr::file_index::find_range( index, from, to, size );
+
+    // Print chunks between index entries skipping those
+    // that have no messages of the level.
+    bool keep        = true;
+    auto chunk_begin = begin;
+    for( const auto & e : index.entries )
+    {
+        if( e.offset <= chunk_begin )
+        {
+            continue;
+        }
+
+        const auto chunk_end = std::min( e.offset, end );
+        if( e.level >= min_level )
+        {
+            const auto first = line_end( data, chunk_begin );
+            const auto last  = line_end( data, chunk_end );
+            if( first < last )
+            {
+                print_lines(
+                    data.substr( first, last - first ), min_level, keep );
+            }
+        }
+        else
+        {
+            keep = false;
+        }
+
+        chunk_begin = std::max( chunk_begin, line_end( data, chunk_end ) );
+        if( chunk_end == end )
+        {
+            break;
+        }
+    }
+
+    // The tail not covered by the index.
+    if( chunk_begin < end )
+    {
+        const auto first = line_end( data, chunk_begin );
+        const auto last  = line_end( data, end );
+        if( first < last )
+        {
+            print_lines(
+                data.substr( first, last - first ), min_level, keep );
+        }
+    }
+
+    std::fflush( stdout );
+    return 0;
+}